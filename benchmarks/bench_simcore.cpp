@@ -0,0 +1,347 @@
+#include <benchmark/benchmark.h>
+#include <simcore.hpp>
+
+/* Microbenchmarks of the simcore kernels that dominate a simulation step.
+   Every fixture builds its objects from the default parameters with a fixed
+   seed, so results can be compared across builds to track regressions. */
+
+class Tester {
+public:
+  static void SinglyKMC(Crosslink &xlink) { xlink.SinglyKMC(); }
+};
+
+/* Periodic box with the static object state pointing at it, for inserting
+   species members */
+class BenchSystem {
+public:
+  system_parameters params;
+  Space space;
+  BenchSystem(double system_radius = 20) {
+    RNG::SetSeed(4321);
+    params.n_dim = 3;
+    params.n_periodic = 3;
+    params.system_radius = system_radius;
+    params.cell_length = 5;
+    params.filament.length = 20;
+    params.filament.n_bonds = 10;
+    params.filament.persistence_length = 400;
+  }
+  /* Periodic in all n_dim dimensions */
+  void SetNDim(int n_dim) {
+    params.n_dim = n_dim;
+    params.n_periodic = n_dim;
+  }
+  /* Call after changing params */
+  void Init() {
+    space.Init(&params);
+    Object::SetParams(&params);
+    Object::SetNDim(params.n_dim);
+    Object::SetDelta(params.delta);
+    Object::SetSpace(space.GetStruct());
+  }
+  /* Insert n members of spec, whose parameters are sparams, and return its
+     interactors */
+  std::vector<Object *> Insert(SpeciesBase &spec, species_parameters &sparams,
+                               int n) {
+    sparams.num = n;
+    spec.Init(&params, space.GetStruct(), 0);
+    spec.Reserve();
+    for (int i = 0; i < n; ++i) {
+      spec.AddMember();
+    }
+    std::vector<Object *> ixors;
+    spec.GetInteractors(&ixors);
+    return ixors;
+  }
+};
+
+/* Spherocylinders are not interactors of their species, so pair them up
+   directly */
+template <typename T> std::vector<Object *> GetObjects(Species<T> &spec) {
+  std::vector<Object *> objs;
+  for (auto it = spec.GetMembers()->begin(); it != spec.GetMembers()->end();
+       ++it) {
+    objs.push_back(&(*it));
+  }
+  return objs;
+}
+
+/* Arguments (first, n_dim) for first in [lo, hi] and both dimensions, for
+   the kernels that are specialized on the dimension */
+static void DenseRangeNDim(benchmark::internal::Benchmark *b, int lo, int hi) {
+  for (int n_dim = 2; n_dim <= 3; ++n_dim) {
+    for (int i = lo; i <= hi; ++i) {
+      b->Args({i, n_dim});
+    }
+  }
+}
+
+/* The pair kernels as the simulation calls them, specialized on the
+   dimension */
+template <int N_DIM>
+static void ObjectObjects(MinimumDistance &mindist,
+                          std::vector<Interaction> &pairs) {
+  for (auto ix = pairs.begin(); ix != pairs.end(); ++ix) {
+    mindist.ObjectObject<N_DIM>(*ix);
+  }
+}
+
+template <int N_DIM>
+static void CalcPotentials(PotentialManager &potential,
+                           std::vector<Interaction> &pairs) {
+  for (auto ix = pairs.begin(); ix != pairs.end(); ++ix) {
+    potential.CalcPotential<N_DIM>(*ix);
+  }
+}
+
+/* MinimumDistance::ObjectObject for random pairs of objects of the given
+   types: 0 bead-bead, 1 bead-rod, 2 rod-rod, 3 filament bond-bond */
+static void BM_ObjectObject(benchmark::State &state) {
+  static const char *labels[] = {"bead-bead", "bead-rod", "rod-rod",
+                                 "bond-bond"};
+  BenchSystem sys;
+  sys.SetNDim(state.range(1));
+  sys.Init();
+  BrBeadSpecies beads;
+  SpherocylinderSpecies rods;
+  FilamentSpecies filaments;
+  std::vector<Object *> ixors1, ixors2;
+  switch (state.range(0)) {
+  case 0:
+    ixors1 = ixors2 = sys.Insert(beads, sys.params.br_bead, 256);
+    break;
+  case 1:
+    ixors1 = sys.Insert(beads, sys.params.br_bead, 256);
+    sys.Insert(rods, sys.params.spherocylinder, 256);
+    ixors2 = GetObjects(rods);
+    break;
+  case 2:
+    sys.Insert(rods, sys.params.spherocylinder, 256);
+    ixors1 = ixors2 = GetObjects(rods);
+    break;
+  default:
+    ixors1 = ixors2 = sys.Insert(filaments, sys.params.filament, 26);
+  }
+  MinimumDistance mindist;
+  mindist.Init(sys.space.GetStruct(), 0.5 * sys.params.cell_length);
+  RNG rng;
+  std::vector<Interaction> pairs;
+  for (int i = 0; i < 1024; ++i) {
+    Object *o1 = ixors1[gsl_rng_uniform_int(rng.r, ixors1.size())];
+    Object *o2 = ixors2[gsl_rng_uniform_int(rng.r, ixors2.size())];
+    pairs.push_back(Interaction(o1, o2));
+  }
+  for (auto _ : state) {
+    if (sys.params.n_dim == 2) {
+      ObjectObjects<2>(mindist, pairs);
+    } else {
+      ObjectObjects<3>(mindist, pairs);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+  state.SetLabel(labels[state.range(0)]);
+}
+BENCHMARK(BM_ObjectObject)
+    ->ArgNames({"pair_type", "n_dim"})
+    ->Apply([](benchmark::internal::Benchmark *b) { DenseRangeNDim(b, 0, 3); });
+
+/* CellList::RenewObjectsCells followed by MakePairs for beads in a periodic
+   box, for increasing numbers of beads */
+static void BM_CellListPairs(benchmark::State &state) {
+  BenchSystem sys;
+  sys.Init();
+  BrBeadSpecies beads;
+  std::vector<Object *> ixors =
+      sys.Insert(beads, sys.params.br_bead, state.range(0));
+  int n_cells_1d =
+      (int)floor(2 * sys.params.system_radius / sys.params.cell_length);
+  CellList clist;
+  clist.Init(n_cells_1d, 2 * sys.params.system_radius / n_cells_1d,
+             sys.params.n_dim, sys.params.n_periodic);
+  std::vector<Interaction> pairs;
+  for (auto _ : state) {
+    pairs.clear();
+    clist.RenewObjectsCells(ixors);
+    clist.MakePairs(pairs);
+    benchmark::DoNotOptimize(pairs.data());
+  }
+  state.counters["pairs"] = pairs.size();
+  state.counters["density"] = ixors.size() / sys.space.GetStruct()->volume;
+  state.SetItemsProcessed(state.iterations() * ixors.size());
+  clist.Clear();
+}
+BENCHMARK(BM_CellListPairs)
+    ->ArgName("n_beads")
+    ->RangeMultiplier(4)
+    ->Range(1 << 8, 1 << 12);
+
+/* Filament::UpdatePosition of a single filament with n_bonds bonds in
+   n_dim dimensions, alternating midsteps and full steps as in the
+   simulation */
+static void BM_FilamentUpdatePosition(benchmark::State &state) {
+  BenchSystem sys;
+  sys.SetNDim(state.range(1));
+  sys.params.filament.n_bonds = state.range(0);
+  sys.params.filament.length = 2 * state.range(0);
+  sys.params.filament.max_length = 4 * state.range(0);
+  sys.Init();
+  FilamentSpecies filaments;
+  sys.Insert(filaments, sys.params.filament, 1);
+  Filament &filament = filaments.GetMembers()->front();
+  bool midstep = true;
+  for (auto _ : state) {
+    filament.ZeroForce();
+    filament.UpdatePosition(midstep);
+    midstep = !midstep;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FilamentUpdatePosition)
+    ->ArgNames({"n_bonds", "n_dim"})
+    ->RangeMultiplier(4)
+    ->Ranges({{4, 256}, {2, 3}});
+
+/* UpdatePositions of a species of n free beads (species 0) or
+   spherocylinders (species 1) in a periodic box in n_dim dimensions */
+static void BM_SpeciesUpdatePositions(benchmark::State &state) {
+  BenchSystem sys(100);
+  sys.SetNDim(state.range(2));
+  sys.Init();
+  BrBeadSpecies beads;
+  SpherocylinderSpecies rods;
+  SpeciesBase *spec;
+  if (state.range(0) == 0) {
+    sys.Insert(beads, sys.params.br_bead, state.range(1));
+    spec = &beads;
+  } else {
+    sys.Insert(rods, sys.params.spherocylinder, state.range(1));
+    spec = &rods;
+  }
+  for (auto _ : state) {
+    spec->ZeroForces();
+    spec->UpdatePositions();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  state.SetLabel(state.range(0) == 0 ? "br_bead" : "spherocylinder");
+}
+BENCHMARK(BM_SpeciesUpdatePositions)
+    ->ArgNames({"species", "n", "n_dim"})
+    ->Ranges({{0, 1}, {1 << 10, 1 << 16}, {2, 3}});
+
+/* Crosslink::SinglyKMC for a singly bound crosslink with n neighboring
+   bonds. Rates are zero so that the crosslink stays singly bound, while the
+   binding probabilities to all neighbors are still calculated. */
+static void BM_CrosslinkSinglyKMC(benchmark::State &state) {
+  BenchSystem sys;
+  sys.params.crosslink.k_off = 0;
+  sys.params.crosslink.k_on_d = 0;
+  sys.params.crosslink.event_kinetics = 0;
+  sys.Init();
+  FilamentSpecies filaments;
+  int n_neighbors = state.range(0);
+  int n_filaments = (n_neighbors + sys.params.filament.n_bonds - 1) /
+                    sys.params.filament.n_bonds;
+  std::vector<Object *> bonds =
+      sys.Insert(filaments, sys.params.filament, n_filaments);
+  MinimumDistance mindist;
+  mindist.Init(sys.space.GetStruct(), 0.5 * sys.params.cell_length);
+  LookupTable lut;
+  lut.Init(sys.params.crosslink.k_spring / 2, sys.params.crosslink.rest_length,
+           sys.params.filament.diameter);
+  Crosslink xlink;
+  xlink.Init(&mindist, &lut);
+  xlink.AttachObjRandom(bonds[0]);
+  std::vector<Object *> anchors;
+  xlink.GetAnchors(anchors);
+  Anchor *anchor = dynamic_cast<Anchor *>(anchors[0]);
+  for (int i = 0; i < n_neighbors; ++i) {
+    anchor->AddNeighbor(bonds[i]);
+  }
+  for (auto _ : state) {
+    Tester::SinglyKMC(xlink);
+  }
+  state.SetItemsProcessed(state.iterations() * n_neighbors);
+}
+BENCHMARK(BM_CrosslinkSinglyKMC)
+    ->ArgName("n_neighbors")
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+
+/* PotentialManager::CalcPotential for pairs within the cutoff:
+   0 WCA, 1 soft */
+static void BM_Potential(benchmark::State &state) {
+  static const char *potentials[] = {"wca", "soft"};
+  BenchSystem sys;
+  sys.SetNDim(state.range(1));
+  sys.params.potential = potentials[state.range(0)];
+  sys.Init();
+  PotentialManager potential;
+  potential.InitPotentials(&sys.params);
+  double r_cut = sqrt(potential.GetRCut2());
+  RNG rng;
+  std::vector<Interaction> pairs(1024);
+  for (auto ix = pairs.begin(); ix != pairs.end(); ++ix) {
+    double r = (0.8 + 0.2 * gsl_rng_uniform_pos(rng.r)) * r_cut;
+    generate_random_unit_vector(sys.params.n_dim, ix->dr, rng.r);
+    for (int i = 0; i < sys.params.n_dim; ++i) {
+      ix->dr[i] *= r;
+    }
+    ix->dr_mag2 = r * r;
+    ix->buffer_mag = 1;
+    ix->buffer_mag2 = 1;
+  }
+  for (auto _ : state) {
+    if (sys.params.n_dim == 2) {
+      CalcPotentials<2>(potential, pairs);
+    } else {
+      CalcPotentials<3>(potential, pairs);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+  state.SetLabel(potentials[state.range(0)]);
+}
+BENCHMARK(BM_Potential)
+    ->ArgNames({"potential", "n_dim"})
+    ->Apply([](benchmark::internal::Benchmark *b) { DenseRangeNDim(b, 0, 1); });
+
+/* Spec frame of n filaments written to and read from memory, which is what
+   the simulation does before handing frames to the output writers */
+static void BM_SpecWrite(benchmark::State &state) {
+  BenchSystem sys;
+  sys.Init();
+  FilamentSpecies filaments;
+  sys.Insert(filaments, sys.params.filament, state.range(0));
+  CheckpointBuffer buffer;
+  std::fstream stream;
+  static_cast<std::ios &>(stream).rdbuf(&buffer);
+  for (auto _ : state) {
+    buffer.GetData().clear();
+    filaments.WriteSpecFrame(stream);
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.GetData().size());
+}
+BENCHMARK(BM_SpecWrite)->ArgName("n_filaments")->RangeMultiplier(4)->Range(
+    4, 1024);
+
+static void BM_SpecRead(benchmark::State &state) {
+  BenchSystem sys;
+  sys.Init();
+  FilamentSpecies filaments;
+  sys.Insert(filaments, sys.params.filament, state.range(0));
+  CheckpointBuffer buffer;
+  std::fstream stream;
+  static_cast<std::ios &>(stream).rdbuf(&buffer);
+  filaments.WriteSpecFrame(stream);
+  for (auto _ : state) {
+    buffer.Rewind();
+    stream.clear();
+    filaments.ReadSpecFrame(stream);
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.GetData().size());
+}
+BENCHMARK(BM_SpecRead)->ArgName("n_filaments")->RangeMultiplier(4)->Range(
+    4, 1024);
+
+BENCHMARK_MAIN();
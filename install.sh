@@ -16,6 +16,14 @@ do_omp_build() {
     cd ..
 }
 
+do_mpi_build() {
+    mkdir build
+    cd build || exit 1
+    cmake -DMPI=1 -DOMP=1 ..
+    make -j8
+    cd ..
+}
+
 do_graph_omp_build() {
     mkdir build
     cd build || exit 1
@@ -98,6 +106,7 @@ do_usage() {
     echo "  gbuild  - build simcore with graphics"
     echo "  omp     - build simcore with openmp without graphics"
     echo "  gomp    - build simcore with openmp with graphics"
+    echo "  mpi     - build simcore with mpi and openmp without graphics"
     echo "  debug   - build simcore in debug mode without graphics"
     echo "  gdebug  - build simcore in debug mode with graphics"
     echo "  trace   - build simcore in trace mode (verbose logging)"
@@ -122,6 +131,9 @@ omp)
 gomp)
     do_graph_omp_build
     ;;
+mpi)
+    do_mpi_build
+    ;;
 gbuild)
     do_graph_build
     ;;
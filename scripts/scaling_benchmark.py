@@ -0,0 +1,183 @@
+"""Runs the canonical simcore scenarios in benchmarks/scenarios at a range of
+OpenMP thread counts and writes strong and weak scaling results as JSON.
+
+Strong scaling runs each scenario unchanged at every thread count. Weak scaling
+multiplies the number of objects of every species by the thread count and grows
+the system so that the density stays the same. For each run, the JSON holds the
+steps per second, the peak resident set size, and the wall time of each phase of
+the simulation step read from the step profiler summary in the .timing file,
+along with the parallel efficiency of each phase relative to the smallest thread
+count. simcore must be built with OMP=1 for the thread count to have an effect.
+
+Usage: python scaling_benchmark.py --simcore path/to/simcore.exe
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+import yaml
+
+SPECIES = ["filament", "passive_filament", "br_bead", "spherocylinder"]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser.add_argument("--simcore", required=True, help="simcore executable")
+    parser.add_argument(
+        "--scenarios",
+        default=os.path.join(here, "..", "benchmarks", "scenarios"),
+        help="directory of scenario parameter files",
+    )
+    parser.add_argument(
+        "--only", nargs="*", help="names of the scenarios to run (default: all)"
+    )
+    parser.add_argument(
+        "--threads",
+        default=default_threads(),
+        help="comma-separated OpenMP thread counts (default: %(default)s)",
+    )
+    parser.add_argument("--mode", choices=["strong", "weak", "both"], default="both")
+    parser.add_argument("--n-steps", type=int, help="override n_steps")
+    parser.add_argument("--work-dir", default="scaling", help="run directory")
+    parser.add_argument("--output", default="scaling.json", help="JSON output")
+    return parser.parse_args()
+
+
+def default_threads():
+    """Powers of two up to the number of cores"""
+    threads = [1]
+    while threads[-1] * 2 <= (os.cpu_count() or 1):
+        threads.append(threads[-1] * 2)
+    return ",".join(str(t) for t in threads)
+
+
+def scale_scenario(params, factor):
+    """Multiply the number of objects by factor at constant density. Crosslink
+    concentrations are per volume and need no scaling."""
+    scaled = dict(params)
+    for name in SPECIES:
+        if name in params and isinstance(params[name], dict):
+            scaled[name] = dict(params[name])
+            scaled[name]["num"] = params[name].get("num", 0) * factor
+    n_dim = params.get("n_dim", 3)
+    scaled["system_radius"] = params["system_radius"] * factor ** (1.0 / n_dim)
+    return scaled
+
+
+def read_profile(timing_file):
+    """Wall time in seconds of each phase from the step profiler summary.
+    Sub-phases are named parent/phase."""
+    phases = {}
+    parent = None
+    in_summary = False
+    with open(timing_file) as f:
+        for line in f:
+            if line.startswith("# Step profile over"):
+                in_summary = True
+                continue
+            if not in_summary or not line.startswith("#   "):
+                continue
+            text = line[4:]
+            fields = text.split()
+            if fields[0] == "phase":
+                continue
+            if fields[0] == "neighbor":
+                break
+            name = fields[0]
+            if text.startswith("  "):
+                name = parent + "/" + name
+            else:
+                parent = name
+            phases[name] = float(fields[1])
+    return phases
+
+
+def run_simcore(simcore, param_file, n_threads):
+    """Run simcore and return its wall time and peak RSS in KiB"""
+    env = dict(os.environ, OMP_NUM_THREADS=str(n_threads))
+    start = time.time()
+    with open(os.devnull, "w") as devnull:
+        proc = subprocess.Popen(
+            [simcore, param_file], env=env, stdout=devnull, stderr=devnull
+        )
+        _, status, usage = os.wait4(proc.pid, 0)
+    wall_time = time.time() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    if proc.returncode != 0:
+        sys.exit("simcore failed on %s with status %d" % (param_file, proc.returncode))
+    return wall_time, usage.ru_maxrss
+
+
+def run(args, params, mode, n_threads):
+    factor = n_threads if mode == "weak" else 1
+    params = scale_scenario(params, factor)
+    params["run_name"] = "%s_%s_t%d" % (params["run_name"], mode, n_threads)
+    if args.n_steps:
+        params["n_steps"] = args.n_steps
+    params["n_profile"] = params["n_steps"]
+    param_file = params["run_name"] + ".yaml"
+    with open(param_file, "w") as f:
+        yaml.safe_dump(params, f)
+    wall_time, peak_rss = run_simcore(args.simcore, param_file, n_threads)
+    phases = read_profile(params["run_name"] + ".timing")
+    return {
+        "threads": n_threads,
+        "scale": factor,
+        "n_steps": params["n_steps"],
+        "wall_time": wall_time,
+        "steps_per_sec": params["n_steps"] / phases["step"],
+        "peak_rss_kib": peak_rss,
+        "phases": {name: {"seconds": t} for name, t in phases.items()},
+    }
+
+
+def add_efficiency(runs, mode):
+    """Parallel efficiency of each phase relative to the first run, which is
+    T0 t0 / (T t) for strong scaling and T0 / T for weak scaling"""
+    base = runs[0]
+    for result in runs:
+        ratio = 1.0
+        if mode == "strong":
+            ratio = float(result["threads"]) / base["threads"]
+        for name, phase in result["phases"].items():
+            t0 = base["phases"].get(name, {}).get("seconds", 0)
+            t = phase["seconds"]
+            phase["efficiency"] = t0 / (ratio * t) if t > 0 else None
+
+
+def main():
+    args = parse_args()
+    args.simcore = os.path.abspath(args.simcore)
+    args.scenarios = os.path.abspath(args.scenarios)
+    threads = sorted(int(t) for t in args.threads.split(","))
+    modes = ["strong", "weak"] if args.mode == "both" else [args.mode]
+    output = os.path.abspath(args.output)
+    os.makedirs(args.work_dir, exist_ok=True)
+    os.chdir(args.work_dir)
+    results = {"simcore": args.simcore, "threads": threads, "scenarios": {}}
+    for file_name in sorted(os.listdir(args.scenarios)):
+        name, ext = os.path.splitext(file_name)
+        if ext != ".yaml" or (args.only and name not in args.only):
+            continue
+        with open(os.path.join(args.scenarios, file_name)) as f:
+            params = yaml.safe_load(f)
+        results["scenarios"][name] = {}
+        for mode in modes:
+            runs = []
+            for n_threads in threads:
+                print("Running %s, %s scaling, %d threads" % (name, mode, n_threads))
+                runs.append(run(args, params, mode, n_threads))
+            add_efficiency(runs, mode)
+            results["scenarios"][name][mode] = runs
+    with open(output, "w") as f:
+        json.dump(results, f, indent=2)
+    print("Wrote " + output)
+
+
+if __name__ == "__main__":
+    main()
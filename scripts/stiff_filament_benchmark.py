@@ -0,0 +1,182 @@
+"""Measures the wall time needed to reach a fixed simulated time with explicit
+and semi-implicit filament bending, and writes the results as JSON.
+
+The stiff filament scenario is run with filament.implicit_bending off and on at
+each of a range of time steps, with n_steps chosen so that every run covers the
+same simulated time. A run is counted as stable if it completes and 1 - <cos>,
+where <cos> is the mean cosine of the angle between neighboring bonds in its
+last spec frame, is no more than a factor max_ratio larger than the worm-like
+chain value 1 - exp(-(n_dim - 1) b / (2 Lp)). Unstable bending grows this by
+orders of magnitude, while implicit bending at large time steps lowers it by
+damping the shortest-wavelength fluctuations.
+
+Usage: python stiff_filament_benchmark.py --simcore path/to/simcore.exe
+"""
+
+import argparse
+import json
+import math
+import os
+import struct
+import subprocess
+import time
+
+import yaml
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser.add_argument("--simcore", required=True, help="simcore executable")
+    parser.add_argument(
+        "--scenario",
+        default=os.path.join(here, "..", "benchmarks", "scenarios", "stiff_filaments.yaml"),
+        help="scenario parameter file",
+    )
+    parser.add_argument(
+        "--time", type=float, default=0.005, help="simulated time of every run"
+    )
+    parser.add_argument(
+        "--explicit-deltas",
+        default="2.5e-7,1e-6,4e-6",
+        help="comma-separated time steps for explicit bending",
+    )
+    parser.add_argument(
+        "--implicit-deltas",
+        default="2.5e-7,5e-6,5e-5,2e-4",
+        help="comma-separated time steps for implicit bending",
+    )
+    parser.add_argument(
+        "--max-ratio",
+        type=float,
+        default=10,
+        help="largest stable ratio of 1 - <cos> to its expected value "
+        "(default: %(default)s)",
+    )
+    parser.add_argument("--work-dir", default="stiff", help="run directory")
+    parser.add_argument("--output", default="stiff.json", help="JSON output")
+    return parser.parse_args()
+
+
+def read_last_frame(spec_file, n_dim):
+    """Mean cosine of the angles between neighboring bonds in the last frame of
+    a filament spec file, following the layout of Filament::WriteSpec"""
+    with open(spec_file, "rb") as f:
+        data = f.read()
+    offset = struct.calcsize("<iid")
+    mean_cos = None
+    while offset < len(data):
+        (n_members,) = struct.unpack_from("<i", data, offset)
+        offset += 4
+        total, count = 0.0, 0
+        for _ in range(n_members):
+            n_sites = struct.unpack_from("<idddi", data, offset)[4]
+            offset += struct.calcsize("<idddi")
+            sites = struct.unpack_from("<%dd" % (3 * n_sites), data, offset)
+            offset += 24 * n_sites + struct.calcsize("<dB")
+            bonds = []
+            for i in range(n_sites - 1):
+                u = [sites[3 * (i + 1) + k] - sites[3 * i + k] for k in range(n_dim)]
+                norm = math.sqrt(sum(x * x for x in u))
+                bonds.append([x / norm for x in u])
+            for u, v in zip(bonds, bonds[1:]):
+                total += sum(a * b for a, b in zip(u, v))
+                count += 1
+        mean_cos = total / count
+    return mean_cos
+
+
+def run(args, params, implicit, delta):
+    params = dict(params)
+    params["filament"] = dict(params["filament"])
+    n_steps = int(round(args.time / delta))
+    params["run_name"] = "%s_%s_%g" % (
+        params["run_name"],
+        "implicit" if implicit else "explicit",
+        delta,
+    )
+    params["delta"] = delta
+    params["n_steps"] = n_steps
+    params["n_profile"] = n_steps
+    params["filament"]["implicit_bending"] = int(implicit)
+    params["filament"]["spec_flag"] = 1
+    params["filament"]["n_spec"] = max(n_steps // 10, 1)
+    param_file = params["run_name"] + ".yaml"
+    with open(param_file, "w") as f:
+        yaml.safe_dump(params, f)
+    start = time.time()
+    with open(os.devnull, "w") as devnull:
+        status = subprocess.call(
+            [args.simcore, param_file], stdout=devnull, stderr=devnull
+        )
+    wall_time = time.time() - start
+    n_dim = params.get("n_dim", 3)
+    fil = params["filament"]
+    bond_length = fil["length"] / fil["n_bonds"]
+    expected = math.exp(-(n_dim - 1) * bond_length / (2 * fil["persistence_length"]))
+    mean_cos = None
+    if status == 0:
+        mean_cos = read_last_frame(params["run_name"] + "_filament.spec", n_dim)
+    ratio = None
+    if mean_cos is not None and math.isfinite(mean_cos):
+        ratio = (1 - mean_cos) / (1 - expected)
+    stable = ratio is not None and ratio <= args.max_ratio
+    return {
+        "implicit_bending": bool(implicit),
+        "delta": delta,
+        "n_steps": n_steps,
+        "wall_time": wall_time,
+        "mean_cos": mean_cos,
+        "expected_cos": expected,
+        "bend_ratio": ratio,
+        "stable": stable,
+    }
+
+
+def main():
+    args = parse_args()
+    args.simcore = os.path.abspath(args.simcore)
+    with open(args.scenario) as f:
+        params = yaml.safe_load(f)
+    output = os.path.abspath(args.output)
+    os.makedirs(args.work_dir, exist_ok=True)
+    os.chdir(args.work_dir)
+    results = {"simcore": args.simcore, "time": args.time, "runs": []}
+    for implicit, deltas in [(0, args.explicit_deltas), (1, args.implicit_deltas)]:
+        for delta in sorted(float(d) for d in deltas.split(",")):
+            print(
+                "Running %s bending, delta %g"
+                % ("implicit" if implicit else "explicit", delta)
+            )
+            result = run(args, params, implicit, delta)
+            print(
+                "  %.2f s, (1 - <cos>) / expected %s, %s"
+                % (
+                    result["wall_time"],
+                    result["bend_ratio"],
+                    "stable" if result["stable"] else "unstable",
+                )
+            )
+            results["runs"].append(result)
+    for implicit in [False, True]:
+        stable = [
+            r for r in results["runs"]
+            if r["implicit_bending"] == implicit and r["stable"]
+        ]
+        if stable:
+            fastest = min(stable, key=lambda r: r["wall_time"])
+            print(
+                "Fastest stable %s run: delta %g, %.2f s"
+                % (
+                    "implicit" if implicit else "explicit",
+                    fastest["delta"],
+                    fastest["wall_time"],
+                )
+            )
+    with open(output, "w") as f:
+        json.dump(results, f, indent=2)
+    print("Wrote " + output)
+
+
+if __name__ == "__main__":
+    main()
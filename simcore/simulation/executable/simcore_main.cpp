@@ -9,6 +9,9 @@
    Parse commandline flags and start simulation manager
 **************************/
 int main(int argc, char *argv[]) {
+  // Start MPI processes when built with MPI, no-op otherwise
+  DomainDecomposition::StartProcesses(&argc, &argv);
+
   // Parse input flags, see parse_flags.h for documentation
   run_options run_opts = parse_opts(argc, argv);
 
@@ -19,5 +22,6 @@ int main(int argc, char *argv[]) {
   // Main control function
   sim.RunManager();
 
+  DomainDecomposition::FinishProcesses();
   return 0;
 }
@@ -1,6 +1,9 @@
 #include "anchor.hpp"
 
-Anchor::Anchor() : Object() { SetSID(species_id::crosslink); }
+Anchor::Anchor() : Object() {
+  SetSID(species_id::crosslink);
+  reload_bond_number_ = -1;
+}
 
 void Anchor::Init() {
   diameter_ = params_->crosslink.diameter;
@@ -32,6 +35,11 @@ void Anchor::SetMeshLambda(double ml) { mesh_lambda_ = ml; }
 
 void Anchor::SetDiffusion() { diffusion_ = sqrt(24.0 * diameter_ / delta_); }
 
+void Anchor::SetTimeStep(double delta) {
+  Object::SetTimeStep(delta);
+  SetDiffusion();
+}
+
 void Anchor::SetWalker(int dir, double walk_v) {
   if (ABS(dir) != 1) {
     Logger::Error("Walker direction must be set to +/- 1");
@@ -79,21 +87,49 @@ void Anchor::UpdateAnchorPositionToMesh() {
   UpdateAnchorPositionToBond();
 }
 
-void Anchor::UpdatePosition() {
-  // Currently only bound anchors diffuse/walk (no explicit unbound anchors)
+/* Copy the anchor's mesh coordinate and walking state into slot i_slot of the
+   SoA motion kernel. Draws the diffusive kick here, so that the kernel itself
+   does not need access to the anchor's RNG. */
+void Anchor::LoadMotion(AnchorMotion &motion, int i_slot) {
   if (!bound_ || (!diffuse_ && !walker_)) {
+    motion.mobile[i_slot] = 0;
     return;
   }
-  // Diffuse or walk along the mesh, updating mesh_lambda
+  motion.mobile[i_slot] = 1;
+  motion.walker[i_slot] = (walker_ ? 1 : 0);
+  motion.end_pausing[i_slot] = (end_pausing_ ? 1 : 0);
+  motion.force_dep[i_slot] = (force_dep_vel_flag_ ? 1 : 0);
+  motion.direction[i_slot] = step_direction_;
+  motion.mesh_length[i_slot] = mesh_length_;
+  motion.mesh_lambda[i_slot] = mesh_lambda_;
+  motion.velocity[i_slot] = velocity_;
+  motion.max_velocity[i_slot] = max_velocity_;
+  motion.f_stall[i_slot] = f_stall_;
+  double force_sq = 0.0;
+  for (int i = 0; i < n_dim_; ++i) {
+    force_sq += force_[i] * force_[i];
+  }
+  motion.force_sq[i_slot] = force_sq;
   if (diffuse_) {
-    Diffuse();
-    if (!CheckMesh())
-      return;
+    double kick = gsl_rng_uniform_pos(rng_.r) - 0.5;
+    motion.kick[i_slot] = kick * diffusion_ * delta_ / diameter_;
+  } else {
+    motion.kick[i_slot] = 0;
   }
-  if (walker_) {
-    Walk();
-    CheckMesh();
+}
+
+/* Copy the result of the SoA motion kernel back from slot i_slot, unbinding
+   the anchor if it moved off its mesh */
+void Anchor::StoreMotion(AnchorMotion const &motion, int i_slot) {
+  if (!motion.mobile[i_slot]) {
+    return;
   }
+  if (motion.off_mesh[i_slot]) {
+    Unbind();
+    return;
+  }
+  mesh_lambda_ = motion.mesh_lambda[i_slot];
+  velocity_ = motion.velocity[i_slot];
 }
 
 void Anchor::ApplyAnchorForces() {
@@ -119,27 +155,8 @@ void Anchor::Deactivate() {
   step_direction_ = -step_direction_;
 }
 
-void Anchor::Walk() {
-  if (force_dep_vel_flag_) {
-    double fmag = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
-      fmag += force_[i] * force_[i];
-    }
-    fmag = sqrt(fmag);
-    // Linear force-velocity relationship
-    double fdep = 1 - fmag / f_stall_;
-    if (fdep > 1) {
-      fdep = 1;
-    } else if (fdep < 0) {
-      fdep = 0;
-    }
-    velocity_ = max_velocity_ * fdep;
-  }
-  double dr = step_direction_ * velocity_ * delta_;
-  mesh_lambda_ += dr;
-}
-
-// Check that the anchor is still located on the filament mesh
+// Check that the anchor is still located on the filament mesh after the mesh
+// changed length (motion along the mesh is checked by AnchorMotion)
 // Returns true if anchor is still on the mesh, false otherwise
 bool Anchor::CheckMesh() {
   // Check if we moved off the mesh tail
@@ -180,12 +197,6 @@ void Anchor::Unbind() {
   std::fill(orientation_, orientation_ + 3, 0.0);
 }
 
-void Anchor::Diffuse() {
-  double kick = gsl_rng_uniform_pos(rng_.r) - 0.5;
-  double dr = kick * diffusion_ * delta_ / diameter_;
-  mesh_lambda_ += dr;
-}
-
 void Anchor::UpdateAnchorPositionToBond() {
   double const *const bond_position = bond_->GetPosition();
   double const *const bond_orientation = bond_->GetOrientation();
@@ -288,6 +299,19 @@ int const Anchor::GetBoundOID() {
   return bond_->GetOID();
 }
 
+int const Anchor::GetBondNumber() {
+  if (!bound_ || bond_ == nullptr) {
+    return -1;
+  }
+  return bond_->GetBondNumber();
+}
+
+int const Anchor::GetReloadBondNumber() { return reload_bond_number_; }
+
+void Anchor::SetReloadBondNumber(int bond_number) {
+  reload_bond_number_ = bond_number;
+}
+
 /* Temporary function for setting bound state for singly-bound crosslinks,
    in order to get them to draw while not technically bound to a bond
    ( e.g. bond_ -> null ) */
@@ -313,10 +337,12 @@ void Anchor::WriteSpec(std::fstream &ospec) {
   ospec.write(reinterpret_cast<char *>(&active_), sizeof(bool));
   ospec.write(reinterpret_cast<char *>(&mid), sizeof(int));
   for (int i = 0; i < 3; ++i) {
-    ospec.write(reinterpret_cast<char *>(&position_[i]), sizeof(double));
+    double q = SpecCompression::Quantize(ospec, position_[i]);
+    ospec.write(reinterpret_cast<char *>(&q), sizeof(double));
   }
   for (int i = 0; i < 3; ++i) {
-    ospec.write(reinterpret_cast<char *>(&orientation_[i]), sizeof(double));
+    double q = SpecCompression::Quantize(ospec, orientation_[i]);
+    ospec.write(reinterpret_cast<char *>(&q), sizeof(double));
   }
   ospec.write(reinterpret_cast<char *>(&mesh_lambda_), sizeof(double));
 }
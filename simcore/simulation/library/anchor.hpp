@@ -1,6 +1,7 @@
 #ifndef _SIMCORE_ANCHOR_H_
 #define _SIMCORE_ANCHOR_H_
 
+#include "anchor_motion.hpp"
 #include "mesh.hpp"
 #include "neighbor_list.hpp"
 
@@ -33,22 +34,24 @@ private:
   Mesh *mesh_;
 
   int mesh_n_bonds_;
+  /* Bond number read from a checkpoint, used to reattach without searching */
+  int reload_bond_number_;
 
   void UpdateAnchorPositionToBond();
-  void Diffuse();
-  void Walk();
   bool CheckMesh();
 
 public:
   Anchor();
   void Init();
   bool IsBound();
-  void UpdatePosition();
+  void LoadMotion(AnchorMotion &motion, int i_slot);
+  void StoreMotion(AnchorMotion const &motion, int i_slot);
   void Activate();
   void Deactivate();
   void ApplyAnchorForces();
   void UpdateAnchorPositionToMesh();
   void SetDiffusion();
+  void SetTimeStep(double delta);
   void SetWalker(int dir, double walk_v);
   void AttachObjRandom(Object *o);
   void AttachObjLambda(Object *o, double lambda);
@@ -60,6 +63,9 @@ public:
   void SetBound();
   void Unbind();
   int const GetBoundOID();
+  int const GetBondNumber();
+  int const GetReloadBondNumber();
+  void SetReloadBondNumber(int bond_number);
   void Draw(std::vector<graph_struct *> *graph_array);
   void AddNeighbor(Object *neighbor);
   void ClearNeighbors();
@@ -0,0 +1,106 @@
+#ifndef _SIMCORE_ANCHOR_MOTION_H_
+#define _SIMCORE_ANCHOR_MOTION_H_
+
+#include <vector>
+#include <math.h>
+#ifdef ENABLE_OPENMP
+#include "omp.h"
+#endif
+
+/* Structure-of-arrays kernel for moving bound anchors along their meshes.
+   Anchors copy their mesh coordinate, walking velocity and force dependence
+   into contiguous arrays (one slot per anchor), the kernel advances every slot
+   in a single branch-free loop that the compiler can vectorize, and anchors
+   then copy the result back, unbinding if they moved off their mesh.
+
+   Random diffusive kicks are drawn by each anchor with its own RNG when it
+   loads its slot, so the kernel itself is deterministic and the sequence of
+   random numbers drawn per anchor is the same as when anchors diffused and
+   walked one at a time.
+   Slots that are not mobile (unbound anchors, or anchors that neither diffuse
+   nor walk) are left unchanged. */
+class AnchorMotion {
+private:
+  int n_slots_ = 0;
+  double delta_ = 0;
+
+public:
+  /* Per-slot inputs */
+  std::vector<int> mobile;
+  std::vector<int> walker;
+  std::vector<int> end_pausing;
+  std::vector<int> force_dep;
+  std::vector<int> direction;
+  std::vector<double> mesh_length;
+  std::vector<double> kick;
+  std::vector<double> max_velocity;
+  std::vector<double> f_stall;
+  std::vector<double> force_sq;
+  /* Per-slot inputs and outputs */
+  std::vector<double> mesh_lambda;
+  std::vector<double> velocity;
+  /* Per-slot output, nonzero if the anchor moved off its mesh */
+  std::vector<int> off_mesh;
+
+  void Init(double delta) { delta_ = delta; }
+  int GetNSlots() const { return n_slots_; }
+  /* Size the kernel to hold n_slots anchors. All slots start out immobile, so
+     anchors only need to load the slots they actually use. */
+  void Resize(int n_slots) {
+    n_slots_ = n_slots;
+    mobile.assign(n_slots, 0);
+    walker.resize(n_slots);
+    end_pausing.resize(n_slots);
+    force_dep.resize(n_slots);
+    direction.resize(n_slots);
+    mesh_length.resize(n_slots);
+    kick.resize(n_slots);
+    max_velocity.resize(n_slots);
+    f_stall.resize(n_slots);
+    force_sq.resize(n_slots);
+    mesh_lambda.resize(n_slots);
+    velocity.resize(n_slots);
+    off_mesh.assign(n_slots, 0);
+  }
+  /* Diffuse, then walk, every mobile slot. Anchors that leave the mesh either
+     stick to the mesh end (end pausing) or are flagged in off_mesh. */
+  void Advance() {
+    int *const mob = mobile.data();
+    int *const walk = walker.data();
+    int *const pause = end_pausing.data();
+    int *const fdep_flag = force_dep.data();
+    int *const dir = direction.data();
+    int *const off = off_mesh.data();
+    double *const len = mesh_length.data();
+    double *const dr = kick.data();
+    double *const vmax = max_velocity.data();
+    double *const fstall = f_stall.data();
+    double *const fsq = force_sq.data();
+    double *const lambda = mesh_lambda.data();
+    double *const vel = velocity.data();
+    double const delta = delta_;
+#ifdef ENABLE_OPENMP
+#pragma omp simd
+#endif
+    for (int i = 0; i < n_slots_; ++i) {
+      double l = lambda[i] + dr[i];
+      int off_diffuse = (!pause[i] && (l < 0 || l > len[i]));
+      l = (l < 0 ? 0 : (l > len[i] ? len[i] : l));
+      // Linear force-velocity relationship
+      double fdep = 1 - sqrt(fsq[i]) / fstall[i];
+      fdep = (fdep > 1 ? 1 : (fdep < 0 ? 0 : fdep));
+      double v = (fdep_flag[i] ? vmax[i] * fdep : vel[i]);
+      double l_walk = l + dir[i] * v * delta;
+      l = (walk[i] ? l_walk : l);
+      int off_walk = (!pause[i] && (l < 0 || l > len[i]));
+      l = (l < 0 ? 0 : (l > len[i] ? len[i] : l));
+      if (mob[i]) {
+        lambda[i] = l;
+        vel[i] = (walk[i] ? v : vel[i]);
+        off[i] = (off_diffuse || off_walk);
+      }
+    }
+  }
+};
+
+#endif // _SIMCORE_ANCHOR_MOTION_H_
@@ -0,0 +1,167 @@
+#include "async_output.hpp"
+#include <algorithm>
+
+thread_local std::map<std::fstream *, AsyncStreamBuffer *>
+    AsyncOutput::buffers_;
+
+const int AsyncStreamBuffer::max_pending_;
+const size_t AsyncStreamBuffer::min_frame_size_;
+
+AsyncStreamBuffer::AsyncStreamBuffer(std::streambuf *sink) : sink_(sink) {
+  base_offset_ = sink_->pubseekoff(0, std::ios_base::cur, std::ios_base::out);
+  front_.resize(min_frame_size_);
+  setp(front_.data(), front_.data() + front_.size());
+  writer_ = std::thread(&AsyncStreamBuffer::Run, this);
+}
+
+AsyncStreamBuffer::~AsyncStreamBuffer() { Finish(); }
+
+/* Grow the frame buffer so that n more bytes fit in the put area */
+void AsyncStreamBuffer::Reserve(size_t n) {
+  size_t used = pptr() - pbase();
+  if (n <= (size_t)(epptr() - pptr())) {
+    return;
+  }
+  front_.resize(std::max(2 * front_.size(), used + n));
+  setp(front_.data(), front_.data() + front_.size());
+  pbump(used);
+}
+
+AsyncStreamBuffer::int_type AsyncStreamBuffer::overflow(int_type c) {
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    Reserve(1);
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+std::streamsize AsyncStreamBuffer::xsputn(const char *s, std::streamsize n) {
+  Reserve(n);
+  std::copy(s, s + n, pptr());
+  pbump(n);
+  return n;
+}
+
+/* Only reporting the current output position (tellp) is supported */
+AsyncStreamBuffer::pos_type
+AsyncStreamBuffer::seekoff(off_type off, std::ios_base::seekdir way,
+                           std::ios_base::openmode which) {
+  if (off != 0 || way != std::ios_base::cur || !(which & std::ios_base::out) ||
+      base_offset_ < 0) {
+    return pos_type(off_type(-1));
+  }
+  return pos_type(base_offset_ + n_submitted_ + (off_type)(pptr() - pbase()));
+}
+
+int AsyncStreamBuffer::sync() {
+  Submit();
+  return 0;
+}
+
+/* Hand the current frame to the writer thread and continue in a recycled
+   buffer, waiting only if too many frames are already waiting to be
+   written */
+void AsyncStreamBuffer::Submit() {
+  size_t size = pptr() - pbase();
+  if (size == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lk(mtx_);
+  cv_.wait(lk, [this] { return (int)pending_.size() < max_pending_; });
+  if (write_failed_) {
+    Logger::Error("Asynchronous output writer failed to write frame");
+  }
+  n_submitted_ += size;
+  pending_.emplace_back();
+  pending_.back().data.swap(front_);
+  pending_.back().size = size;
+  if (!spare_.empty()) {
+    front_.swap(spare_.back());
+    spare_.pop_back();
+  }
+  lk.unlock();
+  cv_.notify_all();
+  if (front_.size() < size) {
+    front_.resize(std::max(size, min_frame_size_));
+  }
+  setp(front_.data(), front_.data() + front_.size());
+}
+
+void AsyncStreamBuffer::Run() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (true) {
+    cv_.wait(lk, [this] { return !pending_.empty() || stop_; });
+    if (pending_.empty()) {
+      /* Stopped with nothing left to write */
+      return;
+    }
+    /* The simulation only touches the front of pending_ through the lock */
+    std::vector<char> frame;
+    frame.swap(pending_.front().data);
+    std::streamsize size = pending_.front().size;
+    lk.unlock();
+    /* Sync after each frame so that compressed sinks see frame boundaries */
+    bool failed = (sink_->sputn(frame.data(), size) != size ||
+                   sink_->pubsync() != 0);
+    lk.lock();
+    write_failed_ = write_failed_ || failed;
+    pending_.pop_front();
+    spare_.push_back(std::move(frame));
+    cv_.notify_all();
+  }
+}
+
+/* Write any remaining output and stop the writer thread */
+void AsyncStreamBuffer::Finish() {
+  if (!writer_.joinable()) {
+    return;
+  }
+  Submit();
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  writer_.join();
+  if (write_failed_) {
+    Logger::Error("Asynchronous output writer failed to write frame");
+  }
+  sink_->pubsync();
+}
+
+void AsyncOutput::Attach(std::fstream &ofile) {
+  if (buffers_.count(&ofile)) {
+    return;
+  }
+  /* Chain onto the stream's current buffer, which is the file buffer or a
+     CompressedSpecWriter, so the writer thread writes to it while the stream
+     writes to memory */
+  AsyncStreamBuffer *buffer =
+      new AsyncStreamBuffer(static_cast<std::ios &>(ofile).rdbuf());
+  static_cast<std::ios &>(ofile).rdbuf(buffer);
+  buffers_[&ofile] = buffer;
+}
+
+void AsyncOutput::Detach(std::fstream &ofile) {
+  auto it = buffers_.find(&ofile);
+  if (it == buffers_.end()) {
+    return;
+  }
+  it->second->Finish();
+  static_cast<std::ios &>(ofile).rdbuf(it->second->GetSink());
+  delete it->second;
+  buffers_.erase(it);
+}
+
+void AsyncOutput::DetachAll() {
+  while (!buffers_.empty()) {
+    Detach(*(buffers_.begin()->first));
+  }
+}
+
+void AsyncOutput::EndFrame() {
+  for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+    it->second->Submit();
+  }
+}
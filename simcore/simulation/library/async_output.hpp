@@ -0,0 +1,81 @@
+#ifndef _SIMCORE_ASYNC_OUTPUT_H_
+#define _SIMCORE_ASYNC_OUTPUT_H_
+
+#include "logger.hpp"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+/* Stream buffer that collects everything written to an output stream during
+   an output frame into a contiguous buffer in memory. At the end of the frame
+   the buffer is handed to a background thread that writes it to the stream's
+   original file buffer, while the simulation fills the next buffer.
+
+   Frame buffers are recycled once written, so after the first few frames the
+   simulation only copies its output into memory that is already allocated,
+   and writes go straight into the put area without reallocating. Up to
+   max_pending_ frames may wait for the writer, so the simulation only blocks
+   if the writer falls that far behind. */
+class AsyncStreamBuffer : public std::streambuf {
+private:
+  static const int max_pending_ = 2;
+  static const size_t min_frame_size_ = 4096;
+  /* Frame buffers keep their full allocated size, size is the part in use */
+  struct Frame {
+    std::vector<char> data;
+    size_t size = 0;
+  };
+  std::streambuf *sink_;
+  std::vector<char> front_; // Filled by the simulation through the put area
+  std::deque<Frame> pending_;            // Written to sink_ by the writer
+  std::vector<std::vector<char>> spare_; // Written frames for reuse
+  bool stop_ = false;
+  bool write_failed_ = false;
+  /* File position of the sink when attached, and number of bytes submitted
+     since, used to report the stream position */
+  std::streamoff base_offset_ = 0;
+  std::streamoff n_submitted_ = 0;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::thread writer_;
+  void Run();
+  void Reserve(size_t n);
+
+protected:
+  int_type overflow(int_type c);
+  std::streamsize xsputn(const char *s, std::streamsize n);
+  int sync();
+  pos_type seekoff(off_type off, std::ios_base::seekdir way,
+                   std::ios_base::openmode which);
+
+public:
+  AsyncStreamBuffer(std::streambuf *sink);
+  ~AsyncStreamBuffer();
+  void Submit();
+  void Finish();
+  std::streambuf *GetSink() { return sink_; }
+};
+
+/* Registry of output file streams that write through an AsyncStreamBuffer.
+   Streams are attached after they are opened, every attached stream is
+   submitted to its writer at the end of each output frame, and streams must
+   be detached before they are closed. */
+class AsyncOutput {
+private:
+  /* Streams attached by the calling thread, so that simulations running on
+     separate threads only flush and detach their own streams */
+  static thread_local std::map<std::fstream *, AsyncStreamBuffer *> buffers_;
+
+public:
+  static void Attach(std::fstream &ofile);
+  static void Detach(std::fstream &ofile);
+  static void DetachAll();
+  static void EndFrame();
+};
+
+#endif // _SIMCORE_ASYNC_OUTPUT_H_
@@ -7,8 +7,7 @@
 #include "parameters.hpp"
 #include "logger.hpp"
 
-extern bool early_exit;
-
 #include "function_headers.hpp"
+#include "dim_templates.hpp"
 
 #endif  // _AUXILIARY_H_
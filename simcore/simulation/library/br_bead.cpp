@@ -40,11 +40,35 @@ void BrBead::InsertBrBead() {
   }
 }
 
+/* Advance the bead on its own, in a one-slot SoA motion kernel */
 void BrBead::UpdatePosition() {
+  BrownianMotion motion;
+  motion.Init(space_);
+  motion.UpdateMembers(this, 1, &BrownianMotion::AdvanceBeads);
+}
+
+/* Copy the bead's position and force, including its thermal kick and
+   driving force, into slot i_slot of the SoA motion kernel */
+void BrBead::LoadMotion(BrownianMotion &motion, int i_slot) {
   SetPrevPosition(position_);
   ApplyForcesTorques();
-  Integrate();
-  UpdatePeriodic();
+  for (int i = 0; i < n_dim_; ++i) {
+    motion.position[i][i_slot] = position_[i];
+    motion.force[i][i_slot] = force_[i];
+  }
+  motion.delta[i_slot] = delta_;
+  motion.gamma_trans[i_slot] = gamma_trans_;
+}
+
+/* Copy the result of the SoA motion kernel back from slot i_slot */
+void BrBead::StoreMotion(BrownianMotion const &motion, int i_slot) {
+  for (int i = 0; i < n_dim_; ++i) {
+    position_[i] = motion.position[i][i_slot];
+  }
+  for (int i = 0; i < space_->n_periodic; ++i) {
+    scaled_position_[i] = motion.scaled_position[i][i_slot];
+  }
+  UpdateKMC();
 }
 
 void BrBead::ApplyForcesTorques() {
@@ -68,40 +92,9 @@ void BrBead::SetDiffusion() {
   diffusion_ = sqrt(24.0 * diameter_ / delta_);
 }
 
-void BrBead::Translate() {
-  double dr[3];
-  double fmag = 0;
-  for (int i = 0; i < n_dim_; ++i) {
-    fmag += force_[i] * force_[i];
-    dr[i] = force_[i] * delta_ * gamma_trans_;
-    position_[i] += dr[i];
-  }
-}
-
-void BrBead::Rotate() {
-  double unit_torque[3], temp[3], r_rel[3];
-  double domega, cos_domega, sin_domega, torque_mag;
-  // First rotate orientation vector of sphere
-  if (n_dim_ == 2) {
-    domega = torque_[2] * delta_ * gamma_rot_;
-    cos_domega = cos(domega);
-    sin_domega = sin(domega);
-    std::copy(orientation_, orientation_ + 3, temp);
-    orientation_[0] = cos_domega * temp[0] - sin_domega * temp[1];
-    orientation_[1] = sin_domega * temp[0] + cos_domega * temp[1];
-  } else if (n_dim_ == 3) {
-    torque_mag = 0.0;
-    for (int i = 0; i < 3; ++i) torque_mag += torque_[i];
-    for (int i = 0; i < 3; ++i) unit_torque[i] = torque_[i] / torque_mag;
-    domega = torque_mag * delta_ * gamma_rot_;
-    rotate_vector(orientation_, unit_torque, domega);
-  }
-  normalize_vector(orientation_, n_dim_);
-}
-
-void BrBead::Integrate() {
-  Translate();
-  // Rotate();
+void BrBead::SetTimeStep(double delta) {
+  Object::SetTimeStep(delta);
+  SetDiffusion();
 }
 
 void BrBead::GetInteractors(std::vector<Object*>* ix) {
@@ -0,0 +1,290 @@
+#ifndef _SIMCORE_BROWNIAN_MOTION_H_
+#define _SIMCORE_BROWNIAN_MOTION_H_
+
+#include "definitions.hpp"
+#include "macros.hpp"
+#include <math.h>
+#include <vector>
+#ifdef ENABLE_OPENMP
+#include "omp.h"
+#endif
+
+/* Structure-of-arrays kernel for the Brownian dynamics of free, rigid
+   species members (BrBeads and Spherocylinders). Members copy their position,
+   orientation, force, torque and friction coefficients into contiguous arrays
+   (one slot per member), the kernel integrates a range of slots in a loop that
+   the compiler can vectorize, and members then copy the result back. Species
+   work through their members in blocks of block_size slots, loading,
+   advancing and storing one block at a time so that each member is still in
+   cache when it is stored, with the blocks split across threads.
+
+   As with AnchorMotion, the thermal noise is drawn by each member with its
+   own RNG when it loads its slot, so the kernel itself is deterministic and
+   each member draws the same sequence of random numbers however the members
+   are split into blocks. Members advanced on their own, through their
+   UpdatePosition, use a kernel of one slot. */
+class BrownianMotion {
+private:
+  int n_slots_ = 0;
+  space_struct *space_ = nullptr;
+
+  template <int N_DIM> void TranslateBeads(int first, int last);
+  template <int N_DIM> void MoveRods(int first, int last);
+  template <int N_DIM> void UpdatePeriodic(int first, int last);
+
+public:
+  static const int block_size = 256;
+  /* Per-slot inputs */
+  std::vector<double> force[3];
+  std::vector<double> torque[3];
+  std::vector<double> delta;
+  /* Translational mobility of beads, parallel and perpendicular mobilities
+     and rotational friction of rods */
+  std::vector<double> gamma_trans;
+  std::vector<double> gamma_par;
+  std::vector<double> gamma_perp;
+  std::vector<double> gamma_rot;
+  /* Random displacements of rods along their orientation and their body
+     frame, and random rotations about their body frame */
+  std::vector<double> kick_par;
+  std::vector<double> kick_perp[2];
+  std::vector<double> kick_rot[2];
+  /* Per-slot inputs and outputs */
+  std::vector<double> position[3];
+  std::vector<double> orientation[3];
+  /* Per-slot outputs, only the periodic components are updated */
+  std::vector<double> scaled_position[3];
+
+  void Init(space_struct *space) { space_ = space; }
+  int GetNSlots() const { return n_slots_; }
+  int GetNBlocks() const { return (n_slots_ + block_size - 1) / block_size; }
+  int GetBlockEnd(int i_block) const {
+    int last = (i_block + 1) * block_size;
+    return (last < n_slots_ ? last : n_slots_);
+  }
+  void Resize(int n_slots) {
+    n_slots_ = n_slots;
+    for (int i = 0; i < 3; ++i) {
+      force[i].resize(n_slots);
+      torque[i].resize(n_slots);
+      position[i].resize(n_slots);
+      orientation[i].resize(n_slots);
+      scaled_position[i].resize(n_slots);
+    }
+    delta.resize(n_slots);
+    gamma_trans.resize(n_slots);
+    gamma_par.resize(n_slots);
+    gamma_perp.resize(n_slots);
+    gamma_rot.resize(n_slots);
+    kick_par.resize(n_slots);
+    for (int i = 0; i < 2; ++i) {
+      kick_perp[i].resize(n_slots);
+      kick_rot[i].resize(n_slots);
+    }
+  }
+  /* Overdamped translation of isotropic beads in slots [first, last),
+     r += F * delta * gamma_trans, followed by the periodic update of their
+     scaled positions */
+  void AdvanceBeads(int first, int last) {
+    if (space_->n_dim == 2) {
+      TranslateBeads<2>(first, last);
+      UpdatePeriodic<2>(first, last);
+    } else {
+      TranslateBeads<3>(first, last);
+      UpdatePeriodic<3>(first, last);
+    }
+  }
+  /* Anisotropic translation and rotation of rods in slots [first, last) with
+     thermal noise in their body frame, followed by the periodic update of
+     their scaled positions. The integration scheme is from Yu-Guo Tao,
+     J Chem Phys 122 244903 (2005),
+
+       r(t+dt) = r(t) + (Xi^-1 . F_s(t)) * dt + dr(t),
+       u(t+dt) = u(t) + gamma_rot^-1 * T_s(t) x u(t) * dt + du(t),
+
+     where the friction tensor Xi = gamma_par * |u><u| + gamma_perp *
+     (I - |u><u|), F_s and T_s are the force and torque from interactions,
+     and dr(t) and du(t) are random displacements along the rod and its body
+     frame with std dev sqrt(2*kT*dt/gamma) along each direction. */
+  void AdvanceRods(int first, int last) {
+    if (space_->n_dim == 2) {
+      MoveRods<2>(first, last);
+      UpdatePeriodic<2>(first, last);
+    } else {
+      MoveRods<3>(first, last);
+      UpdatePeriodic<3>(first, last);
+    }
+  }
+  /* Advance n_members members of type T, BrBeads or Spherocylinders, with
+     advance, AdvanceBeads or AdvanceRods. Members are loaded, advanced and
+     stored one block at a time, with the blocks split across threads. */
+  template <typename T>
+  void UpdateMembers(T *members, int n_members,
+                     void (BrownianMotion::*advance)(int, int)) {
+    Resize(n_members);
+    int n_blocks = GetNBlocks();
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for if (n_blocks > 1)
+#endif
+    for (int i_block = 0; i_block < n_blocks; ++i_block) {
+      int first = i_block * block_size;
+      int last = GetBlockEnd(i_block);
+      for (int i = first; i < last; ++i) {
+        members[i].LoadMotion(*this, i);
+      }
+      (this->*advance)(first, last);
+      for (int i = first; i < last; ++i) {
+        members[i].StoreMotion(*this, i);
+      }
+    }
+  }
+};
+
+template <int N_DIM>
+void BrownianMotion::TranslateBeads(int first, int last) {
+  double *r[3], *f[3];
+  for (int i = 0; i < 3; ++i) {
+    r[i] = position[i].data();
+    f[i] = force[i].data();
+  }
+  double const *const dt = delta.data();
+  double const *const gt = gamma_trans.data();
+#ifdef ENABLE_OPENMP
+#pragma omp simd
+#endif
+  for (int k = first; k < last; ++k) {
+    for (int i = 0; i < N_DIM; ++i) {
+      r[i][k] += f[i][k] * dt[k] * gt[k];
+    }
+  }
+}
+
+template <int N_DIM> void BrownianMotion::MoveRods(int first, int last) {
+  double *r[3], *u[3], *f[3], *t[3];
+  for (int i = 0; i < 3; ++i) {
+    r[i] = position[i].data();
+    u[i] = orientation[i].data();
+    f[i] = force[i].data();
+    t[i] = torque[i].data();
+  }
+  double const *const dt = delta.data();
+  double const *const g_par = gamma_par.data();
+  double const *const g_perp = gamma_perp.data();
+  double const *const g_rot = gamma_rot.data();
+  double const *const k_par = kick_par.data();
+  double const *const k_perp0 = kick_perp[0].data();
+  double const *const k_perp1 = kick_perp[1].data();
+  double const *const k_rot0 = kick_rot[0].data();
+  double const *const k_rot1 = kick_rot[1].data();
+#ifdef ENABLE_OPENMP
+#pragma omp simd
+#endif
+  for (int k = first; k < last; ++k) {
+    double const step = dt[k];
+    double pos[3], uk[3], fk[3];
+    for (int i = 0; i < N_DIM; ++i) {
+      pos[i] = r[i][k];
+      uk[i] = u[i][k];
+      fk[i] = f[i][k];
+    }
+    // Friction tensor acting on the systematic force
+    for (int i = 0; i < N_DIM; ++i) {
+      for (int j = 0; j < N_DIM; ++j) {
+        pos[i] += g_par[k] * uk[i] * uk[j] * fk[j] * step;
+      }
+      pos[i] += fk[i] * g_perp[k] * step;
+    }
+    // Reorientation due to torques, du = T x u
+    double du[3];
+    if (N_DIM == 2) {
+      du[0] = -t[2][k] * uk[1];
+      du[1] = t[2][k] * uk[0];
+    } else {
+      du[0] = t[1][k] * uk[2] - t[2][k] * uk[1];
+      du[1] = t[2][k] * uk[0] - t[0][k] * uk[2];
+      du[2] = t[0][k] * uk[1] - t[1][k] * uk[0];
+    }
+    for (int i = 0; i < N_DIM; ++i) {
+      uk[i] += du[i] * step / g_rot[k];
+    }
+    // Body frame orthogonal to the reoriented rod
+    double b0[3], b1[3];
+    if (N_DIM == 2) {
+      b0[0] = uk[1];
+      b0[1] = -uk[0];
+    } else {
+      bool along_x = !(1.0 - ABS(uk[0]) > 1e-2);
+      b0[0] = (along_x ? -uk[2] : 0.0);
+      b0[1] = (along_x ? 0.0 : uk[2]);
+      b0[2] = (along_x ? uk[0] : -uk[1]);
+      double b0_mag = sqrt(b0[0] * b0[0] + b0[1] * b0[1] + b0[2] * b0[2]);
+      for (int i = 0; i < 3; ++i) {
+        b0[i] /= b0_mag;
+      }
+      b1[0] = uk[1] * b0[2] - uk[2] * b0[1];
+      b1[1] = uk[2] * b0[0] - uk[0] * b0[2];
+      b1[2] = uk[0] * b0[1] - uk[1] * b0[0];
+    }
+    // Random displacement along and perpendicular to the rod
+    for (int i = 0; i < N_DIM; ++i) {
+      pos[i] += k_par[k] * uk[i];
+    }
+    for (int i = 0; i < N_DIM; ++i) {
+      pos[i] += k_perp0[k] * b0[i];
+    }
+    if (N_DIM == 3) {
+      for (int i = 0; i < N_DIM; ++i) {
+        pos[i] += k_perp1[k] * b1[i];
+      }
+    }
+    // Random reorientation about the body frame
+    for (int i = 0; i < N_DIM; ++i) {
+      uk[i] += k_rot0[k] * b0[i];
+    }
+    if (N_DIM == 3) {
+      for (int i = 0; i < N_DIM; ++i) {
+        uk[i] += k_rot1[k] * b1[i];
+      }
+    }
+    double u_mag = 0.0;
+    for (int i = 0; i < N_DIM; ++i) {
+      u_mag += uk[i] * uk[i];
+    }
+    u_mag = sqrt(u_mag);
+    for (int i = 0; i < N_DIM; ++i) {
+      r[i][k] = pos[i];
+      u[i][k] = uk[i] / u_mag;
+    }
+  }
+}
+
+/* Scaled positions in the periodic subspace, as in
+   periodic_boundary_conditions */
+template <int N_DIM>
+void BrownianMotion::UpdatePeriodic(int first, int last) {
+  int const n_periodic = space_->n_periodic;
+  double const *const h_inv = space_->unit_cell_inv;
+  double *r[3], *s[3];
+  for (int i = 0; i < 3; ++i) {
+    r[i] = position[i].data();
+    s[i] = scaled_position[i].data();
+  }
+#ifdef ENABLE_OPENMP
+#pragma omp simd
+#endif
+  for (int k = first; k < last; ++k) {
+    for (int i = 0; i < N_DIM; ++i) {
+      if (i < n_periodic) {
+        double si = 0.0;
+        for (int j = 0; j < N_DIM; ++j) {
+          if (j < n_periodic) {
+            si += h_inv[N_DIM * i + j] * r[j][k];
+          }
+        }
+        s[i][k] = si - NINT(si);
+      }
+    }
+  }
+}
+
+#endif // _SIMCORE_BROWNIAN_MOTION_H_
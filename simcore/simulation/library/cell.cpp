@@ -29,13 +29,13 @@ const std::vector<Object *> &Cell::GetCellObjects() const { return cell_objs_; }
 
 void Cell::PairSingleObject(Object &obj,
                             std::vector<Interaction> &pair_list) const {
-  Logger::Trace("Checking single object pairs with %s", Report().c_str());
+  LOG_TRACE("Checking single object pairs with %s", Report().c_str());
   for (int i = 0; i < cell_objs_.size(); ++i) {
     Interaction ix(&obj, cell_objs_[i]);
     pair_list.push_back(ix);
 #ifdef TRACE
-    Logger::Trace("Single object interaction pair: %d -> %d", obj.GetOID(),
-                  cell_objs_[i]->GetOID());
+    LOG_TRACE("Single object interaction pair: %d -> %d", obj.GetOID(),
+              cell_objs_[i]->GetOID());
 #endif
   }
 }
@@ -44,14 +44,14 @@ void Cell::MakePairsCell(Cell &cell, std::vector<Interaction> &pair_list) const
   if (cell.NObjs() == 0)
     return;
   const std::vector<Object *> those_objs = cell.GetCellObjects();
-  Logger::Trace("%s adjacent to %s:", Report().c_str(), cell.Report().c_str());
+  LOG_TRACE("%s adjacent to %s:", Report().c_str(), cell.Report().c_str());
   for (int i = 0; i < NObjs(); ++i) {
     for (int j = 0; j < cell.NObjs(); ++j) {
       Interaction ix(cell_objs_[i], those_objs[j]);
       pair_list.push_back(ix);
 #ifdef TRACE
-      Logger::Trace("Interaction pair: %d -> %d", cell_objs_[i]->GetOID(),
-                    those_objs[j]->GetOID());
+      LOG_TRACE("Interaction pair: %d -> %d", cell_objs_[i]->GetOID(),
+                those_objs[j]->GetOID());
 #endif
     }
   }
@@ -2,7 +2,7 @@
 
 void CellList::Init(int n_cells_1d, double cell_length, int n_dim,
                     int n_periodic) {
-  Logger::Trace("Initializing cell list");
+  LOG_TRACE("Initializing cell list");
   n_dim_ = n_dim;
   n_periodic_ = n_periodic;
   cell_length_ = cell_length;
@@ -16,9 +16,9 @@ void CellList::Init(int n_cells_1d, double cell_length, int n_dim,
 }
 
 void CellList::AllocateCells() {
-  Logger::Debug("Allocating cell list");
-  Logger::Trace("cell_length: %2.2f", cell_length_);
-  Logger::Trace("n_cells_1d: %d", n_cells_1d_);
+  LOG_DEBUG("Allocating cell list");
+  LOG_TRACE("cell_length: %2.2f", cell_length_);
+  LOG_TRACE("n_cells_1d: %d", n_cells_1d_);
 
   int third_dim = (n_dim_ == 3 ? n_cells_1d_ : 1);
   cell_ = new Cell **[n_cells_1d_];
@@ -43,7 +43,7 @@ void CellList::ResetNeighbors() {
 }
 
 void CellList::DeallocateCells() {
-  Logger::Debug("Deallocating cell list");
+  LOG_DEBUG("Deallocating cell list");
   for (int i = 0; i < n_cells_1d_; ++i) {
     for (int j = 0; j < n_cells_1d_; ++j) {
       delete[] cell_[i][j];
@@ -65,7 +65,7 @@ void CellList::LabelCells() {
 }
 
 void CellList::MakePairs(std::vector<Interaction> &pair_list) {
-  Logger::Debug("Constructing object interaction pairs");
+  LOG_DEBUG("Constructing object interaction pairs");
   int third_dim = (n_dim_ == 3 ? n_cells_1d_ : 1);
   for (int i = 0; i < n_cells_1d_; ++i) {
     for (int j = 0; j < n_cells_1d_; ++j) {
@@ -76,28 +76,19 @@ void CellList::MakePairs(std::vector<Interaction> &pair_list) {
   }
 }
 
-xyz_coord CellList::FindCellCoords(Object &obj) {
+template <int N_DIM> xyz_coord CellList::FindCellCoords(Object &obj) {
   const double *const spos = obj.GetScaledPosition();
-  double x = spos[0] + 0.5;
-  int xcell = (int)floor(n_cells_1d_ * x);
-  if (xcell == n_cells_1d_)
-    xcell -= 1;
-  double y = spos[1] + 0.5;
-  int ycell = (int)floor(n_cells_1d_ * y);
-  if (ycell == n_cells_1d_)
-    ycell -= 1;
-  int zcell = 0;
-  if (n_dim_ == 3) {
-    double z = spos[2] + 0.5;
-    zcell = (int)floor(n_cells_1d_ * z);
-    if (zcell == n_cells_1d_)
-      zcell -= 1;
+  int cell[3] = {0, 0, 0};
+  for (int i = 0; i < N_DIM; ++i) {
+    cell[i] = (int)floor(n_cells_1d_ * (spos[i] + 0.5));
+    if (cell[i] == n_cells_1d_)
+      cell[i] -= 1;
   }
-  return std::make_tuple(xcell, ycell, zcell);
+  return std::make_tuple(cell[0], cell[1], cell[2]);
 }
 
 void CellList::ClearCellObjects() {
-  Logger::Trace("Clearing cell list objects");
+  LOG_TRACE("Clearing cell list objects");
   int third_dim = (n_dim_ == 3 ? n_cells_1d_ : 1);
   for (int i = 0; i < n_cells_1d_; ++i) {
     for (int j = 0; j < n_cells_1d_; ++j) {
@@ -109,7 +100,7 @@ void CellList::ClearCellObjects() {
 }
 
 void CellList::ClearCellNeighbors() {
-  Logger::Trace("Clearing cell list neighbors");
+  LOG_TRACE("Clearing cell list neighbors");
   int third_dim = (n_dim_ == 3 ? n_cells_1d_ : 1);
   for (int i = 0; i < n_cells_1d_; ++i) {
     for (int j = 0; j < n_cells_1d_; ++j) {
@@ -126,13 +117,22 @@ void CellList::RenewObjectsCells(std::vector<Object *> &objs) {
 }
 
 void CellList::AssignObjectsCells(std::vector<Object *> &objs) {
-  Logger::Debug("Assigning objects to cells");
+  LOG_DEBUG("Assigning objects to cells");
+  if (n_dim_ == 2) {
+    AssignObjectsCells<2>(objs);
+  } else {
+    AssignObjectsCells<3>(objs);
+  }
+}
+
+template <int N_DIM>
+void CellList::AssignObjectsCells(std::vector<Object *> &objs) {
   for (auto obj = objs.begin(); obj != objs.end(); ++obj) {
     int x, y, z;
-    std::tie(x, y, z) = FindCellCoords(**obj);
+    std::tie(x, y, z) = FindCellCoords<N_DIM>(**obj);
 #ifdef TRACE
-    Logger::Trace("Object %d assigned to %s", (*obj)->GetOID(),
-                  cell_[x][y][z].Report().c_str());
+    LOG_TRACE("Object %d assigned to %s", (*obj)->GetOID(),
+              cell_[x][y][z].Report().c_str());
 #endif
     cell_[x][y][z].AddObj(**obj);
   }
@@ -149,10 +149,10 @@ void CellList::AssignCellNeighbors(bool redundancy) {
      useful for quickly determining the potential interactions from a single
      object (ie useful for quick overlap checking of new objects) */
   if (redundancy) {
-    Logger::Debug(
+    LOG_DEBUG(
         "Assigning cell list neighbors with redundant neighbor pairs");
   } else {
-    Logger::Debug("Assigning cell list neighbors");
+    LOG_DEBUG("Assigning cell list neighbors");
   }
   int third_dim = (n_dim_ == 3 ? n_cells_1d_ : 1);
   // Loop through all cells in cell list
@@ -191,8 +191,8 @@ void CellList::AssignCellNeighbors(bool redundancy) {
                 continue;
               }
               c.AddNeighbor(cell_[nx][ny][nz]);
-              Logger::Trace("%s has neighbor %s", c.Report().c_str(),
-                            cell_[nx][ny][nz].Report().c_str());
+              LOG_TRACE("%s has neighbor %s", c.Report().c_str(),
+                        cell_[nx][ny][nz].Report().c_str());
             }
           }
         }
@@ -206,9 +206,10 @@ void CellList::AssignCellNeighbors(bool redundancy) {
 void CellList::PairSingleObject(Object &obj,
                                 std::vector<Interaction> &pair_list) {
   int x, y, z;
-  std::tie(x, y, z) = FindCellCoords(obj);
-  Logger::Trace("Making pairs with single object %d in %s", obj.GetOID(),
-                cell_[x][y][z].Report().c_str());
+  std::tie(x, y, z) =
+      (n_dim_ == 2 ? FindCellCoords<2>(obj) : FindCellCoords<3>(obj));
+  LOG_TRACE("Making pairs with single object %d in %s", obj.GetOID(),
+            cell_[x][y][z].Report().c_str());
   const std::vector<Cell *> neighbors = cell_[x][y][z].GetCellNeighbors();
   cell_[x][y][z].PairSingleObject(obj, pair_list);
   for (auto cell = neighbors.begin(); cell != neighbors.end(); ++cell) {
@@ -14,7 +14,8 @@ private:
   void DeallocateCells();
   void LabelCells();
   void AssignCellNeighbors(bool redundancy=false);
-  xyz_coord FindCellCoords(Object &obj);
+  template <int N_DIM> xyz_coord FindCellCoords(Object &obj);
+  template <int N_DIM> void AssignObjectsCells(std::vector<Object *> &objs);
   void ClearCellNeighbors();
 
 public:
@@ -0,0 +1,253 @@
+#include "checkpoint_writer.hpp"
+#include "simulation_context.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+
+const uint32_t CheckpointWriter::delta_magic_;
+const uint32_t CheckpointWriter::delta_version_;
+const uint32_t CheckpointWriter::block_size_;
+
+CheckpointBuffer::int_type CheckpointBuffer::overflow(int_type c) {
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    data_.push_back(traits_type::to_char_type(c));
+  }
+  return traits_type::not_eof(c);
+}
+
+std::streamsize CheckpointBuffer::xsputn(const char *s, std::streamsize n) {
+  data_.insert(data_.end(), s, s + n);
+  return n;
+}
+
+void CheckpointOutput::Commit() {
+  CheckpointWriter *writer = SimulationContext::Current().checkpoints;
+  if (writer == nullptr) {
+    CheckpointWriter sync_writer;
+    sync_writer.Submit(file_name_, buffer_.GetData());
+    return;
+  }
+  writer->Submit(file_name_, buffer_.GetData());
+}
+
+void CheckpointWriter::Init(bool async, int delta_interval) {
+  Flush();
+  async_ = async;
+  delta_interval_ = delta_interval;
+  bases_.clear();
+}
+
+/* Take over the serialized checkpoint in data and write it, or queue it for
+   the writer thread. While an earlier checkpoint of the same file is still
+   queued, wait for the writer thread to take it, so a slow disk holds back
+   the simulation instead of letting the queue grow without bound. */
+void CheckpointWriter::Submit(std::string file_name, std::vector<char> &data) {
+  Job job;
+  job.file_name = file_name;
+  job.data.swap(data);
+  if (!async_) {
+    Write(job);
+    return;
+  }
+  std::unique_lock<std::mutex> lk(mtx_);
+  if (!writer_.joinable()) {
+    stop_ = false;
+    writer_ = std::thread(&CheckpointWriter::Run, this);
+  }
+  cv_.wait(lk, [this, &file_name] { return !IsQueued(file_name); });
+  jobs_.push_back(std::move(job));
+  lk.unlock();
+  cv_.notify_all();
+}
+
+/* Whether a checkpoint of file_name is waiting in the queue. Called with
+   mtx_ held. */
+bool CheckpointWriter::IsQueued(const std::string &file_name) const {
+  for (auto it = jobs_.begin(); it != jobs_.end(); ++it) {
+    if (it->file_name == file_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CheckpointWriter::Run() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (true) {
+    cv_.wait(lk, [this] { return !jobs_.empty() || stop_; });
+    if (jobs_.empty()) {
+      return;
+    }
+    Job job = std::move(jobs_.front());
+    jobs_.pop_front();
+    lk.unlock();
+    /* Wake a Submit waiting for this file to leave the queue */
+    cv_.notify_all();
+    Write(job);
+    lk.lock();
+  }
+}
+
+/* Wait for all queued checkpoints to be written and stop the writer. Since
+   the owning simulation is the only one submitting, no checkpoint can be
+   queued after the writer thread has been told to stop. */
+void CheckpointWriter::Flush() {
+  if (!writer_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  writer_.join();
+}
+
+void CheckpointWriter::Write(Job &job) {
+  Base &base = bases_[job.file_name];
+  if (delta_interval_ > 1 && !base.data.empty() &&
+      base.n_deltas < delta_interval_ - 1 && WriteDelta(job, base)) {
+    base.n_deltas++;
+    return;
+  }
+  if (!WriteAtomic(job.file_name, job.data.data(), job.data.size())) {
+    return;
+  }
+  if (delta_interval_ > 1) {
+    base.data.swap(job.data);
+    base.hash = Hash(base.data);
+    base.n_deltas = 0;
+  }
+  /* Any delta against the previous full checkpoint is now stale */
+  std::remove(GetDeltaFileName(job.file_name).c_str());
+}
+
+/* Write the checkpoint as the blocks that differ from the base checkpoint.
+   Returns false if the delta would not be much smaller than the checkpoint
+   itself, in which case the full checkpoint is written instead. */
+bool CheckpointWriter::WriteDelta(Job &job, Base &base) {
+  uint64_t size = job.data.size();
+  uint64_t n_blocks = (size + block_size_ - 1) / block_size_;
+  std::vector<char> delta;
+  auto append = [&delta](const void *p, size_t n) {
+    const char *c = static_cast<const char *>(p);
+    delta.insert(delta.end(), c, c + n);
+  };
+  uint64_t n_changed = 0;
+  append(&delta_magic_, sizeof(uint32_t));
+  append(&delta_version_, sizeof(uint32_t));
+  append(&base.hash, sizeof(uint64_t));
+  append(&size, sizeof(uint64_t));
+  append(&block_size_, sizeof(uint32_t));
+  size_t n_changed_pos = delta.size();
+  append(&n_changed, sizeof(uint64_t));
+  for (uint64_t i = 0; i < n_blocks; ++i) {
+    size_t begin = i * block_size_;
+    size_t n = std::min<size_t>(block_size_, size - begin);
+    if (begin + n <= base.data.size() &&
+        std::equal(job.data.begin() + begin, job.data.begin() + begin + n,
+                   base.data.begin() + begin)) {
+      continue;
+    }
+    append(&i, sizeof(uint64_t));
+    append(job.data.data() + begin, n);
+    n_changed++;
+    if (delta.size() > size / 2) {
+      return false;
+    }
+  }
+  std::copy(reinterpret_cast<char *>(&n_changed),
+            reinterpret_cast<char *>(&n_changed) + sizeof(uint64_t),
+            delta.begin() + n_changed_pos);
+  return WriteAtomic(GetDeltaFileName(job.file_name), delta.data(),
+                     delta.size());
+}
+
+/* Write data to file_name.tmp, flush it to disk, and rename it over
+   file_name */
+bool CheckpointWriter::WriteAtomic(std::string file_name, const char *data,
+                                   size_t size) {
+  std::string tmp_name = file_name + ".tmp";
+  FILE *fp = fopen(tmp_name.c_str(), "wb");
+  bool ok = (fp != nullptr);
+  ok = ok && (fwrite(data, 1, size, fp) == size);
+  ok = ok && (fflush(fp) == 0) && (fsync(fileno(fp)) == 0);
+  if (fp != nullptr) {
+    ok = (fclose(fp) == 0) && ok;
+  }
+  ok = ok && (std::rename(tmp_name.c_str(), file_name.c_str()) == 0);
+  if (!ok) {
+    Logger::Warning("Failed to write checkpoint file %s, keeping previous "
+                    "checkpoint",
+                    file_name.c_str());
+    std::remove(tmp_name.c_str());
+  }
+  return ok;
+}
+
+/* 64-bit FNV-1a */
+uint64_t CheckpointWriter::Hash(const std::vector<char> &data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto it = data.begin(); it != data.end(); ++it) {
+    hash ^= (unsigned char)(*it);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/* Read a full checkpoint and apply its delta, if there is a matching one.
+   Returns false if the checkpoint does not exist. */
+bool CheckpointWriter::Load(std::string file_name, std::vector<char> &data) {
+  std::ifstream icheck(file_name, std::ios::in | std::ios::binary);
+  if (!icheck.is_open()) {
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(icheck),
+              std::istreambuf_iterator<char>());
+  icheck.close();
+  std::string delta_name = GetDeltaFileName(file_name);
+  std::ifstream idelta(delta_name, std::ios::in | std::ios::binary);
+  if (!idelta.is_open()) {
+    return true;
+  }
+  uint32_t magic = 0, version = 0, block_size = 0;
+  uint64_t base_hash = 0, size = 0, n_changed = 0;
+  idelta.read(reinterpret_cast<char *>(&magic), sizeof(uint32_t));
+  idelta.read(reinterpret_cast<char *>(&version), sizeof(uint32_t));
+  idelta.read(reinterpret_cast<char *>(&base_hash), sizeof(uint64_t));
+  idelta.read(reinterpret_cast<char *>(&size), sizeof(uint64_t));
+  idelta.read(reinterpret_cast<char *>(&block_size), sizeof(uint32_t));
+  idelta.read(reinterpret_cast<char *>(&n_changed), sizeof(uint64_t));
+  if (!idelta.good() || magic != delta_magic_ || version != delta_version_ ||
+      block_size == 0) {
+    Logger::Warning("Ignoring unreadable checkpoint delta %s",
+                    delta_name.c_str());
+    return true;
+  }
+  if (base_hash != Hash(data)) {
+    LOG_DEBUG("Ignoring stale checkpoint delta %s", delta_name.c_str());
+    return true;
+  }
+  std::vector<char> patched(data);
+  patched.resize(size);
+  for (uint64_t i = 0; i < n_changed; ++i) {
+    uint64_t i_block = 0;
+    idelta.read(reinterpret_cast<char *>(&i_block), sizeof(uint64_t));
+    uint64_t begin = i_block * block_size;
+    if (!idelta.good() || begin >= size) {
+      Logger::Warning("Ignoring corrupt checkpoint delta %s",
+                      delta_name.c_str());
+      return true;
+    }
+    size_t n = std::min<uint64_t>(block_size, size - begin);
+    idelta.read(patched.data() + begin, n);
+  }
+  if (!idelta) {
+    Logger::Warning("Ignoring truncated checkpoint delta %s",
+                    delta_name.c_str());
+    return true;
+  }
+  data.swap(patched);
+  LOG_DEBUG("Applied checkpoint delta %s", delta_name.c_str());
+  return true;
+}
@@ -0,0 +1,144 @@
+#ifndef _SIMCORE_CHECKPOINT_WRITER_H_
+#define _SIMCORE_CHECKPOINT_WRITER_H_
+
+#include "logger.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Stream buffer holding a whole checkpoint in memory, either filled by the
+   WriteCheckpoint functions or loaded from disk for the ReadCheckpoint
+   functions. Also used to pass spec frames to in-situ analysis. */
+class CheckpointBuffer : public std::streambuf {
+private:
+  std::vector<char> data_;
+
+protected:
+  int_type overflow(int_type c);
+  std::streamsize xsputn(const char *s, std::streamsize n);
+
+public:
+  std::vector<char> &GetData() { return data_; }
+  /* Make the buffer contents available for reading */
+  void Rewind() { setg(data_.data(), data_.data(), data_.data() + data_.size()); }
+};
+
+/* Writes checkpoints to disk. Checkpoints are serialized into memory by the
+   simulation and handed to the writer, which writes each one to a temporary
+   file that is then renamed over the previous checkpoint, so a crash while
+   writing never leaves a partially written checkpoint behind.
+
+   Every simulation owns its writer, which CheckpointOutput finds through the
+   current SimulationContext, so simulations running side by side in one
+   process do not share queues, writer threads or delta bases. A writer is
+   only used from the thread of the simulation that owns it.
+
+   With asynchronous checkpoints, writing happens on a background thread.
+   Queued checkpoints are never dropped or replaced, but written in the order
+   they were submitted, so once the writer catches up the checkpoint files of
+   all species and the crosslinks are from the same step. At most one
+   checkpoint of each file is queued at a time; submitting another one waits
+   until the writer thread has taken the queued one.
+
+   With a delta interval N > 1, only every N-th checkpoint of a file is
+   written in full. The others are written next to it as
+   <checkpoint>.delta, holding the blocks that differ from the last full
+   checkpoint along with a hash of that checkpoint:
+
+     uint32 magic, uint32 version, uint64 base_hash, uint64 size,
+     uint32 block_size, uint64 n_blocks,
+     n_blocks x { uint64 block_index, char block[block_size] }
+
+   where the last block of the checkpoint may be shorter than block_size.
+   A delta whose base hash does not match the full checkpoint is ignored,
+   so the pair stays consistent whichever file was renamed last. */
+class CheckpointWriter {
+private:
+  struct Job {
+    std::string file_name;
+    std::vector<char> data;
+  };
+  /* Last full checkpoint written for each file */
+  struct Base {
+    std::vector<char> data;
+    uint64_t hash = 0;
+    int n_deltas = 0;
+  };
+  static const uint32_t delta_magic_ = 0x444B4353; // "SCKD"
+  static const uint32_t delta_version_ = 1;
+  static const uint32_t block_size_ = 256;
+  bool async_ = false;
+  int delta_interval_ = 0;
+  /* Queue of the writer thread, guarded by mtx_ */
+  std::deque<Job> jobs_;
+  bool stop_ = false;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::thread writer_;
+  /* Only used by the thread doing the writing */
+  std::map<std::string, Base> bases_;
+  bool IsQueued(const std::string &file_name) const;
+  void Run();
+  void Write(Job &job);
+  bool WriteDelta(Job &job, Base &base);
+  static bool WriteAtomic(std::string file_name, const char *data,
+                          size_t size);
+  static uint64_t Hash(const std::vector<char> &data);
+
+public:
+  CheckpointWriter() {}
+  CheckpointWriter(const CheckpointWriter &) = delete;
+  CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+  ~CheckpointWriter() { Flush(); }
+  static std::string GetDeltaFileName(std::string file_name) {
+    return file_name + ".delta";
+  }
+  void Init(bool async, int delta_interval);
+  void Submit(std::string file_name, std::vector<char> &data);
+  void Flush();
+  static bool Load(std::string file_name, std::vector<char> &data);
+};
+
+/* A checkpoint being written. Members write to GetStream() as if it were the
+   checkpoint file, and Commit() hands the serialized checkpoint to the
+   CheckpointWriter of the current simulation, or writes it right away if
+   there is none. */
+class CheckpointOutput {
+private:
+  std::string file_name_;
+  CheckpointBuffer buffer_;
+  std::fstream stream_;
+
+public:
+  CheckpointOutput(std::string file_name) : file_name_(file_name) {
+    static_cast<std::ios &>(stream_).rdbuf(&buffer_);
+  }
+  std::fstream &GetStream() { return stream_; }
+  void Commit();
+};
+
+/* A checkpoint loaded into memory, including any delta against it */
+class CheckpointInput {
+private:
+  CheckpointBuffer buffer_;
+  std::fstream stream_;
+  bool is_open_ = false;
+
+public:
+  CheckpointInput(std::string file_name) {
+    is_open_ = CheckpointWriter::Load(file_name, buffer_.GetData());
+    buffer_.Rewind();
+    static_cast<std::ios &>(stream_).rdbuf(&buffer_);
+  }
+  bool IsOpen() const { return is_open_; }
+  std::fstream &GetStream() { return stream_; }
+};
+
+#endif // _SIMCORE_CHECKPOINT_WRITER_H_
@@ -1,6 +1,10 @@
 #include "crosslink.hpp"
 
-Crosslink::Crosslink() : Object() { SetSID(species_id::crosslink); }
+Crosslink::Crosslink() : Object() {
+  SetSID(species_id::crosslink);
+  state_ = bind_state::unbound;
+  needs_unbind_event_ = false;
+}
 
 void Crosslink::Init(MinimumDistance *mindist, LookupTable *lut) {
   mindist_ = mindist;
@@ -20,6 +24,10 @@ void Crosslink::Init(MinimumDistance *mindist, LookupTable *lut) {
   rcapture_ = params_->crosslink.r_capture;
   fdep_factor_ = params_->crosslink.force_dep_factor;
   polar_affinity_ = params_->crosslink.polar_affinity;
+  event_kinetics_ = (params_->crosslink.event_kinetics ? true : false);
+  unbind_event_id_ = -1;
+  unbind_hazard_ = 0;
+  unbind_threshold_ = -1;
   /* TODO generalize crosslinks to more than two anchors */
   Anchor anchor1;
   Anchor anchor2;
@@ -29,7 +37,7 @@ void Crosslink::Init(MinimumDistance *mindist, LookupTable *lut) {
   anchors_[1].Init();
   SetSID(species_id::crosslink);
   SetSingly();
-  Logger::Trace("Initializing crosslink %d with anchors %d and %d", GetOID(),
+  LOG_TRACE("Initializing crosslink %d with anchors %d and %d", GetOID(),
       anchors_[0].GetOID(), anchors_[1].GetOID());
 }
 
@@ -47,13 +55,18 @@ void Crosslink::GetAnchors(std::vector<Object *> &ixors) {
 
 /* Perform kinetic monte carlo step of protein with 1 head attached. */
 void Crosslink::SinglyKMC() {
+  int n_neighbors = anchors_[0].GetNNeighbors();
+  /* With event-driven kinetics, unbinding is handled by the crosslink
+     scheduler, so there is nothing to do unless we have neighbors to bind to */
+  if (event_kinetics_ && n_neighbors == 0) {
+    return;
+  }
   double roll = gsl_rng_uniform_pos(rng_.r);
   int head_bound = 0;
   // Set up KMC objects and calculate probabilities
-  double unbind_prob = k_off_ * delta_;
+  double unbind_prob = (event_kinetics_ ? 0 : k_off_ * delta_);
   /* Must populate filter with 1 for every neighbor, since KMC
   expects a mask. We already guarantee uniqueness, so we won't overcount. */
-  int n_neighbors = anchors_[0].GetNNeighbors();
   std::vector<int> kmc_filter(n_neighbors, 1);
   /* Initialize KMC calculation */
   KMC<Object> kmc_bind(anchors_[0].pos, n_neighbors, rcapture_, delta_, lut_);
@@ -77,7 +90,7 @@ void Crosslink::SinglyKMC() {
     // Unbind bound head
     anchors_[0].Unbind();
     SetUnbound();
-    Logger::Trace("Crosslink %d came unbound", GetOID());
+    LOG_TRACE("Crosslink %d came unbound", GetOID());
   } else if (head_activate == 1) {
     // Bind unbound head
     /* Position on rod where protein will bind with respect to center of rod,
@@ -104,7 +117,7 @@ void Crosslink::SinglyKMC() {
     }
     anchors_[1].AttachObjLambda(bind_obj, bind_lambda);
     SetDoubly();
-    Logger::Trace("Crosslink %d became doubly bound to obj %d", GetOID(),
+    LOG_TRACE("Crosslink %d became doubly bound to obj %d", GetOID(),
         bind_obj->GetOID());
   }
   kmc_filter.clear();
@@ -118,18 +131,35 @@ void Crosslink::DoublyKMC() {
   tether_stretch = (tether_stretch > 0 ? tether_stretch : 0);
   double fdep = fdep_factor_ * 0.5 * k_spring_ * SQR(tether_stretch);
   double unbind_prob = k_off_d_ * delta_ * exp(fdep);
-  double roll = gsl_rng_uniform_pos(rng_.r);
-  // Each head has an equal likelihood to unbind (half the total probability)
-  int head_activate =
-      choose_kmc_double(0.5 * unbind_prob, 0.5 * unbind_prob, roll);
+  int head_activate = -1;
+  if (event_kinetics_) {
+    /* The unbinding rate changes with the tether stretch, so rather than
+       scheduling a fixed event time, accumulate the integrated unbinding
+       hazard and unbind once it exceeds an exponentially distributed
+       threshold (next reaction method with a time-dependent rate). */
+    if (unbind_threshold_ < 0) {
+      unbind_threshold_ = gsl_ran_exponential(rng_.r, 1.0);
+    }
+    unbind_hazard_ += unbind_prob;
+    if (unbind_hazard_ < unbind_threshold_) {
+      return;
+    }
+    // Each head has an equal likelihood to unbind
+    head_activate = (gsl_rng_uniform_pos(rng_.r) < 0.5 ? 0 : 1);
+  } else {
+    double roll = gsl_rng_uniform_pos(rng_.r);
+    // Each head has an equal likelihood to unbind (half the total probability)
+    head_activate =
+        choose_kmc_double(0.5 * unbind_prob, 0.5 * unbind_prob, roll);
+  }
   if (head_activate == 0) {
-    Logger::Trace("Doubly-bound crosslink %d came unbound from %d", GetOID(),
+    LOG_TRACE("Doubly-bound crosslink %d came unbound from %d", GetOID(),
         anchors_[0].GetBoundOID());
     anchors_[0] = anchors_[1];
     anchors_[1].Unbind();
     SetSingly();
   } else if (head_activate == 1) {
-    Logger::Trace("Doubly-bound crosslink %d came unbound from %d", GetOID(),
+    LOG_TRACE("Doubly-bound crosslink %d came unbound from %d", GetOID(),
         anchors_[1].GetBoundOID());
     anchors_[1].Unbind();
     SetSingly();
@@ -160,9 +190,16 @@ void Crosslink::UpdateAnchorsToMesh() {
   anchors_[1].UpdateAnchorPositionToMesh();
 }
 
-void Crosslink::UpdateAnchorPositions() {
-  anchors_[0].UpdatePosition();
-  anchors_[1].UpdatePosition();
+/* Anchors occupy two consecutive slots of the motion kernel, starting at
+   i_slot */
+void Crosslink::LoadAnchorMotion(AnchorMotion &motion, int i_slot) {
+  anchors_[0].LoadMotion(motion, i_slot);
+  anchors_[1].LoadMotion(motion, i_slot + 1);
+}
+
+void Crosslink::UpdateAnchorPositions(AnchorMotion const &motion, int i_slot) {
+  anchors_[0].StoreMotion(motion, i_slot);
+  anchors_[1].StoreMotion(motion, i_slot + 1);
 }
 
 void Crosslink::ApplyTetherForces() {
@@ -181,9 +218,11 @@ void Crosslink::UpdateCrosslinkForces() {
   CalculateTetherForces();
 }
 
-void Crosslink::UpdateCrosslinkPositions() {
-  /* Have anchors diffuse/walk along mesh */
-  UpdateAnchorPositions();
+void Crosslink::UpdateCrosslinkPositions(AnchorMotion const &motion,
+                                         int i_slot) {
+  /* Have anchors diffuse/walk along mesh, using the results of the anchor
+     motion kernel */
+  UpdateAnchorPositions(motion, i_slot);
   /* Check if an anchor became unbound do to diffusion, etc */
   UpdateXlinkState();
   /* Check for binding/unbinding events using KMC */
@@ -279,9 +318,23 @@ void Crosslink::Draw(std::vector<graph_struct *> *graph_array) {
   }
 }
 
-void Crosslink::SetDoubly() { state_ = bind_state::doubly; }
+void Crosslink::SetDoubly() {
+  /* Entering the doubly-bound state starts a new unbinding waiting time */
+  if (state_ != +bind_state::doubly) {
+    unbind_hazard_ = 0;
+    unbind_threshold_ = -1;
+  }
+  state_ = bind_state::doubly;
+}
 
-void Crosslink::SetSingly() { state_ = bind_state::singly; }
+void Crosslink::SetSingly() {
+  /* Entering the singly-bound state starts a new unbinding waiting time, which
+     needs to be scheduled if we are using event-driven kinetics */
+  if (state_ != +bind_state::singly) {
+    needs_unbind_event_ = true;
+  }
+  state_ = bind_state::singly;
+}
 
 void Crosslink::SetUnbound() { state_ = bind_state::unbound; }
 
@@ -291,6 +344,26 @@ bool Crosslink::IsSingly() { return state_ == +bind_state::singly; }
 
 bool Crosslink::IsUnbound() { return state_ == +bind_state::unbound; }
 
+/* Unbind the remaining head of a singly-bound crosslink, used when a scheduled
+   unbinding event comes due */
+void Crosslink::UnbindSingly() {
+  if (!IsSingly()) {
+    Logger::Error("UnbindSingly called on crosslink that was not singly bound");
+  }
+  anchors_[0].Unbind();
+  SetUnbound();
+  LOG_TRACE("Crosslink %d came unbound", GetOID());
+}
+
+bool Crosslink::NeedsUnbindEvent() { return needs_unbind_event_; }
+
+void Crosslink::SetUnbindEvent(int event_id) {
+  unbind_event_id_ = event_id;
+  needs_unbind_event_ = false;
+}
+
+int const Crosslink::GetUnbindEventID() { return unbind_event_id_; }
+
 void Crosslink::WriteSpec(std::fstream &ospec) {
   if (IsUnbound()) {
     Logger::Error("Unbound crosslink tried to WriteSpec!");
@@ -337,6 +410,12 @@ void Crosslink::WriteCheckpoint(std::fstream &ocheck) {
   ocheck.write(reinterpret_cast<char *>(&rng_size), sizeof(size_t));
   ocheck.write(reinterpret_cast<char *>(rng_state), rng_size);
   WriteSpec(ocheck);
+  /* Store the bond each anchor is attached to, so that anchors can be
+     reattached directly on reload */
+  for (int i = 0; i < 2; ++i) {
+    int bond_number = anchors_[i].GetBondNumber();
+    ocheck.write(reinterpret_cast<char *>(&bond_number), sizeof(int));
+  }
 }
 
 void Crosslink::ReadCheckpoint(std::fstream &icheck) {
@@ -347,8 +426,22 @@ void Crosslink::ReadCheckpoint(std::fstream &icheck) {
   icheck.read(reinterpret_cast<char *>(&rng_size), sizeof(size_t));
   icheck.read(reinterpret_cast<char *>(rng_state), rng_size);
   ReadSpec(icheck);
-  Logger::Trace("Reloading anchor from checkpoint with mid %d", anchors_[0].GetMeshID());
+  for (int i = 0; i < 2; ++i) {
+    int bond_number = -1;
+    icheck.read(reinterpret_cast<char *>(&bond_number), sizeof(int));
+    anchors_[i].SetReloadBondNumber(bond_number);
+  }
+  LOG_TRACE("Reloading anchor from checkpoint with mid %d", anchors_[0].GetMeshID());
   if (IsDoubly()) {
-    Logger::Trace("Reloading anchor from checkpoint with mid %d", anchors_[1].GetMeshID());
+    LOG_TRACE("Reloading anchor from checkpoint with mid %d", anchors_[1].GetMeshID());
+  }
+}
+
+/* Binding and unbinding probabilities are recomputed from delta_ on every
+   update, so only the anchors keep quantities derived from it */
+void Crosslink::SetTimeStep(double delta) {
+  Object::SetTimeStep(delta);
+  for (auto anchor = anchors_.begin(); anchor != anchors_.end(); ++anchor) {
+    anchor->SetTimeStep(delta);
   }
 }
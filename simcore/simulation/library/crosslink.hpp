@@ -31,21 +31,29 @@ private:
   double tether_force_;
   double fdep_factor_;
   double polar_affinity_;
+  /* Event-driven kinetics bookkeeping */
+  bool event_kinetics_;
+  bool needs_unbind_event_;
+  int unbind_event_id_;
+  double unbind_hazard_;
+  double unbind_threshold_;
   std::vector<Anchor> anchors_;
   void CalculateTetherForces();
   void CalculateBinding();
   void SinglyKMC();
   void DoublyKMC();
   void UpdateAnchorsToMesh();
-  void UpdateAnchorPositions();
+  void UpdateAnchorPositions(AnchorMotion const &motion, int i_slot);
   void UpdateXlinkState();
+  UNIT_TESTER;
 
 public:
   Crosslink();
   void Init(MinimumDistance *mindist, LookupTable *lut);
   void AttachObjRandom(Object *obj);
   void UpdateCrosslinkForces();
-  void UpdateCrosslinkPositions();
+  void LoadAnchorMotion(AnchorMotion &motion, int i_slot);
+  void UpdateCrosslinkPositions(AnchorMotion const &motion, int i_slot);
   void GetAnchors(std::vector<Object *> &ixors);
   void GetInteractors(std::vector<Object *> &ixors);
   void Draw(std::vector<graph_struct *> *graph_array);
@@ -55,6 +63,10 @@ public:
   bool IsDoubly();
   bool IsUnbound();
   bool IsSingly();
+  void UnbindSingly();
+  bool NeedsUnbindEvent();
+  void SetUnbindEvent(int event_id);
+  int const GetUnbindEventID();
   void UpdatePosition();
   void WriteSpec(std::fstream &ospec);
   void WriteCheckpoint(std::fstream &ocheck);
@@ -63,6 +75,7 @@ public:
   void ClearNeighbors();
   void ZeroForce();
   void ApplyTetherForces();
+  void SetTimeStep(double delta);
 };
 
 #endif
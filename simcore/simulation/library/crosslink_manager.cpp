@@ -17,9 +17,41 @@ void CrosslinkManager::Init(system_parameters *params, space_struct *space,
   checkpoint_flag_ = params_->crosslink.checkpoint_flag;
   spec_flag_ = params_->crosslink.spec_flag;
   update_ = false;
+  event_kinetics_ = (params_->crosslink.event_kinetics ? true : false);
+  next_event_id_ = 0;
+  /* Per-update probabilities are k*delta, so the kinetic clock advances by
+     delta on every crosslink update */
+  delta_ = params_->delta;
+  scheduler_.Init(delta_);
+  anchor_motion_.Init(delta_);
+  /* Draw binding decisions from the seed chain of the current simulation */
+  rng_ = RNG();
   /* TODO Lookup table only works for filament objects. Generalize? */
-  lut_.Init(params_->crosslink.k_spring / 2, params_->crosslink.rest_length,
-            params_->filament.diameter);
+  lut_ = GetLookupTable(params_->crosslink.k_spring / 2,
+                        params_->crosslink.rest_length,
+                        params_->filament.diameter);
+}
+
+/* Lookup tables are read-only once built and only depend on the tether and
+   filament parameters, so simulations running in the same process share
+   them */
+std::shared_ptr<LookupTable>
+CrosslinkManager::GetLookupTable(double k_spring, double rest_length,
+                                 double diameter) {
+  static std::mutex mtx;
+  static std::map<std::tuple<double, double, double>,
+                  std::weak_ptr<LookupTable>>
+      tables;
+  std::lock_guard<std::mutex> lk(mtx);
+  std::weak_ptr<LookupTable> &cached =
+      tables[std::make_tuple(k_spring, rest_length, diameter)];
+  std::shared_ptr<LookupTable> lut = cached.lock();
+  if (!lut) {
+    lut = std::make_shared<LookupTable>();
+    lut->Init(k_spring, rest_length, diameter);
+    cached = lut;
+  }
+  return lut;
 }
 
 /* Keep track of volume of objects in the system. Affects the
@@ -31,6 +63,18 @@ void CrosslinkManager::UpdateObjsVolume() {
   }
 }
 
+/* Change the time step between crosslink updates. Scheduled events keep
+   their kinetic times, and the clock advances by the new step from the next
+   update on. */
+void CrosslinkManager::SetTimeStep(double delta) {
+  delta_ = delta;
+  scheduler_.SetTau(delta);
+  anchor_motion_.Init(delta);
+  for (auto xlink = xlinks_.begin(); xlink != xlinks_.end(); ++xlink) {
+    xlink->SetTimeStep(delta);
+  }
+}
+
 /* Whether to reinsert anchors into the interactors list */
 bool CrosslinkManager::CheckUpdate() {
   if (update_) {
@@ -44,8 +88,19 @@ void CrosslinkManager::CalculateBindingFree() {
   /* Check crosslink binding */
   UpdateObjsVolume();
   double concentration = xlink_concentration_ - n_xlinks_ / space_->volume;
-  if (gsl_rng_uniform_pos(rng_.r) <=
-      concentration * obj_volume_ * k_on_ * params_->delta) {
+  double bind_prob = concentration * obj_volume_ * k_on_ * delta_;
+  if (event_kinetics_) {
+    /* Tau-leap: allow any number of binding events during this update */
+    int n_bind = CrosslinkScheduler::TauLeap(bind_prob, rng_.r);
+    for (int i = 0; i < n_bind; ++i) {
+      BindCrosslink();
+    }
+    if (n_bind > 0) {
+      update_ = true;
+    }
+    return;
+  }
+  if (gsl_rng_uniform_pos(rng_.r) <= bind_prob) {
     /* Create a new crosslink and bind an anchor to a random object
      * in the system */
     BindCrosslink();
@@ -62,7 +117,7 @@ Object *CrosslinkManager::GetRandomObject() {
     vol += (*obj)->GetVolume();
     if (vol > roll) {
 #ifdef TRACE
-      Logger::Trace("Binding free crosslink to random object: xl %d -> obj %d",
+      LOG_TRACE("Binding free crosslink to random object: xl %d -> obj %d",
           xlinks_.back().GetOID(), (*obj)->GetOID());
 #endif
       return *obj;
@@ -77,13 +132,66 @@ void CrosslinkManager::BindCrosslink() {
    * initially be singly-bound. */
   Crosslink xl;
   xlinks_.push_back(xl);
-  xlinks_.back().Init(mindist_, &lut_);
+  xlinks_.back().Init(mindist_, lut_.get());
   xlinks_.back().AttachObjRandom(GetRandomObject());
+  if (event_kinetics_) {
+    ScheduleUnbindEvent(xlinks_.size() - 1);
+  }
   /* Keep track of bound bound anchors, bound crosslinks, and
    * concentration of free crosslinks */
   n_xlinks_++;
 }
 
+/* Sample the unbinding time of a newly singly-bound crosslink and add it to
+   the scheduler. Every scheduled event gets a unique id, so events belonging
+   to crosslinks that have since changed state are recognized as stale. */
+void CrosslinkManager::ScheduleUnbindEvent(int i_xlink) {
+  int event_id = next_event_id_++;
+  xlinks_[i_xlink].SetUnbindEvent(event_id);
+  event_index_[event_id] = i_xlink;
+  scheduler_.Schedule(event_id, k_off_, rng_.r);
+}
+
+/* Rebuild the event index after crosslinks were removed, and schedule
+   unbinding events for crosslinks that entered the singly-bound state during
+   this update */
+void CrosslinkManager::ScheduleUnbindEvents() {
+  event_index_.clear();
+  for (int i = 0; i < xlinks_.size(); ++i) {
+    if (!xlinks_[i].IsSingly()) {
+      continue;
+    }
+    if (xlinks_[i].NeedsUnbindEvent()) {
+      ScheduleUnbindEvent(i);
+    } else {
+      event_index_[xlinks_[i].GetUnbindEventID()] = i;
+    }
+  }
+  LOG_TRACE("Crosslink scheduler has %d pending events",
+            scheduler_.GetNEvents());
+}
+
+/* Unbind singly-bound crosslinks whose scheduled unbinding events came due */
+void CrosslinkManager::ProcessUnbindEvents() {
+  scheduler_.Advance();
+  std::vector<int> due_ids;
+  scheduler_.PopDueEvents(due_ids);
+  for (auto id = due_ids.begin(); id != due_ids.end(); ++id) {
+    auto it = event_index_.find(*id);
+    if (it == event_index_.end()) {
+      continue;
+    }
+    Crosslink *xlink = &xlinks_[it->second];
+    event_index_.erase(it);
+    /* Skip stale events of crosslinks that have since changed state */
+    if (!xlink->IsSingly() || xlink->GetUnbindEventID() != *id) {
+      continue;
+    }
+    xlink->UnbindSingly();
+    update_ = true;
+  }
+}
+
 /* Return singly-bound anchors, for finding neighbors to bind to */
 void CrosslinkManager::GetInteractors(std::vector<Object *> &ixors) {
   for (auto xlink = xlinks_.begin(); xlink != xlinks_.end(); ++xlink) {
@@ -124,10 +232,17 @@ void CrosslinkManager::UpdateBoundCrosslinks() {
   ApplyCrosslinkTetherForces();
   /* Update anchor positions from diffusion, walking */
   UpdateBoundCrosslinkPositions();
+  /* Unbind crosslinks with unbinding events that came due */
+  if (event_kinetics_) {
+    ProcessUnbindEvents();
+  }
   /* Remove crosslinks that came unbound */
   xlinks_.erase(std::remove_if(xlinks_.begin(), xlinks_.end(),
                                [](Crosslink x) { return x.IsUnbound(); }),
                 xlinks_.end());
+  if (event_kinetics_) {
+    ScheduleUnbindEvents();
+  }
   /* Get the number of bound crosslinks so we know what the current
      concentration of free crosslinks is */
   n_xlinks_ = xlinks_.size();
@@ -179,7 +294,24 @@ void CrosslinkManager::UpdateBoundCrosslinkForces() {
   }
 #endif
 }
+/* Advance bound anchors along their meshes in SoA batches. Every crosslink
+   owns two consecutive kernel slots, one per anchor. */
+void CrosslinkManager::UpdateAnchorMotion() {
+  int n_xlinks = xlinks_.size();
+  anchor_motion_.Resize(2 * n_xlinks);
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < n_xlinks; ++i) {
+    xlinks_[i].LoadAnchorMotion(anchor_motion_, 2 * i);
+  }
+  anchor_motion_.Advance();
+}
+
 void CrosslinkManager::UpdateBoundCrosslinkPositions() {
+  /* Diffuse/walk anchors first, crosslinks pick up their new anchor positions
+     below */
+  UpdateAnchorMotion();
 #ifdef ENABLE_OPENMP
   int max_threads = omp_get_max_threads();
   xlink_chunk_vector chunks;
@@ -199,7 +331,8 @@ void CrosslinkManager::UpdateBoundCrosslinkPositions() {
     for (int i = 0; i < max_threads; ++i) {
       for (auto xlink = chunks[i].first; xlink != chunks[i].second; ++xlink) {
         bool init_state = xlink->IsSingly();
-        xlink->UpdateCrosslinkPositions();
+        xlink->UpdateCrosslinkPositions(anchor_motion_,
+                                        2 * (xlink - xlinks_.begin()));
         /* Xlink is no longer bound, return to solution */
         if (xlink->IsUnbound()) {
           update_ = true;
@@ -215,7 +348,8 @@ void CrosslinkManager::UpdateBoundCrosslinkPositions() {
   for (xlink_iterator xlink = xlinks_.begin(); xlink != xlinks_.end();
        ++xlink) {
     bool init_state = xlink->IsSingly();
-    xlink->UpdateCrosslinkPositions();
+    xlink->UpdateCrosslinkPositions(anchor_motion_,
+                                    2 * (xlink - xlinks_.begin()));
     /* Xlink is no longer bound, return to solution */
     if (xlink->IsUnbound()) {
       update_ = true;
@@ -228,7 +362,16 @@ void CrosslinkManager::UpdateBoundCrosslinkPositions() {
 #endif
 }
 
-void CrosslinkManager::Clear() { xlinks_.clear(); }
+void CrosslinkManager::Clear() {
+  AsyncOutput::Detach(ospec_file_);
+  SpecCompression::Detach(ospec_file_);
+  SpecCompression::Detach(ispec_file_);
+  ospec_index_.Close();
+  ispec_index_.Close();
+  xlinks_.clear();
+  event_index_.clear();
+  scheduler_.Clear();
+}
 
 void CrosslinkManager::Draw(std::vector<graph_struct *> *graph_array) {
   for (auto it = xlinks_.begin(); it != xlinks_.end(); ++it) {
@@ -248,39 +391,44 @@ void CrosslinkManager::AddNeighborToAnchor(Object *anchor, Object *neighbor) {
 void CrosslinkManager::WriteSpecs() {
   /* Write the vector sizes, singly then doubly */
   n_xlinks_ = xlinks_.size();
+  ospec_index_.AddFrame(ospec_file_.tellp());
   ospec_file_.write(reinterpret_cast<char *>(&n_xlinks_), sizeof(int));
 
   /* Write individual crosslink specs, first singly then doubly */
   for (auto it = xlinks_.begin(); it != xlinks_.end(); ++it) {
     it->WriteSpec(ospec_file_);
   }
+  /* End of frame for compressed and asynchronous spec writers */
+  ospec_file_.flush();
 }
 
 void CrosslinkManager::ReadSpecs() {
   if (ispec_file_.eof()) {
     Logger::Info("EOF reached for spec file in CrosslinkManager");
-    early_exit = true;
+    SimulationContext::Current().early_exit = true;
     return;
   }
   if (!ispec_file_.is_open()) {
     Logger::Warning("ERROR. Spec file unexpectedly not open! Exiting early.");
-    early_exit = true;
+    SimulationContext::Current().early_exit = true;
     return;
   }
   n_xlinks_ = -1;
+  std::streamoff offset = ispec_file_.tellg();
   ispec_file_.read(reinterpret_cast<char *>(&n_xlinks_), sizeof(int));
   /* For some reason, we can't catch the EOF above. If size == -1 still, then
      we caught a EOF here */
   if (n_xlinks_ == -1) {
     Logger::Info("EOF reached for spec file in CrosslinkManager");
-    early_exit = true;
+    SimulationContext::Current().early_exit = true;
     return;
   }
+  ispec_index_.RecordFrame(offset);
   if (n_xlinks_ == 0) {
     xlinks_.clear();
   } else if (n_xlinks_ != xlinks_.size()) {
     Crosslink xlink;
-    xlink.Init(mindist_, &lut_);
+    xlink.Init(mindist_, lut_.get());
     xlinks_.resize(n_xlinks_, xlink);
   }
   for (auto it = xlinks_.begin(); it != xlinks_.end(); ++it) {
@@ -289,11 +437,13 @@ void CrosslinkManager::ReadSpecs() {
 }
 
 void CrosslinkManager::WriteCheckpoints() {
-  /* Try to open the file */
-  std::fstream ocheck_file(checkpoint_file_, std::ios::out | std::ios::binary);
-  if (!ocheck_file.is_open()) {
-    Logger::Error("Output file %s did not open\n", checkpoint_file_.c_str());
-  }
+  /* Serialize the checkpoint, it is written to disk by CheckpointWriter */
+  CheckpointOutput ocheck(checkpoint_file_);
+  std::fstream &ocheck_file = ocheck.GetStream();
+  int magic = checkpoint_magic_;
+  int version = checkpoint_version_;
+  ocheck_file.write(reinterpret_cast<char *>(&magic), sizeof(int));
+  ocheck_file.write(reinterpret_cast<char *>(&version), sizeof(int));
 
   /* Write RNG state */
   long seed = rng_.GetSeed();
@@ -312,16 +462,28 @@ void CrosslinkManager::WriteCheckpoints() {
     it->WriteCheckpoint(ocheck_file);
   }
 
-  /* Close the file */
-  ocheck_file.close();
+  ocheck.Commit();
 }
 
 void CrosslinkManager::ReadCheckpoints() {
   /* Try to open the file */
-  std::fstream icheck_file(checkpoint_file_, std::ios::in | std::ios::binary);
-  if (!icheck_file.is_open()) {
+  CheckpointInput icheck(checkpoint_file_);
+  if (!icheck.IsOpen()) {
     Logger::Error("Output file %s did not open\n", checkpoint_file_.c_str());
   }
+  std::fstream &icheck_file = icheck.GetStream();
+  int magic = -1, version = -1;
+  icheck_file.read(reinterpret_cast<char *>(&magic), sizeof(int));
+  icheck_file.read(reinterpret_cast<char *>(&version), sizeof(int));
+  if (magic != checkpoint_magic_) {
+    Logger::Error("Crosslink checkpoint %s was written by an older version of "
+                  "simcore and cannot be reloaded",
+                  checkpoint_file_.c_str());
+  }
+  if (version != checkpoint_version_) {
+    Logger::Error("Crosslink checkpoint %s has unsupported version %d",
+                  checkpoint_file_.c_str(), version);
+  }
 
   /* Read RNG state */
   void *rng_state = gsl_rng_state(rng_.r);
@@ -337,16 +499,14 @@ void CrosslinkManager::ReadCheckpoints() {
   /* Prepare the xlink vectors */
   Crosslink xlink;
   xlinks_.push_back(xlink);
-  xlinks_.back().Init(mindist_, &lut_);
-  //xlink.Init(mindist_, &lut_);
+  xlinks_.back().Init(mindist_, lut_.get());
+  //xlink.Init(mindist_, lut_.get());
   xlinks_.resize(n_xlinks_, xlinks_[0]);
 
   /* Read the crosslink checkpoints */
   for (auto it = xlinks_.begin(); it != xlinks_.end(); ++it) {
     it->ReadCheckpoint(icheck_file);
   }
-  /* Close the file */
-  icheck_file.close();
   rng_.SetSeed(seed);
 }
 
@@ -367,6 +527,18 @@ void CrosslinkManager::InitSpecFile() {
   ospec_file_.write(reinterpret_cast<char *>(&params_->crosslink.n_spec),
                     sizeof(int));
   ospec_file_.write(reinterpret_cast<char *>(&params_->delta), sizeof(double));
+  if (params_->spec_compression) {
+    /* Compressed spec files are read sequentially and not indexed */
+    SpecCompression::AttachOutput(ospec_file_, params_->spec_tolerance);
+    std::remove(SpecIndex::GetIndexFileName(spec_file_name).c_str());
+  } else {
+    ospec_index_.InitOutput(spec_file_name, params_->n_dim, params_->delta,
+                            params_->n_steps, params_->crosslink.n_spec,
+                            "crosslink");
+  }
+  if (params_->async_output) {
+    AsyncOutput::Attach(ospec_file_);
+  }
 }
 
 void CrosslinkManager::InitCheckpoints() {
@@ -374,6 +546,7 @@ void CrosslinkManager::InitCheckpoints() {
 }
 
 bool CrosslinkManager::InitSpecFileInputFromFile(std::string spec_file_name) {
+  SpecCompression::Detach(ispec_file_);
   ispec_file_.open(spec_file_name, std::ios::in | std::ios::binary);
   if (!ispec_file_.is_open()) {
     return false;
@@ -391,10 +564,47 @@ bool CrosslinkManager::InitSpecFileInputFromFile(std::string spec_file_name) {
                     spec_file_name.c_str(), n_steps, params_->n_steps, n_spec,
                     params_->crosslink.n_spec, delta, params_->delta);
   }
+  ispec_index_.Close();
+  if (!SpecCompression::AttachInput(ispec_file_)) {
+    ispec_index_.InitInput(spec_file_name, params_->n_dim, params_->delta,
+                           n_steps, n_spec, "crosslink");
+  }
   ReadSpecs();
   return true;
 }
 
+/* Read spec frame i_frame directly, using the spec index. Returns false if
+   the frame is not indexed. */
+bool CrosslinkManager::SeekSpecFrame(int i_frame) {
+  if (!ispec_file_.is_open() || !ispec_index_.SeekFrame(ispec_file_, i_frame)) {
+    return false;
+  }
+  ReadSpecs();
+  return true;
+}
+
+/* Last processing step whose spec frame can be read by seeking, or -1 if the
+   spec file is not indexed */
+int CrosslinkManager::GetLastIndexedStep() {
+  if (!spec_flag_) {
+    return INT_MAX;
+  }
+  int n_frames = ispec_index_.GetNFrames();
+  if (n_frames == 0) {
+    return -1;
+  }
+  return (n_frames - 1) * n_spec_;
+}
+
+/* Read the spec frame that sequential reading would have reached by
+   processing step i_step */
+bool CrosslinkManager::SeekInputs(int i_step) {
+  if (!spec_flag_) {
+    return true;
+  }
+  return SeekSpecFrame(i_step / n_spec_);
+}
+
 void CrosslinkManager::InitSpecFileInput() {
   std::string spec_file_name = params_->run_name + "_crosslink.spec";
   if (!InitSpecFileInputFromFile(spec_file_name)) {
@@ -436,11 +646,11 @@ void CrosslinkManager::InitOutputs(bool reading_inputs, bool reduce_flag,
     InitOutputFiles();
   }
 }
-void CrosslinkManager::WriteOutputs() {
-  if (spec_flag_ && (params_->i_step % n_spec_ == 0)) {
+void CrosslinkManager::WriteOutputs(int i_step) {
+  if (spec_flag_ && (i_step % n_spec_ == 0)) {
     WriteSpecs();
   }
-  if (checkpoint_flag_ && (params_->i_step % n_checkpoint_ == 0)) {
+  if (checkpoint_flag_ && (i_step % n_checkpoint_ == 0)) {
     WriteCheckpoints();
   }
 }
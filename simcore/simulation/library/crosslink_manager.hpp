@@ -1,7 +1,16 @@
 #ifndef _SIMCORE_CROSSLINK_MANAGER_H_
 #define _SIMCORE_CROSSLINK_MANAGER_H_
 
+#include "async_output.hpp"
+#include "checkpoint_writer.hpp"
 #include "crosslink.hpp"
+#include "crosslink_scheduler.hpp"
+#include "spec_compression.hpp"
+#include "spec_index.hpp"
+#include <map>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
 #ifdef ENABLE_OPENMP
 #include "omp.h"
 #endif
@@ -13,14 +22,21 @@ typedef std::vector<Crosslink>::iterator xlink_iterator;
 
 class CrosslinkManager {
 private:
+  /* Crosslink checkpoints start with a magic number and version, since the
+     layout of each crosslink changed to hold the bonds of its anchors */
+  static const int checkpoint_magic_ = 0x4B505843; // "CXPK"
+  static const int checkpoint_version_ = 2;
   bool update_;
+  bool event_kinetics_;
   int n_xlinks_;
+  int next_event_id_;
   int n_spec_;
   int n_checkpoint_;
   int spec_flag_;
   int checkpoint_flag_;
   MinimumDistance *mindist_;
   std::string checkpoint_file_;
+  double delta_;
   double obj_volume_;
   double xlink_concentration_;
   double k_on_;
@@ -29,18 +45,30 @@ private:
   double k_off_d_;
   RNG rng_;
   space_struct *space_;
-  LookupTable lut_;
+  std::shared_ptr<LookupTable> lut_;
+  CrosslinkScheduler scheduler_;
+  AnchorMotion anchor_motion_;
+  /* Maps scheduled unbinding event ids to crosslink indices in xlinks_ */
+  std::unordered_map<int, int> event_index_;
   std::vector<Crosslink> xlinks_;
   std::vector<Object *> *objs_;
   std::fstream ispec_file_;
   std::fstream ospec_file_;
+  SpecIndex ispec_index_;
+  SpecIndex ospec_index_;
   system_parameters *params_;
+  static std::shared_ptr<LookupTable>
+  GetLookupTable(double k_spring, double rest_length, double diameter);
   void CalculateBindingFree();
   void BindCrosslink();
   void UpdateBoundCrosslinks();
   void UpdateBoundCrosslinkForces();
   void UpdateBoundCrosslinkPositions();
+  void UpdateAnchorMotion();
   void ApplyCrosslinkTetherForces();
+  void ScheduleUnbindEvent(int i_xlink);
+  void ScheduleUnbindEvents();
+  void ProcessUnbindEvents();
   Object *GetRandomObject();
 
   /* IO Functions */
@@ -52,8 +80,10 @@ private:
   void InitSpecFile();
   void InitCheckpoints();
   bool InitSpecFileInputFromFile(std::string spec_file_name);
+  bool SeekSpecFrame(int i_frame);
   void InitSpecFileInput();
   void LoadFromCheckpoints();
+  UNIT_TESTER;
 
 public:
   void Init(system_parameters *params, space_struct *space,
@@ -66,11 +96,14 @@ public:
   void Draw(std::vector<graph_struct *> *graph_array);
   void BindCrosslinkObj(Object *obj);
   void AddNeighborToAnchor(Object *anchor, Object *neighbor);
-  void WriteOutputs();
+  void SetTimeStep(double delta);
+  void WriteOutputs(int i_step);
   void ReadInputs();
   void InitOutputs(bool reading_inputs = false, bool reduce_flag = false,
                    bool with_reloads = false);
   void GetAnchorInteractors(std::vector<Object *> &ixors);
+  int GetLastIndexedStep();
+  bool SeekInputs(int i_step);
 };
 
 #endif
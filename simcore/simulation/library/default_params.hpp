@@ -34,6 +34,7 @@
   default_config["filament"]["f_grow_to_pause"] = "0.0";
   default_config["filament"]["f_grow_to_shrink"] = "0.00554";
   default_config["filament"]["metric_forces"] = "1";
+  default_config["filament"]["implicit_bending"] = "0";
   default_config["filament"]["v_poly"] = "0.44";
   default_config["filament"]["v_depoly"] = "0.793";
   default_config["filament"]["theta_analysis"] = "0";
@@ -148,6 +149,7 @@
   default_config["crosslink"]["tether_color"] = "3.1416";
   default_config["crosslink"]["end_pausing"] = "0";
   default_config["crosslink"]["r_capture"] = "5";
+  default_config["crosslink"]["event_kinetics"] = "0";
   default_config["seed"] = "7859459105545";
   default_config["n_runs"] = "1";
   default_config["n_random"] = "1";
@@ -161,6 +163,12 @@
   default_config["delta"] = "0.001";
   default_config["cell_length"] = "10";
   default_config["n_update_cells"] = "0";
+  default_config["n_respa"] = "1";
+  default_config["adaptive_delta"] = "0";
+  default_config["delta_min"] = "0.00001";
+  default_config["delta_max"] = "0.01";
+  default_config["max_dr_step"] = "0";
+  default_config["max_force_fraction"] = "0.5";
   default_config["graph_flag"] = "0";
   default_config["n_graph"] = "1000";
   default_config["graph_diameter"] = "0";
@@ -174,6 +182,16 @@
   default_config["movie_flag"] = "0";
   default_config["movie_directory"] = "frames";
   default_config["time_analysis"] = "0";
+  default_config["n_profile"] = "0";
+  default_config["perf_counters"] = "0";
+  default_config["async_output"] = "1";
+  default_config["spec_compression"] = "0";
+  default_config["spec_tolerance"] = "0";
+  default_config["mmap_analysis"] = "1";
+  default_config["parallel_analysis"] = "1";
+  default_config["async_checkpoints"] = "1";
+  default_config["checkpoint_delta"] = "0";
+  default_config["in_situ_analysis"] = "0";
   default_config["bud_height"] = "680";
   default_config["bud_radius"] = "300";
   default_config["lj_epsilon"] = "1";
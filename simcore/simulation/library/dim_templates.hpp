@@ -0,0 +1,70 @@
+#ifndef _SIMCORE_DIM_TEMPLATES_H_
+#define _SIMCORE_DIM_TEMPLATES_H_
+
+#include "macros.hpp"
+
+/* Versions of the vector routines in linear_algebra.cpp with the number of
+   dimensions fixed at compile time, for the kernels that are specialized on
+   the dimension of the run. Loops over the N_DIM components unroll, and the
+   2D versions never touch a z component. */
+
+template <int N_DIM>
+inline double dot_product(double const *const a, double const *const b) {
+  double mag = 0.0;
+  for (int i = 0; i < N_DIM; ++i) {
+    mag += a[i] * b[i];
+  }
+  return mag;
+}
+
+/* Torques are always three dimensional: in 2D only the z component of c is
+   nonzero */
+template <int N_DIM>
+inline void cross_product(double const *const a, double const *const b,
+                          double *c);
+
+template <>
+inline void cross_product<2>(double const *const a, double const *const b,
+                             double *c) {
+  c[0] = 0.0;
+  c[1] = 0.0;
+  c[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+template <>
+inline void cross_product<3>(double const *const a, double const *const b,
+                             double *c) {
+  c[0] = a[1] * b[2] - a[2] * b[1];
+  c[1] = a[2] * b[0] - a[0] * b[2];
+  c[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+/* Minimum image separation dr = r2 - r1, with the first n_periodic dimensions
+   periodic in the unit cell */
+template <int N_DIM>
+inline void separation_vector(int n_periodic, double const *const r1,
+                              double const *const s1, double const *const r2,
+                              double const *const s2,
+                              double const *const unit_cell, double *dr) {
+  double ds[N_DIM];
+  for (int i = 0; i < N_DIM; ++i) {
+    if (i < n_periodic) {
+      ds[i] = s2[i] - s1[i];
+      ds[i] -= NINT(ds[i]);
+    }
+  }
+  for (int i = 0; i < N_DIM; ++i) {
+    if (i < n_periodic) {
+      dr[i] = 0.0;
+      for (int j = 0; j < N_DIM; ++j) {
+        if (j < n_periodic) {
+          dr[i] += unit_cell[N_DIM * i + j] * ds[j];
+        }
+      }
+    } else {
+      dr[i] = r2[i] - r1[i];
+    }
+  }
+}
+
+#endif
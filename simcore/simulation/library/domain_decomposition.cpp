@@ -0,0 +1,466 @@
+#include "domain_decomposition.hpp"
+#include "filament_species.hpp"
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+void DomainDecomposition::StartProcesses(int *argc, char ***argv) {
+#ifdef ENABLE_MPI
+  MPI_Init(argc, argv);
+#endif
+}
+
+void DomainDecomposition::FinishProcesses() {
+#ifdef ENABLE_MPI
+  MPI_Finalize();
+#endif
+}
+
+int DomainDecomposition::GetProcessRank() {
+  int rank = 0;
+#ifdef ENABLE_MPI
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (initialized) {
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  }
+#endif
+  return rank;
+}
+
+int DomainDecomposition::GetNProcesses() {
+  int n_procs = 1;
+#ifdef ENABLE_MPI
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (initialized) {
+    MPI_Comm_size(MPI_COMM_WORLD, &n_procs);
+  }
+#endif
+  return n_procs;
+}
+
+void DomainDecomposition::WaitForProcesses() {
+#ifdef ENABLE_MPI
+  if (GetNProcesses() > 1) {
+    MPI_Barrier(MPI_COMM_WORLD);
+  }
+#endif
+}
+
+/* The intervals overlap if they are longer than the period together, or if
+   some periodic image k of the second interval has lo2 + k <= hi1 and
+   lo1 <= hi2 + k */
+bool DomainDecomposition::Overlaps(double lo1, double hi1, double lo2,
+                                   double hi2) {
+  if (hi1 - lo1 + hi2 - lo2 >= 1) {
+    return true;
+  }
+  return ceil(lo1 - hi2) <= floor(hi1 - lo2);
+}
+
+/* Set up the decomposition when running on more than one process, and keep
+   only the filaments this process owns out of the inserted system.
+   interaction_range is the distance within which objects may interact
+   before the next neighbor list rebuild. */
+void DomainDecomposition::Init(system_parameters *params, space_struct *space,
+                               std::vector<SpeciesBase *> *species,
+                               double interaction_range) {
+  rank_ = GetProcessRank();
+  n_procs_ = GetNProcesses();
+  active_ = false;
+  if (n_procs_ == 1) {
+    return;
+  }
+  if (params->n_periodic != params->n_dim) {
+    Logger::Error("Domain decomposition across %d processes requires a fully "
+                  "periodic system",
+                  n_procs_);
+  }
+  if (params->crosslink.concentration > 0) {
+    Logger::Error("Crosslinks are not supported with domain decomposition");
+  }
+  if (params->in_situ_analysis || params->graph_flag) {
+    Logger::Error("In-situ analysis and graphics are not supported with "
+                  "domain decomposition");
+  }
+  for (auto spec = species->begin(); spec != species->end(); ++spec) {
+    if ((*spec)->GetSID() != +species_id::filament) {
+      Logger::Error("Domain decomposition only supports filaments, found "
+                    "species %s",
+                    (*spec)->GetSID()._to_string());
+    }
+    filaments_ = static_cast<FilamentSpecies *>(*spec);
+  }
+  if (filaments_ == nullptr) {
+    Logger::Error("Domain decomposition requires filaments");
+  }
+  space_ = space;
+  n_dim_ = params->n_dim;
+  n_periodic_ = params->n_periodic;
+  halo_ = interaction_range;
+  if (n_procs_ * halo_ > space_->a_perp[0]) {
+    Logger::Warning("Slabs of %d processes are thinner than the interaction "
+                    "range %2.2f, expect many ghosts",
+                    n_procs_, halo_);
+  }
+  active_ = true;
+  ghost_lists_.assign(n_procs_, std::vector<int>());
+  send_buffers_.resize(n_procs_);
+  send_items_.assign(n_procs_, 0);
+
+  std::vector<Filament> &members = *filaments_->GetMembers();
+  int n_total = members.size();
+  std::vector<bool> leaving(members.size());
+  for (size_t i = 0; i < members.size(); ++i) {
+    double lo, hi, center;
+    GetExtent(members[i], &lo, &hi, &center);
+    leaving[i] = (GetOwner(center) != rank_);
+  }
+  long seed = RNG::GetSeed();
+  filaments_->ExchangeMembers(leaving, stream_, 0);
+  RNG::SetSeed(seed);
+  Logger::Info("Process %d of %d owns %lu of %d filaments", rank_, n_procs_,
+               members.size(), n_total);
+}
+
+/* Scaled coordinate of r along the slab axis, without periodic wrapping */
+double DomainDecomposition::ScaledX(double const *const r) const {
+  double s = 0;
+  for (int j = 0; j < n_periodic_; ++j) {
+    s += space_->unit_cell_inv[j] * r[j];
+  }
+  return s;
+}
+
+/* Scaled extent of the sites of filament along the slab axis, and the
+   center of its sites, shifted so that the center lies in the unit cell */
+void DomainDecomposition::GetExtent(Filament &filament, double *lo,
+                                    double *hi, double *center) const {
+  int n_sites = filament.GetNBonds() + 1;
+  double s_prev = ScaledX(filament.GetSite(0)->GetPosition());
+  double s_sum = s_prev;
+  *lo = *hi = s_prev;
+  for (int i = 1; i < n_sites; ++i) {
+    double ds = ScaledX(filament.GetSite(i)->GetPosition()) - s_prev;
+    double s = s_prev + ds - NINT(ds);
+    s_sum += s;
+    *lo = std::min(*lo, s);
+    *hi = std::max(*hi, s);
+    s_prev = s;
+  }
+  *center = s_sum / n_sites;
+  double shift = NINT(*center);
+  *center -= shift;
+  *lo -= shift;
+  *hi -= shift;
+}
+
+int DomainDecomposition::GetOwner(double center) const {
+  int owner = (int)floor((center + 0.5) * n_procs_);
+  return std::min(std::max(owner, 0), n_procs_ - 1);
+}
+
+void DomainDecomposition::ClearSendBuffers() {
+  for (int i = 0; i < n_procs_; ++i) {
+    send_buffers_[i].GetData().clear();
+    send_items_[i] = 0;
+  }
+}
+
+/* Stream writing to the send buffer of process proc */
+std::fstream &DomainDecomposition::SendStream(int proc) {
+  static_cast<std::ios &>(stream_).rdbuf(&send_buffers_[proc]);
+  return stream_;
+}
+
+/* Send the contents of the send buffers to their processes, and return a
+   stream reading what all processes sent to this one, in the order of their
+   ranks, with the number of items it holds in n_items */
+std::fstream &DomainDecomposition::ExchangeData(int *n_items) {
+  std::vector<int> send_counts(2 * n_procs_);
+  std::vector<int> recv_counts(2 * n_procs_);
+  for (int i = 0; i < n_procs_; ++i) {
+    send_counts[2 * i] = send_buffers_[i].GetData().size();
+    send_counts[2 * i + 1] = send_items_[i];
+  }
+#ifdef ENABLE_MPI
+  MPI_Alltoall(send_counts.data(), 2, MPI_INT, recv_counts.data(), 2, MPI_INT,
+               MPI_COMM_WORLD);
+#else
+  recv_counts = send_counts;
+#endif
+  std::vector<int> send_sizes(n_procs_), send_displs(n_procs_);
+  std::vector<int> recv_sizes(n_procs_), recv_displs(n_procs_);
+  std::vector<char> send_data;
+  int n_recv = 0;
+  *n_items = 0;
+  for (int i = 0; i < n_procs_; ++i) {
+    std::vector<char> &data = send_buffers_[i].GetData();
+    send_sizes[i] = data.size();
+    send_displs[i] = send_data.size();
+    send_data.insert(send_data.end(), data.begin(), data.end());
+    recv_sizes[i] = recv_counts[2 * i];
+    recv_displs[i] = n_recv;
+    n_recv += recv_sizes[i];
+    *n_items += recv_counts[2 * i + 1];
+  }
+  std::vector<char> &recv_data = recv_buffer_.GetData();
+  recv_data.resize(n_recv);
+#ifdef ENABLE_MPI
+  MPI_Alltoallv(send_data.data(), send_sizes.data(), send_displs.data(),
+                MPI_CHAR, recv_data.data(), recv_sizes.data(),
+                recv_displs.data(), MPI_CHAR, MPI_COMM_WORLD);
+#else
+  recv_data = send_data;
+#endif
+  recv_buffer_.Rewind();
+  static_cast<std::ios &>(stream_).rdbuf(&recv_buffer_);
+  return stream_;
+}
+
+/* Rebuild the ghosts, first moving filaments to the process owning their
+   center of mass if migrate is set */
+void DomainDecomposition::Exchange(bool migrate) {
+  std::vector<Filament> &members = *filaments_->GetMembers();
+  std::vector<double> lo(members.size()), hi(members.size());
+  std::vector<double> center(members.size());
+  for (size_t i = 0; i < members.size(); ++i) {
+    GetExtent(members[i], &lo[i], &hi[i], &center[i]);
+  }
+  /* Filaments rebuilt here are not new to the system, and must not advance
+     the seed chain written to checkpoints */
+  long seed = RNG::GetSeed();
+  if (migrate) {
+    Migrate(lo, hi, center);
+  }
+  SendGhosts(lo, hi);
+  RNG::SetSeed(seed);
+}
+
+/* Send the checkpoints of filaments owned by another process to that
+   process, add the filaments received, and update the extents of the
+   members that result */
+void DomainDecomposition::Migrate(std::vector<double> &lo,
+                                  std::vector<double> &hi,
+                                  std::vector<double> &center) {
+  std::vector<Filament> &members = *filaments_->GetMembers();
+  ClearSendBuffers();
+  std::vector<bool> leaving(members.size(), false);
+  for (size_t i = 0; i < members.size(); ++i) {
+    int owner = GetOwner(center[i]);
+    if (owner != rank_) {
+      leaving[i] = true;
+      members[i].WriteCheckpoint(SendStream(owner));
+      send_items_[owner]++;
+    }
+  }
+  int n_arriving = 0;
+  std::fstream &arriving = ExchangeData(&n_arriving);
+  filaments_->ExchangeMembers(leaving, arriving, n_arriving);
+  lo.resize(members.size());
+  hi.resize(members.size());
+  center.resize(members.size());
+  for (size_t i = 0; i < members.size(); ++i) {
+    GetExtent(members[i], &lo[i], &hi[i], &center[i]);
+  }
+}
+
+/* Share the regions of all processes, send a ghost of every member within
+   the interaction range of another process's region to that process, and
+   replace the ghosts of this process with the ones received */
+void DomainDecomposition::SendGhosts(std::vector<double> const &lo,
+                                     std::vector<double> const &hi) {
+  std::vector<double> regions(2 * n_procs_);
+  double region[2] = {-0.5 + (double)rank_ / n_procs_,
+                      -0.5 + (double)(rank_ + 1) / n_procs_};
+  for (size_t i = 0; i < lo.size(); ++i) {
+    region[0] = std::min(region[0], lo[i]);
+    region[1] = std::max(region[1], hi[i]);
+  }
+#ifdef ENABLE_MPI
+  MPI_Allgather(region, 2, MPI_DOUBLE, regions.data(), 2, MPI_DOUBLE,
+                MPI_COMM_WORLD);
+#else
+  std::copy(region, region + 2, regions.begin());
+#endif
+  /* The halo is in scaled units, which change with the system size */
+  double halo = halo_ / space_->a_perp[0];
+  std::vector<Filament> &members = *filaments_->GetMembers();
+  ClearSendBuffers();
+  for (int i_proc = 0; i_proc < n_procs_; ++i_proc) {
+    ghost_lists_[i_proc].clear();
+  }
+  for (size_t i = 0; i < members.size(); ++i) {
+    for (int i_proc = 0; i_proc < n_procs_; ++i_proc) {
+      if (i_proc == rank_ ||
+          !Overlaps(lo[i] - halo, hi[i] + halo, regions[2 * i_proc],
+                    regions[2 * i_proc + 1])) {
+        continue;
+      }
+      ghost_lists_[i_proc].push_back(i);
+      std::fstream &ghost = SendStream(i_proc);
+      int mesh_id = members[i].GetMeshID();
+      ghost.write(reinterpret_cast<char *>(&mesh_id), sizeof(mesh_id));
+      members[i].WriteSpec(ghost);
+      send_items_[i_proc]++;
+    }
+  }
+  int n_ghosts = 0;
+  std::fstream &ighost = ExchangeData(&n_ghosts);
+  std::set<int> received;
+  ghost_order_.clear();
+  for (int i = 0; i < n_ghosts; ++i) {
+    int mesh_id = -1;
+    ighost.read(reinterpret_cast<char *>(&mesh_id), sizeof(mesh_id));
+    auto it = ghosts_.find(mesh_id);
+    if (it == ghosts_.end()) {
+      /* Filaments are built in place, like species members read from spec
+         files, and cleared so that their sites and bonds are rebuilt with
+         the mesh id of the spec */
+      Filament &ghost = ghosts_[mesh_id];
+      ghost.SetSID(species_id::filament);
+      ghost.Init();
+      ghost.Clear();
+      it = ghosts_.find(mesh_id);
+    }
+    it->second.ReadSpec(ighost);
+    ghost_order_.push_back(&it->second);
+    received.insert(mesh_id);
+  }
+  for (auto it = ghosts_.begin(); it != ghosts_.end();) {
+    if (received.count(it->first)) {
+      ++it;
+    } else {
+      it = ghosts_.erase(it);
+    }
+  }
+}
+
+/* Send the current site positions of the ghosts of the last rebuild */
+void DomainDecomposition::UpdateGhosts() {
+  std::vector<Filament> &members = *filaments_->GetMembers();
+  ClearSendBuffers();
+  for (int i_proc = 0; i_proc < n_procs_; ++i_proc) {
+    for (auto i = ghost_lists_[i_proc].begin(); i != ghost_lists_[i_proc].end();
+         ++i) {
+      members[*i].WriteSpec(SendStream(i_proc));
+      send_items_[i_proc]++;
+    }
+  }
+  int n_ghosts = 0;
+  std::fstream &ighost = ExchangeData(&n_ghosts);
+  if (n_ghosts != ghost_order_.size()) {
+    Logger::Error("Received %d ghost updates for %lu ghosts", n_ghosts,
+                  ghost_order_.size());
+  }
+  for (auto ghost = ghost_order_.begin(); ghost != ghost_order_.end();
+       ++ghost) {
+    (*ghost)->ReadSpec(ighost);
+  }
+}
+
+void DomainDecomposition::GetGhostInteractors(std::vector<Object *> *ix) {
+  for (auto it = ghosts_.begin(); it != ghosts_.end(); ++it) {
+    it->second.GetInteractors(ix);
+  }
+}
+
+/* Drop pairs of ghosts, which their owners handle, and mark the pairs that
+   are shared with the owner of a ghost */
+void DomainDecomposition::FilterPairs(std::vector<Interaction> *pairs) const {
+  size_t n_pairs = 0;
+  for (auto ix = pairs->begin(); ix != pairs->end(); ++ix) {
+    bool ghost1 = IsGhost(ix->obj1);
+    bool ghost2 = IsGhost(ix->obj2);
+    if (ghost1 && ghost2) {
+      continue;
+    }
+    ix->ghost = (ghost1 || ghost2);
+    (*pairs)[n_pairs++] = *ix;
+  }
+  pairs->resize(n_pairs);
+}
+
+bool DomainDecomposition::AnyProcess(bool flag) const {
+  int any = flag;
+#ifdef ENABLE_MPI
+  if (active_) {
+    int local = flag;
+    MPI_Allreduce(&local, &any, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+  }
+#endif
+  return any;
+}
+
+void DomainDecomposition::SumOverProcesses(double *values, int n) const {
+#ifdef ENABLE_MPI
+  if (active_) {
+    MPI_Allreduce(MPI_IN_PLACE, values, n, MPI_DOUBLE, MPI_SUM,
+                  MPI_COMM_WORLD);
+  }
+#endif
+}
+
+void DomainDecomposition::MaxOverProcesses(double *values, int n) const {
+#ifdef ENABLE_MPI
+  if (active_) {
+    MPI_Allreduce(MPI_IN_PLACE, values, n, MPI_DOUBLE, MPI_MAX,
+                  MPI_COMM_WORLD);
+  }
+#endif
+}
+
+/* Gather on the first process the members of a species written by every
+   process into data as records of
+
+     int mesh_id, int n_bytes, char[n_bytes] member output
+
+   On the first process, data is replaced by the member outputs of all
+   processes, ordered by mesh id as in a single process run, and their number
+   is returned. Other processes get no data back and return zero. */
+int DomainDecomposition::GatherMembers(std::vector<char> *data) const {
+  std::vector<char> all;
+#ifdef ENABLE_MPI
+  int size = data->size();
+  std::vector<int> sizes(n_procs_), displs(n_procs_);
+  MPI_Gather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (rank_ == 0) {
+    int total = 0;
+    for (int i = 0; i < n_procs_; ++i) {
+      displs[i] = total;
+      total += sizes[i];
+    }
+    all.resize(total);
+  }
+  MPI_Gatherv(data->data(), size, MPI_CHAR, all.data(), sizes.data(),
+              displs.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+#else
+  all.swap(*data);
+#endif
+  data->clear();
+  if (rank_ != 0) {
+    return 0;
+  }
+  std::vector<std::pair<int, size_t>> records;
+  for (size_t pos = 0; pos < all.size();) {
+    int mesh_id, n_bytes;
+    memcpy(&mesh_id, &all[pos], sizeof(int));
+    memcpy(&n_bytes, &all[pos + sizeof(int)], sizeof(int));
+    records.push_back(std::make_pair(mesh_id, pos));
+    pos += 2 * sizeof(int) + n_bytes;
+  }
+  std::sort(records.begin(), records.end());
+  data->reserve(all.size());
+  for (auto rec = records.begin(); rec != records.end(); ++rec) {
+    int n_bytes;
+    memcpy(&n_bytes, &all[rec->second + sizeof(int)], sizeof(int));
+    auto start = all.begin() + rec->second + 2 * sizeof(int);
+    data->insert(data->end(), start, start + n_bytes);
+  }
+  return records.size();
+}
@@ -0,0 +1,99 @@
+#ifndef _SIMCORE_DOMAIN_DECOMPOSITION_H_
+#define _SIMCORE_DOMAIN_DECOMPOSITION_H_
+
+#include "checkpoint_writer.hpp"
+#include "filament.hpp"
+#include "interaction.hpp"
+#include <map>
+
+class SpeciesBase;
+class FilamentSpecies;
+
+/* Splits a simulation of filaments across MPI processes. The periodic box is
+   cut into slabs of equal width along the first lattice vector, one slab per
+   process, and each process owns and integrates the filaments whose center
+   of mass lies in its slab.
+
+   Every process inserts the whole system with the same seed, and then keeps
+   only the filaments it owns, so the initial configuration is the one a
+   single process would simulate. Filaments carry their random number
+   generator with them, so each filament sees the same noise whichever process
+   integrates it.
+
+   The region of a process is its slab, grown to hold every filament it owns.
+   Whenever the neighbor lists are rebuilt, which all processes do on the same
+   step, each process sends a ghost copy of every filament within the
+   interaction range of another process's region to that process, and on the
+   other steps it sends the current site positions of those filaments.
+   Ghosts take part in pair interactions with owned filaments but are never
+   integrated, and the forces on them are discarded, since their owner
+   computes the same pair interactions. Filaments whose center of mass left
+   the slab move to their new owner on rebuilds in full step configurations,
+   where their checkpoint holds all of their state.
+
+   Outputs of the filaments are gathered on the first process, which writes
+   them in the order of a single process run. Without ENABLE_MPI, or with a
+   single process, the decomposition is inactive. */
+class DomainDecomposition {
+private:
+  UNIT_TESTER;
+  bool active_ = false;
+  int rank_ = 0;
+  int n_procs_ = 1;
+  int n_dim_;
+  int n_periodic_;
+  double halo_; // Interaction range, in the units of the system
+  space_struct *space_;
+  FilamentSpecies *filaments_ = nullptr;
+  /* Ghosts by mesh id, which keeps their interactors in place between
+     rebuilds, and the order in which their updates arrive */
+  std::map<int, Filament> ghosts_;
+  std::vector<Filament *> ghost_order_;
+  /* Members sent as ghosts to each process since the last rebuild */
+  std::vector<std::vector<int>> ghost_lists_;
+  std::vector<CheckpointBuffer> send_buffers_;
+  std::vector<int> send_items_;
+  CheckpointBuffer recv_buffer_;
+  std::fstream stream_;
+  double ScaledX(double const *const r) const;
+  void GetExtent(Filament &filament, double *lo, double *hi,
+                 double *center) const;
+  int GetOwner(double center) const;
+  void ClearSendBuffers();
+  std::fstream &SendStream(int proc);
+  std::fstream &ExchangeData(int *n_items);
+  void Migrate(std::vector<double> &lo, std::vector<double> &hi,
+               std::vector<double> &center);
+  void SendGhosts(std::vector<double> const &lo,
+                  std::vector<double> const &hi);
+
+public:
+  DomainDecomposition() {}
+  /* Process level setup and teardown, called from main */
+  static void StartProcesses(int *argc, char ***argv);
+  static void FinishProcesses();
+  static int GetProcessRank();
+  static int GetNProcesses();
+  static void WaitForProcesses();
+  /* Overlap of the scaled intervals [lo1, hi1] and [lo2, hi2] in a periodic
+     dimension of unit length */
+  static bool Overlaps(double lo1, double hi1, double lo2, double hi2);
+
+  void Init(system_parameters *params, space_struct *space,
+            std::vector<SpeciesBase *> *species, double interaction_range);
+  bool IsActive() const { return active_; }
+  int GetRank() const { return rank_; }
+  void Exchange(bool migrate);
+  void UpdateGhosts();
+  void GetGhostInteractors(std::vector<Object *> *ix);
+  bool IsGhost(Object *obj) const {
+    return ghosts_.count(obj->GetMeshID()) > 0;
+  }
+  void FilterPairs(std::vector<Interaction> *pairs) const;
+  bool AnyProcess(bool flag) const;
+  void SumOverProcesses(double *values, int n) const;
+  void MaxOverProcesses(double *values, int n) const;
+  int GatherMembers(std::vector<char> *data) const;
+};
+
+#endif // _SIMCORE_DOMAIN_DECOMPOSITION_H_
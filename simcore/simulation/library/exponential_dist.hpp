@@ -44,11 +44,11 @@ public:
     } else if (x_min > 0) {
       min_roll_ = CDF(x_min);
       max_roll_ = CDF(x_max);
-      Logger::Trace("Renormalizing rolls in ExponentialDist generator to have "
-                    "a minimum of %2.2f and maximum of %2.2f to avoid lengths "
-                    "shorter than minimum length of %2.2f and maximum length "
-                    "of %2.2f",
-                    min_roll_, max_roll_, x_min, x_max);
+      LOG_TRACE("Renormalizing rolls in ExponentialDist generator to have "
+                "a minimum of %2.2f and maximum of %2.2f to avoid lengths "
+                "shorter than minimum length of %2.2f and maximum length "
+                "of %2.2f",
+                min_roll_, max_roll_, x_min, x_max);
     }
   }
   /* Given a uniform random number in the range of 0 and 1 (roll), return its
@@ -61,9 +61,9 @@ public:
       roll = (max_roll_ - min_roll_) * roll + min_roll_;
     }
     double result = InvCDF(roll);
-    Logger::Trace("ExponentialDist generator received a roll of %2.2f and "
-                  "returned a length of %2.2f",
-                  roll, result);
+    LOG_TRACE("ExponentialDist generator received a roll of %2.2f and "
+              "returned a length of %2.2f",
+              roll, result);
     return result;
   }
 };
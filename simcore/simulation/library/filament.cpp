@@ -31,6 +31,7 @@ void Filament::SetParameters() {
   driving_factor_ = params_->filament.driving_factor;
   friction_ratio_ = params_->filament.friction_ratio;
   metric_forces_ = params_->filament.metric_forces;
+  implicit_bending_ = params_->filament.implicit_bending;
   // determines whether we are using thermal forces
   stoch_flag_ = params_->stoch_flag;
   eq_steps_ = params_->filament.n_equil;
@@ -147,9 +148,9 @@ void Filament::InitFilamentLength() {
     n_bonds_max_ = n_bonds_;
   }
 
-  Logger::Trace("Filament initialized with length %2.2f with %d bonds, mesh_id:"
-                " %d",
-                length_, n_bonds_, GetMeshID());
+  LOG_TRACE("Filament initialized with length %2.2f with %d bonds, mesh_id:"
+            " %d",
+            length_, n_bonds_, GetMeshID());
 }
 
 void Filament::AllocateControlStructures() {
@@ -170,6 +171,13 @@ void Filament::AllocateControlStructures() {
   h_mat_lower_.resize(n_sites_max - 2);                 // max_sites-2
   gamma_inverse_.resize(n_sites_max * n_dim_ * n_dim_); // max_sites*ndim*ndim
   cos_thetas_.resize(n_sites_max - 2);                  // max_sites-2
+  if (implicit_bending_) {
+    bend_mat_diag_.resize(n_sites_max);                 // max_sites
+    bend_mat_upper1_.resize(n_sites_max - 1);           // max_sites-1
+    bend_mat_upper2_.resize(n_sites_max - 2);           // max_sites-2
+    bend_rhs_.resize(n_sites_max);                      // max_sites
+    site_dr_.resize(3 * n_sites_max);                   // max_sites*3
+  }
 }
 
 void Filament::InsertFirstBond() {
@@ -236,9 +244,9 @@ void Filament::InsertFilament() {
 }
 
 void Filament::InsertAt(double *pos, double *u) {
-  Logger::Trace("Inserting filament at [%2.1f, %2.1f, %2.1f] with orientation"
-                "[%2.1f, %2.1f, %2.1f]",
-                pos[0], pos[1], pos[2], u[0], u[1], u[2]);
+  LOG_TRACE("Inserting filament at [%2.1f, %2.1f, %2.1f] with orientation"
+            "[%2.1f, %2.1f, %2.1f]",
+            pos[0], pos[1], pos[2], u[0], u[1], u[2]);
   RelocateMesh(pos, u);
   UpdatePrevPositions();
   CalculateAngles();
@@ -305,6 +313,19 @@ void Filament::SetDiffusion() {
   rand_sigma_par_ = sqrt(24.0 * friction_par_ / delta_);
 }
 
+/* Dynamic instability switching probabilities and random force magnitudes
+   are per time step */
+void Filament::SetTimeStep(double delta) {
+  Mesh::SetTimeStep(delta);
+  p_g2s_ = params_->filament.f_grow_to_shrink * delta_;
+  p_g2p_ = params_->filament.f_grow_to_pause * delta_;
+  p_s2p_ = params_->filament.f_shrink_to_pause * delta_;
+  p_s2g_ = params_->filament.f_shrink_to_grow * delta_;
+  p_p2s_ = params_->filament.f_pause_to_shrink * delta_;
+  p_p2g_ = params_->filament.f_pause_to_grow * delta_;
+  SetDiffusion();
+}
+
 void Filament::GenerateProbableOrientation() {
   /* This updates the current orientation with a generated probable
   orientation where we generate random theta pulled from probability
@@ -363,26 +384,43 @@ void Filament::UpdatePosition(bool midstep) {
   Montesi, Morse, Pasquali. J Chem Phys 122, 084903 (2005).
 ********************************************************************************/
 void Filament::Integrate() {
-  CalculateAngles();
+  if (n_dim_ == 2) {
+    Integrate<2>();
+  } else {
+    Integrate<3>();
+  }
+}
+
+/* The integrator is specialized on the dimension of the run */
+template <int N_DIM> void Filament::Integrate() {
+  CalculateAngles<N_DIM>();
   CalculateSpiralNumber();
   CalculateTangents();
   if (midstep_) {
-    ConstructUnprojectedRandomForces();
-    GeometricallyProjectRandomForces();
+    ConstructUnprojectedRandomForces<N_DIM>();
+    GeometricallyProjectRandomForces<N_DIM>();
     UpdatePrevPositions();
   }
   AddRandomForces();
   CalculateBendingForces();
-  CalculateTensions();
-  UpdateSitePositions();
+  CalculateTensions<N_DIM>();
+  UpdateSitePositions<N_DIM>();
   UpdateBondPositions();
 }
 
 void Filament::CalculateAngles() {
+  if (n_dim_ == 2) {
+    CalculateAngles<2>();
+  } else {
+    CalculateAngles<3>();
+  }
+}
+
+template <int N_DIM> void Filament::CalculateAngles() {
   for (int i_site = 0; i_site < n_sites_ - 2; ++i_site) {
     double const *const u1 = sites_[i_site].GetOrientation();
     double const *const u2 = sites_[i_site + 1].GetOrientation();
-    double cos_angle = dot_product(n_dim_, u1, u2);
+    double cos_angle = dot_product<N_DIM>(u1, u2);
     cos_thetas_[i_site] = cos_angle;
   }
 }
@@ -430,7 +468,7 @@ void Filament::CalculateSpiralNumber() {
   // Failed spiral (waiting until the filament straightens)
   if (spiral_flag_ &&
       ABS(GetSpiralNumber()) < params_->filament.spiral_number_fail_condition) {
-    early_exit = true;
+    ctx_->early_exit = true;
   }
 }
 
@@ -466,7 +504,7 @@ void Filament::GetPolarOrder(double *polar_order_vector) {
   }
 }
 
-void Filament::ConstructUnprojectedRandomForces() {
+template <int N_DIM> void Filament::ConstructUnprojectedRandomForces() {
   // Create unprojected forces, see J. Chem. Phys. 122, 084903 (2005),
   // eqn. 40. xi is the random force vector with elements that are
   // uncorrelated and randomly distributed uniformly between -0.5 and 0.5,
@@ -477,12 +515,12 @@ void Filament::ConstructUnprojectedRandomForces() {
   double xi[3], xi_term[3], f_rand[3];
   for (int i_site = 0; i_site < n_sites_; ++i_site) {
     double const *const utan = sites_[i_site].GetTangent();
-    for (int i = 0; i < n_dim_; ++i)
+    for (int i = 0; i < N_DIM; ++i)
       xi[i] = gsl_rng_uniform_pos(rng_.r) - 0.5;
-    if (n_dim_ == 2) {
+    if (N_DIM == 2) {
       xi_term[0] = SQR(utan[0]) * xi[0] + utan[0] * utan[1] * xi[1];
       xi_term[1] = SQR(utan[1]) * xi[1] + utan[0] * utan[1] * xi[0];
-    } else if (n_dim_ == 3) {
+    } else {
       xi_term[0] = SQR(utan[0]) * xi[0] + utan[0] * utan[1] * xi[1] +
                    utan[0] * utan[2] * xi[2];
       xi_term[1] = SQR(utan[1]) * xi[1] + utan[0] * utan[1] * xi[0] +
@@ -490,7 +528,7 @@ void Filament::ConstructUnprojectedRandomForces() {
       xi_term[2] = SQR(utan[2]) * xi[2] + utan[0] * utan[2] * xi[0] +
                    utan[1] * utan[2] * xi[1];
     }
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       f_rand[i] = rand_sigma_perp_ * xi[i] +
                   (rand_sigma_par_ - rand_sigma_perp_) * xi_term[i];
     }
@@ -498,7 +536,7 @@ void Filament::ConstructUnprojectedRandomForces() {
   }
 }
 
-void Filament::GeometricallyProjectRandomForces() {
+template <int N_DIM> void Filament::GeometricallyProjectRandomForces() {
   if (!stoch_flag_)
     return;
   double f_rand_temp[3];
@@ -509,9 +547,9 @@ void Filament::GeometricallyProjectRandomForces() {
     double const *const f_rand1 = sites_[i_site].GetRandomForce();
     double const *const f_rand2 = sites_[i_site + 1].GetRandomForce();
     double const *const u_site = sites_[i_site].GetOrientation();
-    for (int i = 0; i < n_dim_; ++i)
+    for (int i = 0; i < N_DIM; ++i)
       f_rand_temp[i] = f_rand2[i] - f_rand1[i];
-    tensions_[i_site] = dot_product(n_dim_, f_rand_temp, u_site);
+    tensions_[i_site] = dot_product<N_DIM>(f_rand_temp, u_site);
     // Then get the G arrays (for inertialess case where m=1, see
     // ref. 15 of above paper)
     g_mat_diag_[i_site] = 2;
@@ -526,12 +564,12 @@ void Filament::GeometricallyProjectRandomForces() {
   // Update to the projected brownian forces
   // First the end sites:
   double f_proj[3];
-  for (int i = 0; i < n_dim_; ++i) {
+  for (int i = 0; i < N_DIM; ++i) {
     f_proj[i] = sites_[0].GetRandomForce()[i] +
                 tensions_[0] * sites_[0].GetOrientation()[i];
   }
   sites_[0].SetRandomForce(f_proj);
-  for (int i = 0; i < n_dim_; ++i) {
+  for (int i = 0; i < N_DIM; ++i) {
     f_proj[i] =
         sites_[n_sites_ - 1].GetRandomForce()[i] -
         tensions_[n_sites_ - 2] * sites_[n_sites_ - 2].GetOrientation()[i];
@@ -541,7 +579,7 @@ void Filament::GeometricallyProjectRandomForces() {
   for (int i_site = 1; i_site < n_sites_ - 1; ++i_site) {
     double const *const u1 = sites_[i_site - 1].GetOrientation();
     double const *const u2 = sites_[i_site].GetOrientation();
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       f_proj[i] = sites_[i_site].GetRandomForce()[i] +
                   tensions_[i_site] * u2[i] - tensions_[i_site - 1] * u1[i];
     }
@@ -725,15 +763,15 @@ void Filament::CalculateBendingForces() {
   }
 }
 
-void Filament::CalculateTensions() {
+template <int N_DIM> void Filament::CalculateTensions() {
   // Calculate friction_inverse matrix
   int site_index = 0;
-  int next_site = n_dim_ * n_dim_;
+  int next_site = N_DIM * N_DIM;
   for (int i_site = 0; i_site < n_sites_; ++i_site) {
     int gamma_index = 0;
     double const *const utan = sites_[i_site].GetTangent();
-    for (int i = 0; i < n_dim_; ++i) {
-      for (int j = 0; j < n_dim_; ++j) {
+    for (int i = 0; i < N_DIM; ++i) {
+      for (int j = 0; j < N_DIM; ++j) {
         gamma_inverse_[site_index + gamma_index] =
             1.0 / friction_par_ * (utan[i] * utan[j]) +
             1.0 / friction_perp_ * ((i == j ? 1 : 0) - utan[i] * utan[j]);
@@ -755,47 +793,92 @@ void Filament::CalculateTensions() {
     double const *const u2 = sites_[i_site].GetOrientation();
     double const *const utan1 = sites_[i_site].GetTangent();
     double const *const utan2 = sites_[i_site + 1].GetTangent();
-    for (int i = 0; i < n_dim_; ++i) {
-      temp_a = gamma_inverse_[site_index + n_dim_ * i] * f1[0] +
-               gamma_inverse_[site_index + n_dim_ * i + 1] * f1[1];
-      if (n_dim_ == 3)
-        temp_a += gamma_inverse_[site_index + n_dim_ * i + 2] * f1[2];
-      temp_b = gamma_inverse_[site_index + next_site + n_dim_ * i] * f2[0] +
-               gamma_inverse_[site_index + next_site + n_dim_ * i + 1] * f2[1];
-      if (n_dim_ == 3)
+    for (int i = 0; i < N_DIM; ++i) {
+      temp_a = temp_b = 0.0;
+      for (int j = 0; j < N_DIM; ++j) {
+        temp_a += gamma_inverse_[site_index + N_DIM * i + j] * f1[j];
         temp_b +=
-            gamma_inverse_[site_index + next_site + n_dim_ * i + 2] * f2[2];
+            gamma_inverse_[site_index + next_site + N_DIM * i + j] * f2[j];
+      }
       f_diff[i] = temp_b - temp_a;
     }
-    tensions_[i_site] = dot_product(n_dim_, u2, f_diff);
-    utan1_dot_u2 = dot_product(n_dim_, utan1, u2);
-    utan2_dot_u2 = dot_product(n_dim_, utan2, u2);
+    tensions_[i_site] = dot_product<N_DIM>(u2, f_diff);
+    utan1_dot_u2 = dot_product<N_DIM>(utan1, u2);
+    utan2_dot_u2 = dot_product<N_DIM>(utan2, u2);
     h_mat_diag_[i_site] =
         2.0 / friction_perp_ + (1.0 / friction_par_ - 1.0 / friction_perp_) *
                                    (SQR(utan1_dot_u2) + SQR(utan2_dot_u2));
     if (i_site > 0) {
       double const *const u1 = sites_[i_site - 1].GetOrientation();
       h_mat_upper_[i_site - 1] =
-          -1.0 / friction_perp_ * dot_product(n_dim_, u2, u1) -
+          -1.0 / friction_perp_ * dot_product<N_DIM>(u2, u1) -
           (1.0 / friction_par_ - 1.0 / friction_perp_) *
-              (dot_product(n_dim_, utan1, u1) * dot_product(n_dim_, utan1, u2));
+              (dot_product<N_DIM>(utan1, u1) * dot_product<N_DIM>(utan1, u2));
       h_mat_lower_[i_site - 1] = h_mat_upper_[i_site - 1];
     }
     site_index += next_site;
   }
   tridiagonal_solver(&h_mat_lower_, &h_mat_diag_, &h_mat_upper_, &tensions_,
                      n_sites_ - 1);
+  if (implicit_bending_) {
+    FactorBendingMatrix();
+  }
 }
 
-void Filament::UpdateSitePositions() {
+/* Semi-implicit bending. The explicit site displacements of the step are
+   filtered through (I + delta/friction_perp K), where K is the stiffness
+   matrix of the bending energy linearized about a straight filament,
+
+     E = sum_i k_eff_i / (2 bond_length) |r_i+2 - 2 r_i+1 + r_i|^2,
+
+   which relaxes bending modes stiffer than friction/delta as a backward Euler
+   step would, instead of letting them grow. Modes much softer than that are
+   unaffected, so for small time steps this reduces to the explicit update. */
+void Filament::FactorBendingMatrix() {
+  double delta = (midstep_ ? 0.5 * delta_ : delta_);
+  double scale = delta / (friction_perp_ * bond_length_);
+  std::fill(bend_mat_diag_.begin(), bend_mat_diag_.begin() + n_sites_, 1.0);
+  std::fill(bend_mat_upper1_.begin(), bend_mat_upper1_.begin() + n_sites_ - 1,
+            0.0);
+  std::fill(bend_mat_upper2_.begin(), bend_mat_upper2_.end(), 0.0);
+  // Each angle adds c (1, -2, 1)^T (1, -2, 1) to the block of its three sites
+  for (int i = 0; i < n_sites_ - 2; ++i) {
+    double c = scale * k_eff_[i];
+    bend_mat_diag_[i] += c;
+    bend_mat_diag_[i + 1] += 4 * c;
+    bend_mat_diag_[i + 2] += c;
+    bend_mat_upper1_[i] -= 2 * c;
+    bend_mat_upper1_[i + 1] -= 2 * c;
+    bend_mat_upper2_[i] += c;
+  }
+  pentadiagonal_factor(&bend_mat_diag_, &bend_mat_upper1_, &bend_mat_upper2_,
+                       n_sites_);
+}
+
+/* Filter the site displacements in site_dr_ through the factored bending
+   matrix, one dimension at a time */
+template <int N_DIM> void Filament::ApplyImplicitBending() {
+  for (int i = 0; i < N_DIM; ++i) {
+    for (int i_site = 0; i_site < n_sites_; ++i_site) {
+      bend_rhs_[i_site] = site_dr_[3 * i_site + i];
+    }
+    pentadiagonal_solve(bend_mat_diag_, bend_mat_upper1_, bend_mat_upper2_,
+                        &bend_rhs_, n_sites_);
+    for (int i_site = 0; i_site < n_sites_; ++i_site) {
+      site_dr_[3 * i_site + i] = bend_rhs_[i_site];
+    }
+  }
+}
+
+template <int N_DIM> void Filament::UpdateSitePositions() {
   double delta = (midstep_ ? 0.5 * delta_ : delta_);
   double f_site[3];
   // First get total forces
   // Handle end sites first
-  for (int i = 0; i < n_dim_; ++i)
+  for (int i = 0; i < N_DIM; ++i)
     f_site[i] = tensions_[0] * sites_[0].GetOrientation()[i];
   sites_[0].AddForce(f_site);
-  for (int i = 0; i < n_dim_; ++i)
+  for (int i = 0; i < N_DIM; ++i)
     f_site[i] =
         -tensions_[n_sites_ - 2] * sites_[n_sites_ - 2].GetOrientation()[i];
   sites_[n_sites_ - 1].AddForce(f_site);
@@ -803,7 +886,7 @@ void Filament::UpdateSitePositions() {
   for (int i_site = 1; i_site < n_sites_ - 1; ++i_site) {
     double const *const u_site1 = sites_[i_site - 1].GetOrientation();
     double const *const u_site2 = sites_[i_site].GetOrientation();
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       f_site[i] =
           tensions_[i_site] * u_site2[i] - tensions_[i_site - 1] * u_site1[i];
     }
@@ -812,56 +895,72 @@ void Filament::UpdateSitePositions() {
   // Now update positions
   double f_term[3], r_new[3];
   int site_index = 0;
-  int next_site = n_dim_ * n_dim_;
+  int next_site = N_DIM * N_DIM;
   for (int i_site = 0; i_site < n_sites_; ++i_site) {
     double const *const f_site1 = sites_[i_site].GetForce();
     double const *const r_prev = sites_[i_site].GetPrevPosition();
-    for (int i = 0; i < n_dim_; ++i) {
-      f_term[i] = gamma_inverse_[site_index + n_dim_ * i] * f_site1[0] +
-                  gamma_inverse_[site_index + n_dim_ * i + 1] * f_site1[1];
-      if (n_dim_ == 3)
-        f_term[i] += gamma_inverse_[site_index + n_dim_ * i + 2] * f_site1[2];
+    for (int i = 0; i < N_DIM; ++i) {
+      f_term[i] = 0.0;
+      for (int j = 0; j < N_DIM; ++j) {
+        f_term[i] += gamma_inverse_[site_index + N_DIM * i + j] * f_site1[j];
+      }
       r_new[i] = r_prev[i] + delta * f_term[i];
     }
-    sites_[i_site].SetPosition(r_new);
+    if (implicit_bending_) {
+      for (int i = 0; i < N_DIM; ++i) {
+        site_dr_[3 * i_site + i] = delta * f_term[i];
+      }
+    } else {
+      sites_[i_site].SetPosition(r_new);
+    }
     site_index += next_site;
   }
+  if (implicit_bending_) {
+    ApplyImplicitBending<N_DIM>();
+    for (int i_site = 0; i_site < n_sites_; ++i_site) {
+      double const *const r_prev = sites_[i_site].GetPrevPosition();
+      for (int i = 0; i < N_DIM; ++i) {
+        r_new[i] = r_prev[i] + site_dr_[3 * i_site + i];
+      }
+      sites_[i_site].SetPosition(r_new);
+    }
+  }
   // Next, update orientation vectors
   double u_mag, r_diff[3];
   for (int i_site = 0; i_site < n_sites_ - 1; ++i_site) {
     double const *const r_site1 = sites_[i_site].GetPosition();
     double const *const r_site2 = sites_[i_site + 1].GetPosition();
     u_mag = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       r_diff[i] = r_site2[i] - r_site1[i];
       u_mag += SQR(r_diff[i]);
     }
     u_mag = sqrt(u_mag);
-    for (int i = 0; i < n_dim_; ++i)
+    for (int i = 0; i < N_DIM; ++i)
       r_diff[i] /= u_mag;
     sites_[i_site].SetOrientation(r_diff);
   }
   sites_[n_sites_ - 1].SetOrientation(sites_[n_sites_ - 2].GetOrientation());
   // Finally, normalize site positions, making sure the sites are still
   // rod-length apart
-  if (CheckBondLengths()) {
+  if (CheckBondLengths<N_DIM>()) {
     for (int i_site = 1; i_site < n_sites_; ++i_site) {
       double const *const r_site1 = sites_[i_site - 1].GetPosition();
       double const *const u_site1 = sites_[i_site - 1].GetOrientation();
-      for (int i = 0; i < n_dim_; ++i)
+      for (int i = 0; i < N_DIM; ++i)
         r_diff[i] = r_site1[i] + bond_length_ * u_site1[i];
       sites_[i_site].SetPosition(r_diff);
     }
   }
 }
 
-bool Filament::CheckBondLengths() {
+template <int N_DIM> bool Filament::CheckBondLengths() {
   bool renormalize = false;
   for (int i_site = 1; i_site < n_sites_; ++i_site) {
     double const *const r_site1 = sites_[i_site - 1].GetPosition();
     double const *const r_site2 = sites_[i_site].GetPosition();
     double a = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       double temp = r_site2[i] - r_site1[i];
       a += temp * temp;
     }
@@ -1233,7 +1332,7 @@ void Filament::ReportAll() {
     */
 
 void Filament::WriteSpec(std::fstream &ospec) {
-  Logger::Trace("Writing filament specs, object id: %d", GetOID());
+  LOG_TRACE("Writing filament specs, object id: %d", GetOID());
   Mesh::WriteSpec(ospec);
   ospec.write(reinterpret_cast<char *>(&persistence_length_), sizeof(double));
   ospec.write(reinterpret_cast<char *>(&poly_), sizeof(unsigned char));
@@ -1337,6 +1436,8 @@ void Filament::WriteCheckpoint(std::fstream &ocheck) {
 
 void Filament::ReadCheckpoint(std::fstream &icheck) {
   Mesh::ReadCheckpoint(icheck);
+  /* Friction depends on the length and number of sites just read */
+  SetDiffusion();
   // if (icheck.eof())
   // return;
   // void *rng_state = gsl_rng_state(rng_.r);
@@ -15,6 +15,7 @@ private:
   int stoch_flag_;
   int flagella_flag_;
   int metric_forces_;
+  int implicit_bending_;
   int optical_trap_flag_;
   int cilia_trap_flag_;
   int optical_trap_fixed_;
@@ -67,18 +68,28 @@ private:
   std::vector<double> h_mat_upper_;   // n_sites-2
   std::vector<double> h_mat_lower_;   // n_sites-2
   std::vector<double> cos_thetas_;
+  /* Factored (I + delta/friction_perp K) of the semi-implicit bending
+     update, and the site displacements it is applied to */
+  std::vector<double> bend_mat_diag_;   // n_sites
+  std::vector<double> bend_mat_upper1_; // n_sites-1
+  std::vector<double> bend_mat_upper2_; // n_sites-2
+  std::vector<double> bend_rhs_;        // n_sites
+  std::vector<double> site_dr_;         // n_sites*3
   poly_state poly_;
   void UpdateSiteBondPositions();
   void SetDiffusion();
   void GenerateProbableOrientation();
   void CalculateAngles();
+  template <int N_DIM> void CalculateAngles();
   void CalculateTangents();
   void AddRandomForces();
-  void ConstructUnprojectedRandomForces();
-  void GeometricallyProjectRandomForces();
+  template <int N_DIM> void ConstructUnprojectedRandomForces();
+  template <int N_DIM> void GeometricallyProjectRandomForces();
   void CalculateBendingForces();
-  void CalculateTensions();
-  void UpdateSitePositions();
+  template <int N_DIM> void CalculateTensions();
+  void FactorBendingMatrix();
+  template <int N_DIM> void ApplyImplicitBending();
+  template <int N_DIM> void UpdateSitePositions();
   void ApplyForcesTorques();
   void ApplyInteractionForces();
   void SetParameters();
@@ -93,7 +104,7 @@ private:
   void InitSpiral2D();
   void ReportAll();
   void CalculateBinding();
-  bool CheckBondLengths();
+  template <int N_DIM> bool CheckBondLengths();
   void AllocateControlStructures();
 
 public:
@@ -101,6 +112,7 @@ public:
   virtual void Init();
   virtual void InsertAt(double *pos, double *u);
   virtual void Integrate();
+  template <int N_DIM> void Integrate();
   virtual void Draw(std::vector<graph_struct *> *graph_array);
   virtual void UpdatePosition() {}
   virtual void UpdatePosition(bool midstep);
@@ -131,6 +143,7 @@ public:
   void WriteCheckpoint(std::fstream &ocheck);
   void ReadCheckpoint(std::fstream &icheck);
   void ScalePosition();
+  void SetTimeStep(double delta);
   double const GetVolume();
 };
 
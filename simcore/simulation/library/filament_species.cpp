@@ -9,6 +9,7 @@ void FilamentSpecies::Init(system_parameters *params, space_struct *space,
                            long seed) {
   Species::Init(params, space, seed);
   sparams_ = &(params_->filament);
+  domains_ = SimulationContext::Current().domains;
   fill_volume_ = 0;
   packing_fraction_ = params_->filament.packing_fraction;
 #ifdef TRACE
@@ -162,6 +163,7 @@ void FilamentSpecies::InitAnalysis() {
     InitFlockingAnalysis();
   }
   RunAnalysis();
+  InitSpecView();
   if (params_->in_out_flag) {
     std::string fname = params_->run_name;
     fname.append("_filament.in_out");
@@ -423,6 +425,11 @@ void FilamentSpecies::InitThetaAnalysis() {
 }
 
 void FilamentSpecies::RunAnalysis() {
+  if (i_analyzed_ahead_ < n_frames_ahead_) {
+    AddFrameAhead();
+    time_++;
+    return;
+  }
   if (params_->filament.spiral_flag) {
     RunSpiralAnalysis();
   }
@@ -538,6 +545,15 @@ void FilamentSpecies::RunMse2eAnalysis() {
   // Exiting.\n";
   //}
   // mse2e_file_ << time_;
+  if (use_spec_view_) {
+    for (int i = 0; i < spec_view_.GetNMembers(); ++i) {
+      double mse2e_temp = GetViewMse2e(spec_view_, i);
+      mse2e_ += mse2e_temp;
+      mse2e2_ += mse2e_temp * mse2e_temp;
+    }
+    n_samples_++;
+    return;
+  }
   for (auto it = members_.begin(); it != members_.end(); ++it) {
     double const *const head_pos = it->GetHeadPosition();
     double const *const tail_pos = it->GetTailPosition();
@@ -556,23 +572,432 @@ void FilamentSpecies::RunMse2eAnalysis() {
   n_samples_++;
 }
 
+int FilamentSpecies::GetThetaBin(double cos_theta) const {
+  int bin_number = (int)floor((1 + cos_theta) * (n_bins_ / 2));
+  if (bin_number == n_bins_) {
+    bin_number = n_bins_ - 1;
+  } else if (bin_number == -1) {
+    bin_number = 0;
+  } else if (bin_number > n_bins_ && bin_number < 0) {
+    Logger::Error("Something went wrong in RunThetaAnalysis!");
+  }
+  return bin_number;
+}
+
 void FilamentSpecies::RunThetaAnalysis() {
+  if (use_spec_view_) {
+    for (int i = 0; i < spec_view_.GetNMembers(); ++i) {
+      GetViewThetas(spec_view_, i, &view_thetas_);
+      for (int i_bond = 0; i_bond < view_thetas_.size(); ++i_bond) {
+        theta_histogram_[i_bond][GetThetaBin(view_thetas_[i_bond])]++;
+      }
+    }
+    return;
+  }
   for (auto it = members_.begin(); it != members_.end(); ++it) {
     std::vector<double> const *const thetas = it->GetThetas();
     for (int i = 0; i < (it->GetNBonds() - 1); ++i) {
-      int bin_number = (int)floor((1 + (*thetas)[i]) * (n_bins_ / 2));
-      if (bin_number == n_bins_) {
-        bin_number = n_bins_ - 1;
-      } else if (bin_number == -1) {
-        bin_number = 0;
-      } else if (bin_number > n_bins_ && bin_number < 0) {
-        Logger::Error("Something went wrong in RunThetaAnalysis!");
+      theta_histogram_[i][GetThetaBin((*thetas)[i])]++;
+    }
+  }
+}
+
+/* Squared end-to-end distance of member i_member of a spec frame view */
+double FilamentSpecies::GetViewMse2e(const FilamentSpecView &view,
+                                     int i_member) const {
+  int head = view.GetNSites(i_member) - 1;
+  double mse2e_temp = 0.0;
+  for (int j = 0; j < params_->n_dim; ++j) {
+    SpecView<double> const r = view.GetSitePositions(i_member, j);
+    double temp = (r[head] - r[0]);
+    mse2e_temp += temp * temp;
+  }
+  return mse2e_temp;
+}
+
+/* Cosines of the angles between consecutive bonds of member i_member of a
+   spec frame view, with bond orientations computed from the site positions
+   the same way as in Bond::ReInit */
+void FilamentSpecies::GetViewThetas(const FilamentSpecView &view,
+                                    int i_member,
+                                    std::vector<double> *cos_thetas) const {
+  int n_dim = params_->n_dim;
+  SpecView<double> r[3];
+  for (int j = 0; j < n_dim; ++j) {
+    r[j] = view.GetSitePositions(i_member, j);
+  }
+  double u1[3] = {0, 0, 0};
+  double u2[3] = {0, 0, 0};
+  auto bond_orientation = [&](int i_bond, double *u) {
+    double length = 0;
+    for (int j = 0; j < n_dim; ++j) {
+      u[j] = r[j][i_bond + 1] - r[j][i_bond];
+      length += u[j] * u[j];
+    }
+    length = sqrt(length);
+    for (int j = 0; j < n_dim; ++j) {
+      u[j] /= length;
+    }
+  };
+  int n_bonds = view.GetNSites(i_member) - 1;
+  cos_thetas->resize(n_bonds - 1);
+  bond_orientation(0, u2);
+  for (int i_bond = 0; i_bond < n_bonds - 1; ++i_bond) {
+    std::copy(u2, u2 + 3, u1);
+    bond_orientation(i_bond + 1, u2);
+    (*cos_thetas)[i_bond] = dot_product(n_dim, u1, u2);
+  }
+}
+
+/* Read frames from a memory map of the spec file from here on if every
+   requested analysis can run on a FilamentSpecView, so that filaments are
+   not rebuilt from every frame */
+void FilamentSpecies::InitSpecView() {
+  if (!spec_views_enabled_ || params_->filament.spiral_flag ||
+      params_->filament.crossing_analysis ||
+      params_->filament.global_order_analysis ||
+      params_->polar_order_analysis ||
+      params_->filament.orientation_corr_analysis ||
+      params_->filament.flocking_analysis || params_->in_out_flag) {
+    return;
+  }
+  if (!ispec_file_.is_open() || SpecCompression::IsCompressed(ispec_file_)) {
+    return;
+  }
+  std::streamoff offset = ispec_file_.tellg();
+  if (offset < 0 || !spec_map_.Open(ispec_file_name_, offset)) {
+    return;
+  }
+  Logger::Info("Reading %s spec frames from memory map",
+               GetSID()._to_string());
+  use_spec_view_ = true;
+  /* RunAnalysis has to be called exactly once per spec frame for frames to
+     be analyzed ahead of the processing loop */
+  if (params_->parallel_analysis &&
+      (!sparams_->posit_flag || sparams_->n_posit % sparams_->n_spec == 0)) {
+    AnalyzeFramesAhead();
+  }
+}
+
+/* Analyze the next batch of frames of the mapped spec file at once, with
+   the frames split into one contiguous range per thread and a separate frame
+   view for every range. Batches hold at most max_ahead_values_ results, so
+   memory does not grow with the length of the trajectory, and the next batch
+   is analyzed once the processing loop has reached every frame of the last.
+   Per-frame results (squared end-to-end distances and theta histogram bins)
+   are kept until the processing loop reaches each frame, and are then added
+   to the accumulators in frame order, so the analysis output is identical to
+   analyzing one frame at a time. Frames after a change in the number of
+   filaments are analyzed serially. */
+void FilamentSpecies::AnalyzeFramesAhead() {
+  FilamentSpecView view;
+  size_t offset = spec_map_.GetCursor();
+  ahead_offsets_.clear();
+  ahead_theta_start_.assign(1, 0);
+  ahead_batch_full_ = false;
+  int n_theta_bonds = 0;
+  bool theta = params_->filament.theta_analysis;
+  bool mse2e = params_->filament.lp_analysis;
+  if (theta) {
+    n_theta_bonds = members_.back().GetNBonds() - 1;
+  }
+  size_t n_threads = 1;
+#ifdef ENABLE_OPENMP
+  n_threads = omp_get_max_threads();
+#endif
+  size_t n_values = 0;
+  while (view.Parse(spec_map_, offset) && view.GetNMembers() == n_members_) {
+    size_t n_thetas = 0;
+    bool fits = true;
+    for (int i = 0; theta && i < n_members_; ++i) {
+      fits = fits && (view.GetNSites(i) - 2 <= n_theta_bonds);
+      n_thetas += view.GetNSites(i) - 2;
+    }
+    if (!fits) {
+      /* Would overrun the theta histogram, leave it to the serial path */
+      break;
+    }
+    /* Give every thread at least one frame before closing the batch */
+    size_t n_frame_values = n_thetas + (mse2e ? n_members_ : 0);
+    if (ahead_offsets_.size() >= n_threads &&
+        n_values + n_frame_values > max_ahead_values_) {
+      ahead_batch_full_ = true;
+      break;
+    }
+    n_values += n_frame_values;
+    ahead_offsets_.push_back(offset);
+    ahead_theta_start_.push_back(ahead_theta_start_.back() + n_thetas);
+    offset += view.GetFrameSize();
+  }
+  n_frames_ahead_ = ahead_offsets_.size();
+  i_read_ahead_ = i_analyzed_ahead_ = 0;
+  if (n_frames_ahead_ == 0) {
+    return;
+  }
+  ahead_offsets_.push_back(offset);
+  ahead_mse2e_.assign(mse2e ? n_frames_ahead_ * n_members_ : 0, 0);
+  ahead_theta_bins_.assign(ahead_theta_start_.back(), 0);
+  int n_chunks = 1;
+#ifdef ENABLE_OPENMP
+  n_chunks = std::min(omp_get_max_threads(), n_frames_ahead_);
+#endif
+  Logger::Debug("Analyzing %d %s spec frames ahead in %d frame ranges",
+                n_frames_ahead_, GetSID()._to_string(), n_chunks);
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+  for (int i_chunk = 0; i_chunk < n_chunks; ++i_chunk) {
+    FilamentSpecView chunk_view;
+    std::vector<double> cos_thetas;
+    int first = (long)n_frames_ahead_ * i_chunk / n_chunks;
+    int last = (long)n_frames_ahead_ * (i_chunk + 1) / n_chunks;
+    for (int i_frame = first; i_frame < last; ++i_frame) {
+      chunk_view.Parse(spec_map_, ahead_offsets_[i_frame]);
+      size_t i_theta = ahead_theta_start_[i_frame];
+      for (int i = 0; i < n_members_; ++i) {
+        if (mse2e) {
+          ahead_mse2e_[i_frame * n_members_ + i] =
+              GetViewMse2e(chunk_view, i);
+        }
+        if (theta) {
+          GetViewThetas(chunk_view, i, &cos_thetas);
+          for (int i_bond = 0; i_bond < cos_thetas.size(); ++i_bond) {
+            ahead_theta_bins_[i_theta++] =
+                i_bond * n_bins_ + GetThetaBin(cos_thetas[i_bond]);
+          }
+        }
       }
-      theta_histogram_[i][bin_number]++;
     }
   }
 }
 
+/* Add the results of the current frame, analyzed ahead, to the analysis
+   accumulators */
+void FilamentSpecies::AddFrameAhead() {
+  int i_frame = i_analyzed_ahead_++;
+  if (params_->filament.lp_analysis) {
+    for (int i = 0; i < n_members_; ++i) {
+      double mse2e_temp = ahead_mse2e_[i_frame * n_members_ + i];
+      mse2e_ += mse2e_temp;
+      mse2e2_ += mse2e_temp * mse2e_temp;
+    }
+    n_samples_++;
+  }
+  if (params_->filament.theta_analysis) {
+    for (size_t i = ahead_theta_start_[i_frame];
+         i < ahead_theta_start_[i_frame + 1]; ++i) {
+      int bin = ahead_theta_bins_[i];
+      theta_histogram_[bin / n_bins_][bin % n_bins_]++;
+    }
+  }
+  if (i_analyzed_ahead_ < n_frames_ahead_) {
+    return;
+  }
+  n_frames_ahead_ = i_read_ahead_ = i_analyzed_ahead_ = 0;
+  if (ahead_batch_full_) {
+    /* The spec map cursor is at the frame after the batch */
+    AnalyzeFramesAhead();
+  }
+  if (n_frames_ahead_ == 0) {
+    std::vector<double>().swap(ahead_mse2e_);
+    std::vector<int>().swap(ahead_theta_bins_);
+  }
+}
+
+void FilamentSpecies::ReadSpecs() {
+  if (!use_spec_view_) {
+    Species::ReadSpecs();
+    return;
+  }
+  size_t offset = spec_map_.GetCursor();
+  if (i_read_ahead_ < n_frames_ahead_) {
+    /* Already analyzed, only the view of the frame is needed */
+    ispec_index_.RecordFrame(offset);
+    spec_map_.SetCursor(ahead_offsets_[++i_read_ahead_]);
+    return;
+  }
+  if (spec_view_.Parse(spec_map_, offset) &&
+      spec_view_.GetNMembers() == n_members_) {
+    ispec_index_.RecordFrame(offset);
+    spec_map_.SetCursor(offset + spec_view_.GetFrameSize());
+    return;
+  }
+  /* End of file, or the number of filaments changed. Continue reading the
+     file as a stream from this frame. */
+  use_spec_view_ = false;
+  spec_map_.Close();
+  ispec_file_.clear();
+  ispec_file_.seekg(offset);
+  Species::ReadSpecs();
+}
+
+void FilamentSpecies::CloseFiles() {
+  use_spec_view_ = false;
+  spec_map_.Close();
+  Species::CloseFiles();
+}
+
+/* Only the first process writes the outputs of a decomposed system */
+void FilamentSpecies::InitOutputFiles(std::string run_name) {
+  if (DomainsActive() && domains_->GetRank() != 0) {
+    return;
+  }
+  Species::InitOutputFiles(run_name);
+}
+
+void FilamentSpecies::WritePosits() {
+  if (!DomainsActive()) {
+    Species::WritePosits();
+    return;
+  }
+  std::vector<char> data;
+  int size = GatherMembers(&data, &Filament::WritePosit);
+  if (domains_->GetRank() == 0) {
+    oposit_file_.write(reinterpret_cast<char *>(&size), sizeof(size));
+    oposit_file_.write(data.data(), data.size());
+  }
+}
+
+void FilamentSpecies::WriteSpecFrame(std::fstream &ospec) {
+  if (!DomainsActive()) {
+    Species::WriteSpecFrame(ospec);
+    return;
+  }
+  std::vector<char> data;
+  /* The records are written on every process, so they are quantized there
+     rather than by the compressed spec stream of the first process */
+  double tolerance = (params_->spec_compression ? params_->spec_tolerance : 0);
+  int size = GatherMembers(&data, &Filament::WriteSpec, tolerance);
+  if (domains_->GetRank() == 0) {
+    ospec.write(reinterpret_cast<char *>(&size), sizeof(size));
+    ospec.write(data.data(), data.size());
+  }
+}
+
+void FilamentSpecies::WriteCheckpoints() {
+  if (!DomainsActive()) {
+    Species::WriteCheckpoints();
+    return;
+  }
+  std::vector<char> data;
+  int size = GatherMembers(&data, &Filament::WriteCheckpoint);
+  if (domains_->GetRank() != 0) {
+    return;
+  }
+  CheckpointOutput ocheck(checkpoint_file_);
+  std::fstream &ocheck_file = ocheck.GetStream();
+  long seed = rng_.GetSeed();
+  ocheck_file.write(reinterpret_cast<char *>(&seed), sizeof(seed));
+  ocheck_file.write(reinterpret_cast<char *>(&size), sizeof(size));
+  ocheck_file.write(data.data(), data.size());
+  ocheck.Commit();
+}
+
+/* Write every member with write into data, as the records gathered by
+   DomainDecomposition::GatherMembers, and gather them. Positions in spec
+   records are quantized to tolerance, if nonzero. */
+int FilamentSpecies::GatherMembers(std::vector<char> *data,
+                                   void (Filament::*write)(std::fstream &),
+                                   double tolerance) {
+  CheckpointBuffer buffer;
+  std::fstream records;
+  static_cast<std::ios &>(records).rdbuf(&buffer);
+  SpecCompression::SetTolerance(records, tolerance);
+  std::vector<char> &record_data = buffer.GetData();
+  for (auto it = members_.begin(); it != members_.end(); ++it) {
+    int mesh_id = it->GetMeshID();
+    int n_bytes = 0;
+    size_t start = record_data.size();
+    records.write(reinterpret_cast<char *>(&mesh_id), sizeof(mesh_id));
+    records.write(reinterpret_cast<char *>(&n_bytes), sizeof(n_bytes));
+    ((*it).*write)(records);
+    n_bytes = record_data.size() - start - 2 * sizeof(int);
+    memcpy(&record_data[start + sizeof(int)], &n_bytes, sizeof(n_bytes));
+  }
+  data->swap(record_data);
+  return domains_->GatherMembers(data);
+}
+
+/* Remove the members flagged in leaving, and add n_arriving members read
+   from their checkpoints in arriving. Filaments cannot be copied without
+   breaking the links between their sites and bonds, so the members after the
+   first one removed are rebuilt from their checkpoints too, the way members
+   are loaded from a checkpoint file. members_ never grows past the capacity
+   reserved for the whole species, so the other members stay in place. */
+void FilamentSpecies::ExchangeMembers(std::vector<bool> const &leaving,
+                                      std::fstream &arriving, int n_arriving) {
+  size_t first = std::find(leaving.begin(), leaving.end(), true) -
+                 leaving.begin();
+  CheckpointBuffer buffer;
+  std::fstream staying;
+  static_cast<std::ios &>(staying).rdbuf(&buffer);
+  int n_staying = 0;
+  for (size_t i = first; i < members_.size(); ++i) {
+    if (!leaving[i]) {
+      members_[i].WriteCheckpoint(staying);
+      n_staying++;
+    }
+  }
+  while (members_.size() > first) {
+    Species::PopMember();
+  }
+  if (members_.size() + n_staying + n_arriving > members_.capacity()) {
+    Logger::Error("Received more filaments than were inserted in the system");
+  }
+  buffer.Rewind();
+  AddCheckpointMembers(staying, n_staying);
+  AddCheckpointMembers(arriving, n_arriving);
+}
+
+void FilamentSpecies::AddCheckpointMembers(std::fstream &icheck, int n) {
+  for (int i = 0; i < n; ++i) {
+    Filament member;
+    members_.push_back(member);
+    members_.back().SetSID(GetSID());
+    members_.back().Init();
+    members_.back().ReadCheckpoint(icheck);
+    /* Rebuilt members measure their step displacement from here */
+    members_.back().ZeroDrStep();
+    n_members_++;
+  }
+}
+
+bool FilamentSpecView::Parse(const SpecMap &map, size_t offset) {
+  map_ = &map;
+  size_t const frame_offset = offset;
+  if (!map.InRange(offset, sizeof(int))) {
+    return false;
+  }
+  int n_members = map.Get<int>(offset);
+  if (n_members < 0) {
+    return false;
+  }
+  offset += sizeof(int);
+  member_offsets_.resize(n_members);
+  n_sites_.resize(n_members);
+  /* mesh_id, diameter, length, bond_length, n_sites */
+  size_t const head_size = 2 * sizeof(int) + 3 * sizeof(double);
+  for (int i = 0; i < n_members; ++i) {
+    if (!map.InRange(offset, head_size)) {
+      return false;
+    }
+    member_offsets_[i] = offset + sizeof(int);
+    int n_sites = map.Get<int>(offset + head_size - sizeof(int));
+    if (n_sites < 2) {
+      return false;
+    }
+    n_sites_[i] = n_sites;
+    size_t member_size = head_size + 3 * n_sites * sizeof(double) +
+                         sizeof(double) + sizeof(unsigned char);
+    if (!map.InRange(offset, member_size)) {
+      return false;
+    }
+    offset += member_size;
+  }
+  frame_size_ = offset - frame_offset;
+  return true;
+}
+
 void FilamentSpecies::FinalizeAnalysis() {
   if (spiral_file_.is_open()) {
     spiral_file_.close();
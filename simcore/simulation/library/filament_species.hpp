@@ -1,7 +1,9 @@
 #ifndef _SIMCORE_FILAMENT_SPECIES_H_
 #define _SIMCORE_FILAMENT_SPECIES_H_
 
+#include "domain_decomposition.hpp"
 #include "filament.hpp"
+#include "spec_map.hpp"
 #include "species.hpp"
 
 typedef std::vector<Filament>::iterator filament_iterator;
@@ -13,6 +15,45 @@ typedef std::vector<
 #include "omp.h"
 #endif
 
+/* View of one filament spec frame in a mapped spec file, following the
+   layout written by Filament::WriteSpec:
+
+     int n_members, then for each member:
+       int mesh_id, double diameter, double length, double bond_length,
+       int n_sites, double[3] position[n_sites], double persistence_length,
+       unsigned char poly
+
+   Parsing only records the offset of every member in the file. */
+class FilamentSpecView {
+private:
+  const SpecMap *map_ = nullptr;
+  std::vector<size_t> member_offsets_; // offset of each member's diameter
+  std::vector<int> n_sites_;
+  size_t frame_size_ = 0;
+
+public:
+  bool Parse(const SpecMap &map, size_t offset);
+  int GetNMembers() const { return n_sites_.size(); }
+  size_t GetFrameSize() const { return frame_size_; }
+  int GetNSites(int i) const { return n_sites_[i]; }
+  double GetDiameter(int i) const {
+    return map_->Get<double>(member_offsets_[i]);
+  }
+  double GetLength(int i) const {
+    return map_->Get<double>(member_offsets_[i] + sizeof(double));
+  }
+  double GetBondLength(int i) const {
+    return map_->Get<double>(member_offsets_[i] + 2 * sizeof(double));
+  }
+  /* Coordinate dim of every site position of member i */
+  SpecView<double> GetSitePositions(int i, int dim) const {
+    const char *sites = map_->GetData() + member_offsets_[i] +
+                        3 * sizeof(double) + sizeof(int);
+    return SpecView<double>(sites + dim * sizeof(double), n_sites_[i],
+                            3 * sizeof(double));
+  }
+};
+
 class FilamentSpecies : public Species<Filament> {
 protected:
   bool midstep_;
@@ -48,6 +89,40 @@ protected:
   std::fstream crossing_file_;
   std::fstream polar_order_avg_file_;
   std::fstream in_out_file_;
+  /* Memory-mapped spec input, used during analysis in place of ReadSpec when
+     the requested analyses can read frames directly from the file */
+  SpecMap spec_map_;
+  FilamentSpecView spec_view_;
+  bool spec_views_enabled_ = false;
+  bool use_spec_view_ = false;
+  std::vector<double> view_thetas_;
+  /* Results of spec frames analyzed ahead of the processing loop, in
+     batches of at most max_ahead_values_ results */
+  static const size_t max_ahead_values_ = 1 << 16;
+  std::vector<size_t> ahead_offsets_;
+  std::vector<double> ahead_mse2e_;
+  std::vector<int> ahead_theta_bins_;
+  std::vector<size_t> ahead_theta_start_;
+  int n_frames_ahead_ = 0;
+  int i_read_ahead_ = 0;
+  int i_analyzed_ahead_ = 0;
+  bool ahead_batch_full_ = false;
+  void InitSpecView();
+  void AnalyzeFramesAhead();
+  void AddFrameAhead();
+  int GetThetaBin(double cos_theta) const;
+  double GetViewMse2e(const FilamentSpecView &view, int i_member) const;
+  void GetViewThetas(const FilamentSpecView &view, int i_member,
+                     std::vector<double> *cos_thetas) const;
+  /* Set when the system is split across processes */
+  DomainDecomposition *domains_ = nullptr;
+  bool DomainsActive() const {
+    return domains_ != nullptr && domains_->IsActive();
+  }
+  int GatherMembers(std::vector<char> *data,
+                    void (Filament::*write)(std::fstream &),
+                    double tolerance = 0);
+  void AddCheckpointMembers(std::fstream &icheck, int n);
 
 public:
   FilamentSpecies();
@@ -62,6 +137,16 @@ public:
   // Redundant for filaments.
   virtual void CenteredOrientedArrangement() {}
 
+  void EnableSpecViews() { spec_views_enabled_ = true; }
+  void ReadSpecs();
+  void CloseFiles();
+  void InitOutputFiles(std::string run_name);
+  void WritePosits();
+  void WriteSpecFrame(std::fstream &ospec);
+  void WriteCheckpoints();
+  void ExchangeMembers(std::vector<bool> const &leaving,
+                       std::fstream &arriving, int n_arriving);
+
   void InitAnalysis();
   void RunAnalysis();
   void FinalizeAnalysis();
@@ -93,11 +93,11 @@ public:
     } else if (k_min > 0) {
       min_roll_ = CDF(k_min);
       max_roll_ = CDF(k_max);
-      Logger::Trace("Renormalizing rolls in FlorySchulz generator to have a "
-                    "minimum of %2.2f and maximum of %2.2f to avoid lengths "
-                    "shorter than minimum length of %2.2f and maximum length "
-                    "of %2.2f",
-                    min_roll_, max_roll_, k_min, k_max);
+      LOG_TRACE("Renormalizing rolls in FlorySchulz generator to have a "
+                "minimum of %2.2f and maximum of %2.2f to avoid lengths "
+                "shorter than minimum length of %2.2f and maximum length "
+                "of %2.2f",
+                min_roll_, max_roll_, k_min, k_max);
     }
   }
   /* Given a uniform random number in the range of 0 and 1 (roll), return its
@@ -110,9 +110,9 @@ public:
       roll = (max_roll_ - min_roll_) * roll + min_roll_;
     }
     double result = Bisection(roll);
-    Logger::Trace("FlorySchulz generator received a roll of %2.2f and returned "
-                  "a length of %2.2f",
-                  roll, result);
+    LOG_TRACE("FlorySchulz generator received a roll of %2.2f and returned "
+              "a length of %2.2f",
+              roll, result);
     return result;
   }
 };
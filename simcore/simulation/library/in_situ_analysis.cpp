@@ -0,0 +1,116 @@
+#include "in_situ_analysis.hpp"
+
+void InSituAnalysis::Init(system_parameters *params) {
+  params_ = *params;
+  static_cast<std::ios &>(frame_stream_).rdbuf(&frame_buffer_);
+  stop_ = busy_ = false;
+  worker_ = std::thread(&InSituAnalysis::Run, this);
+}
+
+/* Analyze spec frames of spec in situ, using snapshot, a new species of the
+   same type, to hold them. Snapshot members are created the way
+   post-processing creates them. */
+void InSituAnalysis::AddSpecies(SpeciesBase *spec, SpeciesBase *snapshot,
+                                space_struct *space) {
+  LOG_DEBUG("Analyzing species %s in situ", spec->GetSID()._to_string());
+  snapshot->Init(&params_, space, params_.seed);
+  snapshot->Reserve();
+  for (int i = 0; i < snapshot->GetNInsert(); ++i) {
+    snapshot->AddMember();
+  }
+  species_.push_back(spec);
+  snapshots_.push_back(snapshot);
+  initialized_.push_back(false);
+}
+
+/* Take snapshots of the species with a spec frame on this step and hand
+   them to the helper thread. Like post-processing, frames from the
+   equilibration steps are not analyzed. */
+void InSituAnalysis::Update(int i_step) {
+  if (i_step <= params_.n_steps_equil) {
+    return;
+  }
+  bool snapshot_taken = false;
+  for (int i = 0; i < species_.size(); ++i) {
+    if (i_step % species_[i]->GetNSpec() != 0) {
+      continue;
+    }
+    if (!snapshot_taken) {
+      Wait();
+      pending_.clear();
+      snapshot_taken = true;
+    }
+    SimulationContext::Counters counters =
+        SimulationContext::Current().SaveCounters();
+    frame_buffer_.GetData().clear();
+    frame_stream_.clear();
+    species_[i]->WriteSpecFrame(frame_stream_);
+    frame_buffer_.Rewind();
+    snapshots_[i]->ReadSpecFrame(frame_stream_);
+    SimulationContext::Current().RestoreCounters(counters);
+    pending_.push_back(i);
+  }
+  if (!snapshot_taken) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    params_.i_step = i_step;
+    busy_ = true;
+  }
+  cv_.notify_all();
+}
+
+void InSituAnalysis::Run() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (true) {
+    cv_.wait(lk, [this] { return busy_ || stop_; });
+    if (!busy_) {
+      return;
+    }
+    lk.unlock();
+    for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+      /* InitAnalysis also analyzes the first frame */
+      if (!initialized_[*it]) {
+        snapshots_[*it]->InitAnalysis();
+        initialized_[*it] = true;
+      } else {
+        snapshots_[*it]->RunAnalysis();
+      }
+    }
+    lk.lock();
+    busy_ = false;
+    cv_.notify_all();
+  }
+}
+
+/* Wait for the helper thread to finish analyzing the last snapshots */
+void InSituAnalysis::Wait() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  cv_.wait(lk, [this] { return !busy_; });
+}
+
+/* Finish the analyses and write their results */
+void InSituAnalysis::Finalize() {
+  if (!worker_.joinable()) {
+    return;
+  }
+  Wait();
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+  for (int i = 0; i < snapshots_.size(); ++i) {
+    if (initialized_[i]) {
+      snapshots_[i]->FinalizeAnalysis();
+    }
+    snapshots_[i]->CleanUp();
+    delete snapshots_[i];
+  }
+  species_.clear();
+  snapshots_.clear();
+  initialized_.clear();
+  pending_.clear();
+}
@@ -0,0 +1,46 @@
+#ifndef _SIMCORE_IN_SITU_ANALYSIS_H_
+#define _SIMCORE_IN_SITU_ANALYSIS_H_
+
+#include "checkpoint_writer.hpp"
+#include "species.hpp"
+
+/* Runs species analyses during the simulation rather than in post-processing,
+   so analyzed species do not need spec files. Every analyzed species has a
+   snapshot species of the same type that is only ever updated from spec
+   frames, so its analyses see exactly the state post-processing would read
+   from the spec file and write the same analysis files.
+
+   On each spec step of a species, its spec frame is serialized in memory and
+   read into the snapshot on the simulation thread, and the snapshot analyses
+   then run on a helper thread while the simulation continues. The simulation
+   only waits if the previous frame is still being analyzed when the next
+   snapshot is taken. */
+class InSituAnalysis {
+private:
+  /* Parameters of the snapshot species, which analyses may modify */
+  system_parameters params_;
+  std::vector<SpeciesBase *> species_;
+  std::vector<SpeciesBase *> snapshots_;
+  std::vector<bool> initialized_;
+  /* Snapshots taken on the current step, to be analyzed */
+  std::vector<int> pending_;
+  CheckpointBuffer frame_buffer_;
+  std::fstream frame_stream_;
+  bool busy_ = false;
+  bool stop_ = false;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::thread worker_;
+  void Run();
+  void Wait();
+
+public:
+  InSituAnalysis() {}
+  void Init(system_parameters *params);
+  void AddSpecies(SpeciesBase *spec, SpeciesBase *snapshot,
+                  space_struct *space);
+  void Update(int i_step);
+  void Finalize();
+};
+
+#endif // _SIMCORE_IN_SITU_ANALYSIS_H_
@@ -13,6 +13,7 @@ public:
   Object *obj1 = nullptr;
   Object *obj2 = nullptr;
   bool boundary = false; // true if boundary interaction
+  bool ghost = false;    // true if one object is owned by another process
   double force[3] = {0}; // force acting on obj1 due to obj2
   double t1[3] = {0};    // torque acting on obj1
   double t2[3] = {0};    // torque acting on obj2
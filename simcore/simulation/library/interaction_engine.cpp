@@ -10,6 +10,7 @@ void InteractionEngine::Init(system_parameters *params,
   species_ = species;
   space_ = space;
   processing_ = processing;
+  domains_ = SimulationContext::Current().domains;
 
   // Initialize owned structures
   no_init_ = false;
@@ -18,7 +19,25 @@ void InteractionEngine::Init(system_parameters *params,
   n_dim_ = params_->n_dim;
   n_periodic_ = params_->n_periodic;
   n_update_ = params_->n_update_cells;
+  n_respa_ = params_->n_respa;
   n_thermo_ = params_->n_thermo;
+  std::fill(stress_, stress_ + 9, 0);
+  if (n_respa_ < 1) {
+    Logger::Error("n_respa must be at least 1, got %d", n_respa_);
+  }
+  /* Impulses are n_respa steps of pair forces, which only holds while every
+     step has the same length, and the stress only averages to that of every
+     step over whole numbers of evaluations */
+  if (n_respa_ > 1 && params_->adaptive_delta) {
+    Logger::Error("n_respa > 1 cannot be combined with adaptive_delta");
+  }
+  if (n_respa_ > 1 && n_thermo_ % (2 * n_respa_) != 0 &&
+      (params_->thermo_flag || params_->constant_pressure ||
+       params_->constant_volume)) {
+    Logger::Error("n_thermo must be a multiple of 2 * n_respa, got n_thermo "
+                  "= %d and n_respa = %d",
+                  n_thermo_, n_respa_);
+  }
   no_interactions_ = !(params_->interaction_flag);
   i_update_ = -1;
   n_objs_ = -1;
@@ -74,28 +93,60 @@ void InteractionEngine::Interact() {
   if (no_interactions_ && no_boundaries_)
     return;
   // Check if we need to update objects in cell list
-  CheckUpdateObjects();
+  {
+    ProfileTimer timer(profile_phase::update_objects);
+    CheckUpdateObjects();
+  }
+  {
+    ProfileTimer timer(profile_phase::halo_exchange);
+    CheckUpdateDomains();
+  }
   // Update crosslinks
-  xlink_.UpdateCrosslinks();
+  {
+    ProfileTimer timer(profile_phase::update_xlinks);
+    xlink_.UpdateCrosslinks();
+  }
   // Check if we need to update crosslink interactors
-  CheckUpdateXlinks();
-  CheckUpdateInteractions();
+  {
+    ProfileTimer timer(profile_phase::update_neighbors);
+    CheckUpdateXlinks();
+    CheckUpdateInteractions();
+  }
 
   /* Update anchors and crosslinks */
   // Loop through and calculate interactions
+  bool respa_step = IsRespaStep();
   if (!no_interactions_) {
-    CalculatePairInteractions();
+    ProfileTimer timer(profile_phase::pair_interactions);
+    if (respa_step) {
+      CalculatePairInteractions();
+      StepProfiler::CountPairs(pair_interactions_.size());
+    } else if (!pairs_evaluated_) {
+      /* Pairs made since the last evaluation have no potential yet */
+      CalculatePairInteractions();
+    } else {
+      CalculateCrosslinkNeighbors();
+    }
+  }
+  {
+    ProfileTimer timer(profile_phase::boundary_interactions);
+    CalculateBoundaryInteractions();
   }
-  CalculateBoundaryInteractions();
   // Apply forces, torques, and potentials in serial
-  if (!no_interactions_) {
-    ApplyPairInteractions();
+  {
+    ProfileTimer timer(profile_phase::apply_interactions);
+    if (!no_interactions_ && respa_step) {
+      ApplyPairInteractions();
+    } else if (!no_interactions_) {
+      ApplyPairPotentials();
+    }
+    ApplyBoundaryInteractions();
   }
-  ApplyBoundaryInteractions();
 
-  if (params_->in_out_flag) {
+  /* Interactions are only counted on steps that evaluate them */
+  if (params_->in_out_flag && respa_step) {
     if (n_interactions_ == 0 && in_out_flag_) {
-      early_exit = true;
+      SimulationContext::Current().early_exit = true;
     } else if (n_interactions_ > 0 && !in_out_flag_) {
       in_out_flag_ = true;
     }
@@ -120,6 +171,39 @@ void InteractionEngine::CheckUpdateXlinks() {
     return;
   }
 }
+/* With the system split across processes, the neighbor lists of every
+   process are rebuilt on the same step, whenever one of them needs it, since
+   rebuilding exchanges ghosts. Filaments only move to another process on
+   odd steps, where they are in their full step configuration, and between
+   rebuilds only the positions of the ghosts are sent. */
+void InteractionEngine::CheckUpdateDomains() {
+  if (domains_ == nullptr || !domains_->IsActive())
+    return;
+  bool update = CheckSpeciesInteractorUpdate() || CountSpecies() != n_objs_;
+  if (n_update_ <= 0) {
+    update = update || GetDrMax() > dr_update_;
+  } else {
+    update = update || (++i_update_) % n_update_ == 0;
+  }
+  if (!domains_->AnyProcess(update)) {
+    domains_->UpdateGhosts();
+    return;
+  }
+  domains_->Exchange(*i_step_ % 2 == 1);
+  /* Filaments rebuilt by the exchange flag an interactor update */
+  CheckSpeciesInteractorUpdate();
+  i_update_ = 0;
+  n_objs_ = CountSpecies();
+  ForceUpdate();
+  ZeroDrTot();
+}
+
+/* Distance within which objects may come to interact before the next
+   neighbor list rebuild, when each may have moved half a cell length */
+double InteractionEngine::GetInteractionRange() {
+  return sqrt(potentials_.GetRCut2()) + 2 * sqrt(dr_update_);
+}
+
 void InteractionEngine::ForceUpdate() {
   UpdateInteractors();
   UpdateInteractions();
@@ -132,6 +216,9 @@ void InteractionEngine::UpdateInteractors() {
        ++spec_it) {
     (*spec_it)->GetInteractors(&ix_objects_);
   }
+  if (domains_ != nullptr && domains_->IsActive()) {
+    domains_->GetGhostInteractors(&ix_objects_);
+  }
   // Add crosslinks as interactors
   interactors_.insert(interactors_.end(), ix_objects_.begin(),
                       ix_objects_.end());
@@ -140,67 +227,75 @@ void InteractionEngine::UpdateInteractors() {
   interactors_.insert(interactors_.end(), xlinks.begin(), xlinks.end());
 }
 
-/* Checks whether or not the given anchor is supposed to be attached to the
-   given bond by checking mesh_id of both the bond and the anchor. If they
-   match, the anchor is attached to the mesh using the anchor mesh_lambda */
-bool InteractionEngine::CheckBondAnchorPair(Object *anchor, Object *bond) {
-  // Check that the bond and anchor share a mesh_id
-  if (anchor->GetMeshID() == bond->GetMeshID()) {
-    Anchor *a = dynamic_cast<Anchor *>(anchor);
-    if (a == nullptr) {
-      Logger::Error("Object pointer was unsuccessfully dynamically cast to an "
-                    "Anchor pointer in CheckBondAnchorPair!");
-    }
-    if (bond->GetType() != +obj_type::bond) {
-      Logger::Error(
-          "CheckBondAnchorPair expected Bond object pointer, but object"
-          " pointer does not have bond obj_type!");
-    }
-    // Check that the anchor isn't already attached
-    if (a->GetBondLambda() < 0) {
-      a->AttachObjMeshLambda(bond, a->GetMeshLambda());
-      return true;
-    }
-  }
-  return false;
-}
-
+/* Attaches the given anchor to the bond it was attached to when the
+   checkpoint was written, found using the anchor mesh_id and bond number. The
+   anchor is attached to the mesh using the anchor mesh_lambda. */
+bool InteractionEngine::AttachAnchorToMesh(
+    Object *anchor, std::unordered_map<int, Mesh *> &meshes) {
+  Anchor *a = dynamic_cast<Anchor *>(anchor);
+  if (a == nullptr) {
+    Logger::Error("Object pointer was unsuccessfully dynamically cast to an "
+                  "Anchor pointer in AttachAnchorToMesh!");
+  }
+  // Check that the anchor isn't already attached
+  if (a->GetBondLambda() >= 0) {
+    return false;
+  }
+  auto mesh_it = meshes.find(a->GetMeshID());
+  if (mesh_it == meshes.end()) {
+    Logger::Warning("No mesh found with mesh_id %d for reloaded anchor",
+                    a->GetMeshID());
+    return false;
+  }
+  Mesh *mesh = mesh_it->second;
+  int bond_number = a->GetReloadBondNumber();
+  /* Anchors of checkpoints made from spec files were never attached to a
+     bond, so their bond is found from their position along the mesh */
+  if (bond_number < 0) {
+    a->AttachObjMeshLambda(mesh->GetBondAtLambda(a->GetMeshLambda()),
+                           a->GetMeshLambda());
+    return true;
+  }
+  if (bond_number >= mesh->GetNBonds()) {
+    Logger::Warning("Reloaded anchor bond number %d out of range for mesh %d "
+                    "with %d bonds",
+                    bond_number, a->GetMeshID(), mesh->GetNBonds());
+    return false;
+  }
+  a->AttachObjMeshLambda(mesh->GetBond(bond_number), a->GetMeshLambda());
+  return true;
+}
+
+/* Reattaches anchors reloaded from checkpoints to their bonds. Meshes are
+   looked up by mesh_id, and bonds by the bond number stored in the
+   checkpoint, so no pair generation is needed. */
 void InteractionEngine::PairBondCrosslinks() {
-  Logger::Trace("Pairing bound crosslinks and objects");
+  LOG_TRACE("Pairing bound crosslinks and objects");
   ix_objects_.clear();
-  interactors_.clear();
-  // First get object interactors (non-crosslinks)
   for (auto spec_it = species_->begin(); spec_it != species_->end();
        ++spec_it) {
     (*spec_it)->GetInteractors(&ix_objects_);
   }
-  interactors_.insert(interactors_.end(), ix_objects_.begin(),
-                      ix_objects_.end());
-
-  // Add anchors as interactors
+  std::unordered_map<int, Mesh *> meshes;
+  for (auto obj = ix_objects_.begin(); obj != ix_objects_.end(); ++obj) {
+    if ((*obj)->GetType() != +obj_type::bond ||
+        meshes.count((*obj)->GetMeshID())) {
+      continue;
+    }
+    Bond *bond = dynamic_cast<Bond *>(*obj);
+    Mesh *mesh = dynamic_cast<Mesh *>(bond->GetMeshPtr());
+    if (mesh == nullptr) {
+      Logger::Error("Bond with mesh_id %d is not referencing a mesh!",
+                    bond->GetMeshID());
+    }
+    meshes[bond->GetMeshID()] = mesh;
+  }
   std::vector<Object *> anchors;
   xlink_.GetAnchorInteractors(anchors);
-  interactors_.insert(interactors_.end(), anchors.begin(), anchors.end());
-  pair_interactions_.clear();
-  clist_.RenewObjectsCells(interactors_);
-  clist_.MakePairs(pair_interactions_);
   int n_anchors_attached = 0;
-  // for (auto ix = anchors.begin(); ix != anchors.end(); ++ix) {
-  // for (auto jx = ix_objects_.begin(); jx != ix_objects_.end(); ++jx) {
-  for (auto ix = pair_interactions_.begin(); ix != pair_interactions_.end();
-       ++ix) {
-    Object *obj1 = ix->obj1;
-    Object *obj2 = ix->obj2;
-    if (obj1->GetSID() == +species_id::crosslink &&
-        obj2->GetType() == +obj_type::bond) {
-      if (CheckBondAnchorPair(obj1, obj2))
-        // if (CheckBondAnchorPair(*ix, *jx))
-        n_anchors_attached++;
-    } else if (obj2->GetSID() == +species_id::crosslink &&
-               obj1->GetType() == +obj_type::bond) {
-      if (CheckBondAnchorPair(obj2, obj1)) {
-        n_anchors_attached++;
-      }
+  for (auto anchor = anchors.begin(); anchor != anchors.end(); ++anchor) {
+    if (AttachAnchorToMesh(*anchor, meshes)) {
+      n_anchors_attached++;
     }
   }
   /* Check that all anchors found their bond attachments */
@@ -221,6 +316,11 @@ void InteractionEngine::UpdatePairInteractions() {
   pair_interactions_.clear();
   clist_.RenewObjectsCells(interactors_);
   clist_.MakePairs(pair_interactions_);
+  if (domains_ != nullptr && domains_->IsActive()) {
+    domains_->FilterPairs(&pair_interactions_);
+  }
+  pairs_evaluated_ = false;
+  StepProfiler::CountRebuild();
 }
 
 void InteractionEngine::UpdateBoundaryInteractions() {
@@ -261,6 +361,9 @@ void InteractionEngine::CheckUpdateObjects() {
     return;
   if (static_pnumber_)
     return;
+  /* Rebuilds of a system split across processes are made together */
+  if (domains_ != nullptr && domains_->IsActive())
+    return;
   bool ix_update = CheckSpeciesInteractorUpdate();
   int obj_count = CountSpecies();
   if (obj_count != n_objs_ || ix_update) {
@@ -276,6 +379,8 @@ void InteractionEngine::CheckUpdateObjects() {
 void InteractionEngine::ResetCellList() { clist_.ResetNeighbors(); }
 
 void InteractionEngine::CheckUpdateInteractions() {
+  if (domains_ != nullptr && domains_->IsActive())
+    return;
   /* If n_update_ <=0, we update nearest neighbors if any particle
      has moved a distance further than dr_update_ */
   if (n_update_ <= 0 && GetDrMax() > dr_update_) {
@@ -311,12 +416,13 @@ void InteractionEngine::ZeroDrTot() {
   }
 }
 
+template <int N_DIM>
 void InteractionEngine::ProcessPairInteraction(ix_iterator ix) {
   // Avoid certain types of interactions
   Object *obj1 = ix->obj1;
   Object *obj2 = ix->obj2;
-  Logger::Trace("Processing interaction between %d and %d", obj1->GetOID(),
-                obj2->GetOID());
+  LOG_TRACE("Processing interaction between %d and %d", obj1->GetOID(),
+            obj2->GetOID());
   // Rigid objects don't self interact
   // if (obj1->GetRID() == obj2->GetRID())  return;
   // Composite objects do self interact if they want to
@@ -378,7 +484,7 @@ void InteractionEngine::ProcessPairInteraction(ix_iterator ix) {
     // obj2->GetSID()._to_string());
   }
 
-  mindist_.ObjectObject(*ix);
+  mindist_.ObjectObject<N_DIM>(*ix);
 
   // XXX Don't interact if we have an overlap. This should eventually go to a
   // max force routine
@@ -389,7 +495,7 @@ void InteractionEngine::ProcessPairInteraction(ix_iterator ix) {
   if (ix->dr_mag2 > potentials_.GetRCut2())
     return;
   /* Calculates forces from the potential defined during initialization */
-  potentials_.CalcPotential(*ix);
+  potentials_.CalcPotential<N_DIM>(*ix);
 }
 
 void InteractionEngine::ProcessBoundaryInteraction(ix_iterator ix) {
@@ -442,7 +548,17 @@ void InteractionEngine::CalculateBoundaryInteractions() {
 #endif
 }
 
+/* The pair kernels are specialized on the dimension of the run */
 void InteractionEngine::CalculatePairInteractions() {
+  if (n_dim_ == 2) {
+    CalculatePairInteractions<2>();
+  } else {
+    CalculatePairInteractions<3>();
+  }
+  pairs_evaluated_ = true;
+}
+
+template <int N_DIM> void InteractionEngine::CalculatePairInteractions() {
 #ifdef ENABLE_OPENMP
   int max_threads = omp_get_max_threads();
   std::vector<std::pair<ix_iterator, ix_iterator>> chunks;
@@ -461,43 +577,95 @@ void InteractionEngine::CalculatePairInteractions() {
 #pragma omp for
     for (int i = 0; i < max_threads; ++i) {
       for (auto ix = chunks[i].first; ix != chunks[i].second; ++ix) {
-        ProcessPairInteraction(ix);
+        ProcessPairInteraction<N_DIM>(ix);
         // Do torque crossproducts
-        cross_product(ix->contact1, ix->force, ix->t1, 3);
-        cross_product(ix->contact2, ix->force, ix->t2, 3);
+        cross_product<N_DIM>(ix->contact1, ix->force, ix->t1);
+        cross_product<N_DIM>(ix->contact2, ix->force, ix->t2);
       }
     }
   }
 #else
   for (auto ix = pair_interactions_.begin(); ix != pair_interactions_.end();
        ++ix) {
-    ProcessPairInteraction(ix);
+    ProcessPairInteraction<N_DIM>(ix);
     // Do torque crossproducts
-    cross_product(ix->contact1, ix->force, ix->t1, 3);
-    cross_product(ix->contact2, ix->force, ix->t2, 3);
+    cross_product<N_DIM>(ix->contact1, ix->force, ix->t1);
+    cross_product<N_DIM>(ix->contact2, ix->force, ix->t2);
   }
 #endif
 }
 
+/* With multiple time stepping, pair forces are evaluated on the midstep and
+   full step of one of every n_respa integration steps, so that species
+   integrated in two half steps see the same impulses as the others */
+bool InteractionEngine::IsRespaStep() const {
+  return n_respa_ == 1 || ((*i_step_ - 1) / 2) % n_respa_ == 0;
+}
+
+/* Crosslink anchors find the objects they may bind to from their pair
+   interactions, which they need on every step */
+void InteractionEngine::CalculateCrosslinkNeighbors() {
+  if (n_dim_ == 2) {
+    CalculateCrosslinkNeighbors<2>();
+  } else {
+    CalculateCrosslinkNeighbors<3>();
+  }
+}
+
+template <int N_DIM> void InteractionEngine::CalculateCrosslinkNeighbors() {
+  for (auto ix = pair_interactions_.begin(); ix != pair_interactions_.end();
+       ++ix) {
+    if (ix->obj1->GetSID() == +species_id::crosslink ||
+        ix->obj2->GetSID() == +species_id::crosslink) {
+      ProcessPairInteraction<N_DIM>(ix);
+    }
+  }
+}
+
 void InteractionEngine::ApplyPairInteractions() {
+  /* Forces evaluated once every n_respa steps are applied as impulses */
+  double impulse = n_respa_;
   for (auto ix = pair_interactions_.begin(); ix != pair_interactions_.end();
        ++ix) {
     Object *obj1 = ix->obj1;
     Object *obj2 = ix->obj2;
-    obj1->AddForce(ix->force);
-    obj2->SubForce(ix->force);
-    obj1->AddTorque(ix->t1);
-    obj2->SubTorque(ix->t2);
+    double force[3], t1[3], t2[3];
+    double force2 = 0;
+    for (int i = 0; i < 3; ++i) {
+      force[i] = impulse * ix->force[i];
+      t1[i] = impulse * ix->t1[i];
+      t2[i] = impulse * ix->t2[i];
+      force2 += ix->force[i] * ix->force[i];
+    }
+    if (force2 > max_pair_force2_) {
+      max_pair_force2_ = force2;
+    }
+    obj1->AddForce(force);
+    obj2->SubForce(force);
+    obj1->AddTorque(t1);
+    obj2->SubTorque(t2);
     obj1->AddPotential(ix->pote);
     obj2->AddPotential(ix->pote);
+    /* The owner of a ghost counts the other half of the pair's stress */
+    double weight = impulse * (ix->ghost ? 0.5 : 1);
     for (int i = 0; i < n_dim_; ++i) {
       for (int j = 0; j < n_dim_; ++j) {
-        stress_[n_dim_ * i + j] += ix->stress[n_dim_ * i + j];
+        stress_[n_dim_ * i + j] += weight * ix->stress[n_dim_ * i + j];
       }
     }
   }
 }
 
+/* Between evaluations, the pair potentials of the last one still count
+   towards the potential energies of the objects on every step */
+void InteractionEngine::ApplyPairPotentials() {
+  for (auto ix = pair_interactions_.begin(); ix != pair_interactions_.end();
+       ++ix) {
+    ix->obj1->AddPotential(ix->pote);
+    ix->obj2->AddPotential(ix->pote);
+  }
+}
+
 void InteractionEngine::ApplyBoundaryInteractions() {
   for (auto ix = boundary_interactions_.begin();
        ix != boundary_interactions_.end(); ++ix) {
@@ -516,6 +684,11 @@ void InteractionEngine::ApplyBoundaryInteractions() {
 // Compute pressure tensor after n_thermo_ steps
 void InteractionEngine::CalculatePressure() {
   double inv_V = 1.0 / space_->volume;
+  double n_objs = n_objs_;
+  if (domains_ != nullptr && domains_->IsActive()) {
+    domains_->SumOverProcesses(stress_, 9);
+    domains_->SumOverProcesses(&n_objs, 1);
+  }
   std::fill(space_->pressure_tensor, space_->pressure_tensor + 9, 0);
   // Calculate pressure tensor from stress tensor (only physical for periodic
   // subspace)
@@ -523,7 +696,7 @@ void InteractionEngine::CalculatePressure() {
     for (int j = 0; j < n_dim_; ++j) {
       // Add particle density along principle axes
       if (i == j) {
-        space_->pressure_tensor[n_dim_ * i + j] += n_objs_ * inv_V;
+        space_->pressure_tensor[n_dim_ * i + j] += n_objs * inv_V;
       }
       // Add time-averaged virial component
       space_->pressure_tensor[n_dim_ * i + j] +=
@@ -701,10 +874,14 @@ void InteractionEngine::DrawInteractions(
   xlink_.Draw(graph_array);
 }
 
-void InteractionEngine::WriteOutputs() {
+void InteractionEngine::WriteOutputs(int i_step) {
   if (params_->crosslink.concentration < 1e-12)
     return;
-  xlink_.WriteOutputs();
+  xlink_.WriteOutputs(i_step);
+}
+
+void InteractionEngine::SetTimeStep(double delta) {
+  xlink_.SetTimeStep(delta);
 }
 
 void InteractionEngine::InitOutputs(bool reading_inputs, bool reduce_flag,
@@ -718,6 +895,18 @@ void InteractionEngine::InitOutputs(bool reading_inputs, bool reduce_flag,
   }
 }
 
+int InteractionEngine::GetLastIndexedStep() {
+  if (params_->crosslink.concentration < 1e-12)
+    return INT_MAX;
+  return xlink_.GetLastIndexedStep();
+}
+
+bool InteractionEngine::SeekInputs(int i_step) {
+  if (params_->crosslink.concentration < 1e-12)
+    return true;
+  return xlink_.SeekInputs(i_step);
+}
+
 void InteractionEngine::ReadInputs() {
   if (params_->crosslink.concentration < 1e-12)
     return;
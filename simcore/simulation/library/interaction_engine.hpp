@@ -5,9 +5,11 @@
 #include "auxiliary.hpp"
 #include "cell_list.hpp"
 #include "crosslink_manager.hpp"
+#include "domain_decomposition.hpp"
 #include "minimum_distance.hpp"
 #include "potential_manager.hpp"
 #include "species.hpp"
+#include "step_profiler.hpp"
 #include "struct_analysis.hpp"
 
 #ifdef ENABLE_OPENMP
@@ -18,18 +20,22 @@ typedef std::vector<Interaction>::iterator ix_iterator;
 
 class InteractionEngine {
 private:
+  UNIT_TESTER;
   double stress_[9];
   double dr_update_;
+  double max_pair_force2_ = 0;
   bool overlap_;
   bool no_interactions_;
   bool no_boundaries_;
   bool no_init_ = true;
   bool processing_ = false;
   bool in_out_flag_ = false;
+  bool pairs_evaluated_ = false;
   int n_dim_;
   int n_periodic_;
   int i_update_;
   int n_update_;
+  int n_respa_;
   int n_objs_;
   int n_thermo_;
   int static_pnumber_;
@@ -38,6 +44,7 @@ private:
   system_parameters *params_;
   space_struct *space_;
   std::vector<SpeciesBase *> *species_;
+  DomainDecomposition *domains_ = nullptr;
 
   MinimumDistance mindist_;
   StructAnalysis struct_analysis_;
@@ -52,22 +59,29 @@ private:
 
   const bool CheckSpeciesInteractorUpdate() const;
   void CheckUpdateXlinks();
+  void CheckUpdateDomains();
   void CheckUpdateInteractions();
   void UpdateInteractors();
   void UpdateInteractions();
   void UpdatePairInteractions();
   void UpdateBoundaryInteractions();
-  void ProcessPairInteraction(ix_iterator ix);
+  template <int N_DIM> void ProcessPairInteraction(ix_iterator ix);
   void ProcessBoundaryInteraction(ix_iterator ix);
+  bool IsRespaStep() const;
   void CalculatePairInteractions();
+  template <int N_DIM> void CalculatePairInteractions();
+  void CalculateCrosslinkNeighbors();
+  template <int N_DIM> void CalculateCrosslinkNeighbors();
   void CalculateBoundaryInteractions();
   void ApplyPairInteractions();
+  void ApplyPairPotentials();
   void ApplyBoundaryInteractions();
   double GetDrMax();
   void ZeroDrTot();
   int CountSpecies();
   void PairBondCrosslinks();
-  bool CheckBondAnchorPair(Object *anchor, Object *bond);
+  bool AttachAnchorToMesh(Object *anchor,
+                          std::unordered_map<int, Mesh *> &meshes);
 
 public:
   InteractionEngine() {}
@@ -83,12 +97,20 @@ public:
   void StructureAnalysis();
   void CalculateStructure();
   void ForceUpdate();
+  double GetInteractionRange();
   void CheckUpdateObjects();
   void DrawInteractions(std::vector<graph_struct *> *graph_array);
-  void WriteOutputs();
+  void WriteOutputs(int i_step);
+  void SetTimeStep(double delta);
+  /* Largest pair force magnitude applied since the last call to
+     ZeroMaxPairForce */
+  double GetMaxPairForce() const { return sqrt(max_pair_force2_); }
+  void ZeroMaxPairForce() { max_pair_force2_ = 0; }
   void InitOutputs(bool reading_inputs = false, bool reduce_flag = false,
                    bool with_reloads = false);
   void ReadInputs();
+  int GetLastIndexedStep();
+  bool SeekInputs(int i_step);
   void ResetCellList();
 };
 
@@ -196,6 +196,60 @@ void tridiagonal_solver(std::vector<double> *a, std::vector<double> *b,
   return;
 }
 
+void pentadiagonal_factor(std::vector<double> *d, std::vector<double> *e,
+                          std::vector<double> *f, int n) {
+  //  Factors the symmetric pentadiagonal matrix
+  //
+  //  | d[0] e[0] f[0]   0  |
+  //  | e[0] d[1] e[1] f[1] |
+  //  | f[0] e[1] d[2] e[2] |
+  //  |   0  f[1] e[2] d[3] |
+  //
+  //  in place as A = L D L^T, where L is unit lower triangular with first
+  //  and second subdiagonals e and f and D is the diagonal d. No pivoting is
+  //  done, so the matrix must be positive definite.
+  //
+  //  Input: pointers to the diagonal (*d), first (*e) and second (*f)
+  //         off-diagonals of A, and the number of unknowns (n)
+  //
+  //  Output: D in *d, and the subdiagonals of L in *e and *f
+
+  for (int i = 0; i < n; ++i) {
+    if (i > 0)
+      (*d)[i] -= SQR((*e)[i - 1]) * (*d)[i - 1];
+    if (i > 1)
+      (*d)[i] -= SQR((*f)[i - 2]) * (*d)[i - 2];
+    if (i < n - 1) {
+      if (i > 0)
+        (*e)[i] -= (*f)[i - 1] * (*d)[i - 1] * (*e)[i - 1];
+      (*e)[i] /= (*d)[i];
+    }
+    if (i < n - 2)
+      (*f)[i] /= (*d)[i];
+  }
+}
+
+void pentadiagonal_solve(std::vector<double> const &d,
+                         std::vector<double> const &e,
+                         std::vector<double> const &f, std::vector<double> *x,
+                         int n) {
+  //  Solves Ax=b for x, given the factors of A from pentadiagonal_factor
+  //  and b in *x. Output: Array of solutions x (*x)
+
+  for (int i = 1; i < n; ++i) {
+    (*x)[i] -= e[i - 1] * (*x)[i - 1];
+    if (i > 1)
+      (*x)[i] -= f[i - 2] * (*x)[i - 2];
+  }
+  for (int i = 0; i < n; ++i)
+    (*x)[i] /= d[i];
+  for (int i = n - 1; i-- > 0;) {
+    (*x)[i] -= e[i] * (*x)[i + 1];
+    if (i < n - 2)
+      (*x)[i] -= f[i] * (*x)[i + 2];
+  }
+}
+
 /* This function rotates vector v about vector k by an angle theta.
  * Derived using rodrigues' rotation formula */
 void rotate_vector(double *v, double *k, double theta) {
@@ -1,22 +1,40 @@
 #include "logger.hpp"
+#include <chrono>
 
 /****************************/
 /******** SINGLETON *********/
 /****************************/
 
-LoggerService::LoggerService() {}
-LoggerService::~LoggerService() {}
+LoggerService::LoggerService() : head_(0), written_(0), stop_(false) {
+  for (size_t i = 0; i < ring_size_; ++i) {
+    ring_[i].seq.store(i, std::memory_order_relaxed);
+  }
+#if !defined(DEBUG) && !defined(TRACE)
+  writer_ = std::thread(&LoggerService::Run, this);
+#endif
+}
+
+LoggerService::~LoggerService() {
+  if (writer_.joinable()) {
+    stop_ = true;
+    wake_cv_.notify_all();
+    writer_.join();
+  }
+}
 FILE *LoggerService::log_file_ = nullptr;
 
 void LoggerService::SetOutput(const char *fname) const {
+  /* Earlier messages only go to stderr */
+  Flush();
+  std::lock_guard<std::mutex> lk(mtx_);
   LoggerService::log_file_ = fopen(fname, "w");
 }
 
 void LoggerService::Info(const char *msg, va_list args) const {
-  WriteMsg("INFO ", msg, args);
+  Enqueue("INFO ", msg, args);
 }
 void LoggerService::Warning(const char *msg, va_list args) const {
-  WriteMsg("WARN ", msg, args);
+  Enqueue("WARN ", msg, args);
 }
 
 void LoggerService::Debug(const char *msg, va_list args) const {
@@ -31,9 +49,26 @@ void LoggerService::Trace(const char *msg, va_list args) const {
 }
 
 void LoggerService::Error(const char *msg, va_list args) const {
+  Flush();
   WriteMsg("ERROR", msg, args);
 }
 
+/* Format the time, severity and message as one log line. Returns the length
+   of the full line, which may not have fit. */
+int LoggerService::FormatLine(char *line, size_t size, const char *severity,
+                              const char *msg, va_list args) const {
+  // Create time string.
+  char timestr[64];
+  time_t t = time(NULL);
+  struct tm *p = localtime(&t);
+  strftime(timestr, 64, "%F::%T", p);
+  int n = snprintf(line, size, "%s - [%s] - ", timestr, severity);
+  if (n < 0 || (size_t)n >= size) {
+    return n;
+  }
+  return n + vsnprintf(line + n, size - n, msg, args);
+}
+
 void LoggerService::WriteMsg(const char *severity, const char *msg, va_list args) const {
   std::lock_guard<std::mutex> lk(mtx_);
 
@@ -64,6 +99,94 @@ void LoggerService::WriteMsg(const char *severity, const char *msg, va_list args
   fprintf(stderr, "\n");
 }
 
+void LoggerService::WriteLine(const char *line) const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  if (log_file_ != nullptr) {
+    fprintf(log_file_, "%s\n", line);
+    fflush(log_file_);
+  }
+  fprintf(stderr, "%s\n", line);
+}
+
+/* Format the message into the next free slot of the ring buffer. Slots are
+   claimed by advancing head_ and handed to the writer thread by advancing
+   their sequence number, so logging threads never take a lock. */
+void LoggerService::Enqueue(const char *severity, const char *msg,
+                            va_list args) const {
+  if (!writer_.joinable()) {
+    WriteMsg(severity, msg, args);
+    return;
+  }
+  size_t pos = head_.load(std::memory_order_relaxed);
+  Slot *slot;
+  while (true) {
+    slot = &ring_[pos % ring_size_];
+    long diff = (long)(slot->seq.load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      /* Full, wait for the writer to free the slot */
+      wake_cv_.notify_one();
+      std::this_thread::yield();
+      pos = head_.load(std::memory_order_relaxed);
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+  va_list arg_cpy;
+  va_copy(arg_cpy, args);
+  int n = FormatLine(slot->line, sizeof(slot->line), severity, msg, arg_cpy);
+  va_end(arg_cpy);
+  bool too_long = (n < 0 || (size_t)n >= sizeof(slot->line));
+  if (too_long) {
+    /* Publish an empty slot and write the message directly instead */
+    slot->line[0] = '\0';
+  }
+  slot->seq.store(pos + 1, std::memory_order_release);
+  wake_cv_.notify_one();
+  if (too_long) {
+    Flush();
+    WriteMsg(severity, msg, args);
+  }
+}
+
+void LoggerService::Run() {
+  size_t pos = 0;
+  while (true) {
+    Slot &slot = ring_[pos % ring_size_];
+    if (slot.seq.load(std::memory_order_acquire) == pos + 1) {
+      if (slot.line[0] != '\0') {
+        WriteLine(slot.line);
+      }
+      slot.seq.store(pos + ring_size_, std::memory_order_release);
+      written_.store(++pos, std::memory_order_release);
+      continue;
+    }
+    if (stop_ && head_.load(std::memory_order_acquire) == pos) {
+      return;
+    }
+    /* Logging threads do not lock wake_mtx_ when notifying, so a wakeup can
+       be missed and the wait is bounded */
+    std::unique_lock<std::mutex> lk(wake_mtx_);
+    wake_cv_.wait_for(lk, std::chrono::milliseconds(10));
+  }
+}
+
+/* Wait until everything logged so far has been written */
+void LoggerService::Flush() const {
+  if (!writer_.joinable()) {
+    return;
+  }
+  size_t target = head_.load(std::memory_order_acquire);
+  while (written_.load(std::memory_order_acquire) < target) {
+    wake_cv_.notify_one();
+    std::this_thread::yield();
+  }
+}
+
 // Get logger instance
 const LoggerService &LoggerService::Get() {
   static LoggerService logger;
@@ -1,19 +1,73 @@
 #ifndef _SIMCORE_LOGGER_H_
 #define _SIMCORE_LOGGER_H_
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <stdarg.h>
 #include <stdio.h>
+#include <thread>
 #include <time.h>
 
+/* Trace and Debug messages are compiled out entirely, including the
+   evaluation of their arguments, unless simcore is built with TRACE (both) or
+   DEBUG (Debug only). Use these macros rather than calling Logger::Trace and
+   Logger::Debug directly. */
+#if defined(TRACE)
+#define SIMCORE_LOG_LEVEL 0
+#elif defined(DEBUG)
+#define SIMCORE_LOG_LEVEL 1
+#else
+#define SIMCORE_LOG_LEVEL 2
+#endif
+
+#if SIMCORE_LOG_LEVEL <= 0
+#define LOG_TRACE(...) Logger::Trace(__VA_ARGS__)
+#else
+#define LOG_TRACE(...)                                                         \
+  do {                                                                         \
+  } while (0)
+#endif
+#if SIMCORE_LOG_LEVEL <= 1
+#define LOG_DEBUG(...) Logger::Debug(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...)                                                         \
+  do {                                                                         \
+  } while (0)
+#endif
+
 // Logger singleton
 class LoggerService {
 private:
+  /* Slot of the message ring buffer. Its sequence number tells logging
+     threads and the writer thread whose turn it is to use the slot. */
+  struct Slot {
+    std::atomic<size_t> seq;
+    char line[512];
+  };
   void WriteMsg(const char *severity, const char *msg, va_list args) const;
+  void WriteLine(const char *line) const;
+  int FormatLine(char *line, size_t size, const char *severity,
+                 const char *msg, va_list args) const;
+  void Enqueue(const char *severity, const char *msg, va_list args) const;
+  void Run();
+  void Flush() const;
   // Log file
   static FILE *log_file_;
   // Make logging thread-safe
   mutable std::mutex mtx_;
+  /* Messages other than errors are formatted by the calling thread into a
+     lock-free ring buffer and written out by a background thread. Errors
+     first wait for the ring buffer to be written. Builds with DEBUG or TRACE
+     log synchronously so that nothing is lost on a crash. */
+  static const size_t ring_size_ = 1024;
+  mutable Slot ring_[ring_size_];
+  mutable std::atomic<size_t> head_;    // Next slot to fill
+  mutable std::atomic<size_t> written_; // Next slot to write
+  std::atomic<bool> stop_;
+  mutable std::mutex wake_mtx_;
+  mutable std::condition_variable wake_cv_;
+  std::thread writer_;
 
 public:
   LoggerService();
@@ -9,19 +9,22 @@ class MaxForcePotential : public PotentialBase {
  public:
   MaxForcePotential() {}
   void CalcPotential(Interaction &ix) {
+    if (n_dim_ == 2) {
+      CalcPotential<2>(ix);
+    } else {
+      CalcPotential<3>(ix);
+    }
+  }
+  template <int N_DIM> void CalcPotential(Interaction &ix) {
     /* Check if we can generate a non-zero vector between
        the COMs of the two objects */
     double *dr = ix.dr;
     if (ix.contact1[0] || ix.contact1[1] || ix.contact1[2]) {
-      for (int i = 0; i < n_dim_; ++i) {
+      for (int i = 0; i < N_DIM; ++i) {
         dr[i] = ix.contact1[i] - ix.contact2[i];
       }
     }
-    double rmag = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
-      rmag += dr[i] * dr[i];
-    }
-    rmag = sqrt(rmag);
+    double rmag = sqrt(dot_product<N_DIM>(dr, dr));
     /* Assure that we have a nonzero distance defined
        between the objects */
     if (rmag < 1e-12) {
@@ -29,12 +32,7 @@ class MaxForcePotential : public PotentialBase {
       return;
     }
     double rinv = 1.0 / (rmag);
-    for (int i = 0; i < n_dim_; ++i) {
-      ix.force[i] = fcut_ * dr[i] * rinv;
-    }
-    for (int i = 0; i < n_dim_; ++i)
-      for (int j = 0; j < n_dim_; ++j)
-        ix.stress[n_dim_ * i + j] = -dr[i] * ix.force[j];
+    SetCentralForce<N_DIM>(ix, dr, fcut_, rinv);
     // XXX This needs a corresponding potential value
     ix.pote = 0;
   }
@@ -3,9 +3,6 @@
 /**************************
 ** Mesh member functions **
 **************************/
-int Mesh::_next_mesh_id_ = 0;
-std::mutex Mesh::_mesh_mtx_;
-
 Mesh::Mesh() : Object() {
   InitMeshID();
   n_sites_ = n_bonds_ = n_bonds_max_ = 0;
@@ -16,8 +13,8 @@ Mesh::Mesh() : Object() {
 }
 
 void Mesh::InitMeshID() {
-  std::lock_guard<std::mutex> lk(_mesh_mtx_);
-  SetMeshID(++_next_mesh_id_);
+  std::lock_guard<std::mutex> lk(ctx_->mtx);
+  SetMeshID(++ctx_->next_mesh_id);
 }
 
 void Mesh::Reserve(int n_bonds) {
@@ -78,10 +75,10 @@ void Mesh::RemoveBondFromTip() {
 // Doubles number of bonds in graph while keeping same shape
 // currently only works for linear objects like filaments
 void Mesh::DoubleGranularityLinear() {
-  Logger::Trace("Mesh %d doubling bonds for dynamic instability, n_bonds: %d ->"
-                " %d, bond_length: %2.2f -> %2.2f",
-                GetMeshID(), n_bonds_, 2 * n_bonds_, bond_length_,
-                0.5 * bond_length_);
+  LOG_TRACE("Mesh %d doubling bonds for dynamic instability, n_bonds: %d ->"
+            " %d, bond_length: %2.2f -> %2.2f",
+            GetMeshID(), n_bonds_, 2 * n_bonds_, bond_length_,
+            0.5 * bond_length_);
   int n_bonds_old = n_bonds_;
   bond_length_ /= 2;
   // First record positions of currently existing graph
@@ -109,10 +106,10 @@ void Mesh::HalfGranularityLinear() {
         "HalfGranularityLinear called on mesh with odd number of bonds: %d",
         n_bonds_);
   }
-  Logger::Trace("Mesh %d halving bonds for dynamic instability, n_bonds: %d ->"
-                " %d, bond_length: %2.2f -> %2.2f",
-                GetMeshID(), n_bonds_, n_bonds_ / 2, bond_length_,
-                2 * bond_length_);
+  LOG_TRACE("Mesh %d halving bonds for dynamic instability, n_bonds: %d ->"
+            " %d, bond_length: %2.2f -> %2.2f",
+            GetMeshID(), n_bonds_, n_bonds_ / 2, bond_length_,
+            2 * bond_length_);
 
   int n_bonds_new = n_bonds_ / 2;
   bond_length_ *= 2;
@@ -168,8 +165,8 @@ void Mesh::UpdatePrevPositions() {
 }
 
 void Mesh::InitSiteAt(double *pos, double d) {
-  Logger::Trace("Mesh %d inserting site at [%2.2f %2.2f %2.2f]", GetMeshID(),
-                pos[0], pos[1], pos[2]);
+  LOG_TRACE("Mesh %d inserting site at [%2.2f %2.2f %2.2f]", GetMeshID(),
+            pos[0], pos[1], pos[2]);
   Site s;
   s.SetPosition(pos);
   s.SetDiameter(d);
@@ -421,11 +418,13 @@ void Mesh::ReadSpec(std::fstream &ip) {
   if (n_bonds_ != n_sites_ - 1) {
     Logger::Error("Incorrect number of bonds initialized in Mesh::ReadSpec");
   }
+  /* Site orientations follow the bonds that were just rebuilt */
+  UpdateSiteOrientations();
 }
 
 void Mesh::WriteSpec(std::fstream &op) {
   int mid = GetMeshID();
-  Logger::Trace("Writing specs for mesh id %d", mid);
+  LOG_TRACE("Writing specs for mesh id %d", mid);
   op.write(reinterpret_cast<char *>(&mid), sizeof(mid));
   op.write(reinterpret_cast<char *>(&diameter_), sizeof(diameter_));
   op.write(reinterpret_cast<char *>(&length_), sizeof(length_));
@@ -446,7 +445,7 @@ void Mesh::ReadCheckpoint(std::fstream &ip) {
   ip.read(reinterpret_cast<char *>(rng_state), rng_size);
   Clear();
   ReadSpec(ip);
-  Logger::Trace("Reloading mesh from checkpoint with mid %d", GetMeshID());
+  LOG_TRACE("Reloading mesh from checkpoint with mid %d", GetMeshID());
 }
 
 void Mesh::WriteCheckpoint(std::fstream &op) {
@@ -499,6 +498,33 @@ double const Mesh::GetDrTot() {
   return dr_tot_;
 }
 
+double const Mesh::GetDrStep() {
+  double dr2_max = 0;
+  for (site_iterator site = sites_.begin(); site != sites_.end(); ++site) {
+    double const dr2 = site->GetDrStep();
+    if (dr2 > dr2_max) {
+      dr2_max = dr2;
+    }
+  }
+  return dr2_max;
+}
+
+void Mesh::ZeroDrStep() {
+  for (site_iterator site = sites_.begin(); site != sites_.end(); ++site) {
+    site->ZeroDrStep();
+  }
+}
+
+void Mesh::SetTimeStep(double delta) {
+  Object::SetTimeStep(delta);
+  for (site_iterator site = sites_.begin(); site != sites_.end(); ++site) {
+    site->SetTimeStep(delta);
+  }
+  for (bond_iterator bond = bonds_.begin(); bond != bonds_.end(); ++bond) {
+    bond->SetTimeStep(delta);
+  }
+}
+
 std::vector<Interaction *> *Mesh::GetInteractions() {
   for (bond_iterator bond = bonds_.begin(); bond != bonds_.end(); ++bond) {
     std::vector<Interaction *> *bond_ixs = bond->GetInteractions();
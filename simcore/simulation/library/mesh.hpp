@@ -8,8 +8,6 @@ typedef std::vector<Site>::iterator site_iterator;
 
 class Mesh : public Object {
 private:
-  static int _next_mesh_id_;
-  static std::mutex _mesh_mtx_;
   void InitMeshID();
 
 protected:
@@ -70,6 +68,9 @@ public:
   virtual void UpdateDrTot();
   virtual double const GetDrTot();
   virtual void ZeroDrTot();
+  virtual double const GetDrStep();
+  virtual void ZeroDrStep();
+  virtual void SetTimeStep(double delta);
   virtual void SetPosition(double const *const pos);
   virtual std::vector<Interaction *> *GetInteractions();
   virtual void ClearInteractions();
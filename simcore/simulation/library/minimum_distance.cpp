@@ -2,12 +2,6 @@
 
 #define SMALL 1.0e-12
 
-int MinimumDistance::n_dim_ = 0;
-int MinimumDistance::n_periodic_ = 0;
-double *MinimumDistance::unit_cell_ = nullptr;
-double MinimumDistance::boundary_cut2_ = 0;
-space_struct *MinimumDistance::space_ = nullptr;
-
 void MinimumDistance::Init(space_struct *space, double boundary_cutoff_sq) {
   space_ = space;
   n_dim_ = space_->n_dim;
@@ -18,6 +12,14 @@ void MinimumDistance::Init(space_struct *space, double boundary_cutoff_sq) {
 
 /* Find the minimum distance between two particles */
 void MinimumDistance::ObjectObject(Interaction &ix) {
+  if (n_dim_ == 2) {
+    ObjectObject<2>(ix);
+  } else {
+    ObjectObject<3>(ix);
+  }
+}
+
+template <int N_DIM> void MinimumDistance::ObjectObject(Interaction &ix) {
   double const *const r1 = ix.obj1->GetInteractorPosition();
   double const *const s1 = ix.obj1->GetInteractorScaledPosition();
   double const *const u1 = ix.obj1->GetInteractorOrientation();
@@ -41,33 +43,36 @@ void MinimumDistance::ObjectObject(Interaction &ix) {
 
   if (l1 == 0 && l2 == 0) {
     /* When we have two point-like particles interacting. */
-    PointPoint(r1, s1, r2, s2, ix.dr, &ix.dr_mag2, ix.midpoint);
+    PointPoint<N_DIM>(r1, s1, r2, s2, ix.dr, &ix.dr_mag2, ix.midpoint);
   } else if (l1 == 0 && l2 > 0) {
     /* The case where obj1 is a point-like particle and obj2 is an
        extended, line-like particle */
-    SphereSphero(r1, s1, r2, s2, u2, l2, ix.dr, &ix.dr_mag2, ix.contact2);
+    SphereSphero<N_DIM>(r1, s1, r2, s2, u2, l2, ix.dr, &ix.dr_mag2,
+                        ix.contact2);
   } else if (l1 > 0 && l2 == 0) {
     /* Same, but switching the order of obj1 and obj2, so we'll just swap
        the order of obj1 and obj2 in the min distance calculation, then
        reverse the direction of the min distance vector and proceed. */
-    SphereSphero(r2, s2, r1, s1, u1, l1, ix.dr, &ix.dr_mag2, ix.contact1);
+    SphereSphero<N_DIM>(r2, s2, r1, s1, u1, l1, ix.dr, &ix.dr_mag2,
+                        ix.contact1);
     for (int i = 0; i < 3; ++i) {
       ix.dr[i] = -ix.dr[i];
     }
   } else if (l1 > 0 && l2 > 0) {
     /* When we have two extended, line-like particles interacting. */
-    Sphero(r1, s1, u1, l1, r2, s2, u2, l2, ix.dr, &ix.dr_mag2, ix.contact1,
-           ix.contact2);
+    Sphero<N_DIM>(r1, s1, u1, l1, r2, s2, u2, l2, ix.dr, &ix.dr_mag2,
+                  ix.contact1, ix.contact2);
   }
 #ifdef TRACE
-  Logger::Trace("Minimum distance between %d and %d is %2.4f",
-                ix.obj1->GetOID(), ix.obj2->GetOID(), sqrt(ix.dr_mag2));
+  LOG_TRACE("Minimum distance between %d and %d is %2.4f",
+            ix.obj1->GetOID(), ix.obj2->GetOID(), sqrt(ix.dr_mag2));
 #endif
 }
 
 /* Returns squared minimum distance (dr_mag2) and minimum distance vector (dr)
  * between two point-like objects centered at r1 and r2 (scaled position of s1
  * and s2 in periodic subspace) */
+template <int N_DIM>
 void MinimumDistance::PointPoint(double const *const r1, double const *const s1,
                                  double const *const r2, double const *const s2,
                                  double *dr, double *dr_mag2,
@@ -84,17 +89,17 @@ void MinimumDistance::PointPoint(double const *const r1, double const *const s1,
     dr[i] = 0.0;
     midpoint[i] = 0.0;
     for (int j = 0; j < n_periodic_; ++j) {
-      dr[i] += unit_cell_[n_dim_ * i + j] * ds[j];
-      midpoint[i] += unit_cell_[n_dim_ * i + j] * mp[j];
+      dr[i] += unit_cell_[N_DIM * i + j] * ds[j];
+      midpoint[i] += unit_cell_[N_DIM * i + j] * mp[j];
     }
   }
   // Then handle free subspace
-  for (int i = n_periodic_; i < n_dim_; ++i) {
+  for (int i = n_periodic_; i < N_DIM; ++i) {
     dr[i] = r2[i] - r1[i];
     midpoint[i] = r1[i] + 0.5 * dr[i];
   }
   *dr_mag2 = 0.0;
-  for (int i = 0; i < n_dim_; ++i) {
+  for (int i = 0; i < N_DIM; ++i) {
     *dr_mag2 += SQR(dr[i]);
   }
   return;
@@ -199,44 +204,27 @@ output: minimimum separation vector (r_min)
         vector separating r_1 to point of contact on first sphero (contact1)
         vector separating r_2 to point of contact on second sphero (contact2) */
 
+template <int N_DIM>
 void MinimumDistance::Sphero(double const *const r_1, double const *const s_1,
                              double const *const u_1, double const length_1,
                              double const *const r_2, double const *const s_2,
                              double const *const u_2, double const length_2,
                              double *r_min, double *r_min_mag2,
                              double *contact_1, double *contact_2) {
-  double dr[3], ds[3];
+  double dr[N_DIM];
 
   /* Compute half-length of objects. */
   double half_length_1 = 0.5 * length_1;
   double half_length_2 = 0.5 * length_2;
 
   /* Compute pair separation vector. */
-  /* First handle periodic subspace. */
-  for (int i = 0; i < n_periodic_; ++i) {
-    ds[i] = s_2[i] - s_1[i];
-    ds[i] -= NINT(ds[i]);
-  }
-  for (int i = 0; i < n_periodic_; ++i) {
-    dr[i] = 0.0;
-    for (int j = 0; j < n_periodic_; ++j) {
-      dr[i] += unit_cell_[n_dim_ * i + j] * ds[j];
-    }
-  }
-  /* Then handle free subspace. */
-  for (int i = n_periodic_; i < n_dim_; ++i) {
-    dr[i] = r_2[i] - r_1[i];
-  }
+  separation_vector<N_DIM>(n_periodic_, r_1, s_1, r_2, s_2, unit_cell_, dr);
 
   /* Compute minimum distance (see Allen et al., Adv. Chem. Phys. 86, 1 (1993)).
      First consider two infinitely long lines. */
-  double dr_dot_u_1, dr_dot_u_2, u_1_dot_u_2;
-  dr_dot_u_1 = dr_dot_u_2 = u_1_dot_u_2 = 0.0;
-  for (int i = 0; i < n_dim_; ++i) {
-    dr_dot_u_1 += dr[i] * u_1[i];
-    dr_dot_u_2 += dr[i] * u_2[i];
-    u_1_dot_u_2 += u_1[i] * u_2[i];
-  }
+  double dr_dot_u_1 = dot_product<N_DIM>(dr, u_1);
+  double dr_dot_u_2 = dot_product<N_DIM>(dr, u_2);
+  double u_1_dot_u_2 = dot_product<N_DIM>(u_1, u_2);
   double lambda, mu;
   double denom = 1.0 - SQR(u_1_dot_u_2);
   if (denom < SMALL) {
@@ -252,7 +240,7 @@ void MinimumDistance::Sphero(double const *const r_1, double const *const s_1,
   /* Now take into account the fact that the two line segments are of finite
    * length. */
   double lambda_a, lambda_b, mu_a, mu_b, r_min_mag2_a, r_min_mag2_b;
-  double r_min_a[3], r_min_b[3];
+  double r_min_a[N_DIM], r_min_b[N_DIM];
   if (lambda_mag > half_length_1 && mu_mag > half_length_2) {
     /* Calculate first possible case. */
     lambda_a = SIGN(half_length_1, lambda);
@@ -264,7 +252,7 @@ void MinimumDistance::Sphero(double const *const r_1, double const *const s_1,
 
     /* Calculate minimum distance between two spherocylinders. */
     r_min_mag2_a = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       r_min_a[i] = dr[i] - lambda_a * u_1[i] + mu_a * u_2[i];
       r_min_mag2_a += SQR(r_min_a[i]);
     }
@@ -279,7 +267,7 @@ void MinimumDistance::Sphero(double const *const r_1, double const *const s_1,
 
     /* Calculate minimum distance between two spherocylinders. */
     r_min_mag2_b = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       r_min_b[i] = dr[i] - lambda_b * u_1[i] + mu_b * u_2[i];
       r_min_mag2_b += SQR(r_min_b[i]);
     }
@@ -289,14 +277,14 @@ void MinimumDistance::Sphero(double const *const r_1, double const *const s_1,
       lambda = lambda_a;
       mu = mu_a;
       *r_min_mag2 = r_min_mag2_a;
-      for (int i = 0; i < n_dim_; ++i) {
+      for (int i = 0; i < N_DIM; ++i) {
         r_min[i] = r_min_a[i];
       }
     } else {
       lambda = lambda_b;
       mu = mu_b;
       *r_min_mag2 = r_min_mag2_b;
-      for (int i = 0; i < n_dim_; ++i) {
+      for (int i = 0; i < N_DIM; ++i) {
         r_min[i] = r_min_b[i];
       }
     }
@@ -310,7 +298,7 @@ void MinimumDistance::Sphero(double const *const r_1, double const *const s_1,
 
     /* Calculate minimum distance between two spherocylinders. */
     *r_min_mag2 = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       r_min[i] = dr[i] - lambda * u_1[i] + mu * u_2[i];
       *r_min_mag2 += SQR(r_min[i]);
     }
@@ -324,19 +312,19 @@ void MinimumDistance::Sphero(double const *const r_1, double const *const s_1,
 
     /* Calculate minimum distance between two spherocylinders. */
     *r_min_mag2 = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       r_min[i] = dr[i] - lambda * u_1[i] + mu * u_2[i];
       *r_min_mag2 += SQR(r_min[i]);
     }
   } else {
     /* Calculate minimum distance between two spherocylinders. */
     *r_min_mag2 = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
+    for (int i = 0; i < N_DIM; ++i) {
       r_min[i] = dr[i] - lambda * u_1[i] + mu * u_2[i];
       *r_min_mag2 += SQR(r_min[i]);
     }
   }
-  for (int i = 0; i < n_dim_; ++i) {
+  for (int i = 0; i < N_DIM; ++i) {
     contact_1[i] = lambda * u_1[i];
     contact_2[i] = mu * u_2[i];
   }
@@ -511,37 +499,23 @@ void MinimumDistance::SpheroDr(double *r_1, double *s_1, double *u_1,
  pointer to squared minimum separation (r_min_mag2)
  pointer to intersection of r_min with axis of spherocylinder (mu). */
 
+template <int N_DIM>
 void MinimumDistance::SphereSphero(
     double const *const r_1, double const *const s_1, double const *const r_2,
     double const *const s_2, double const *const u_2, double const length_2,
     double *r_min, double *r_min_mag2, double *contact2) {
-  int i, j;
-  double half_length_2, dr_dot_u_2, mu_mag, mu;
-  double ds[3], dr[3];
+  double dr[N_DIM];
 
   /* Compute various constants. */
-  half_length_2 = 0.5 * length_2;
+  double half_length_2 = 0.5 * length_2;
 
   /* Compute pair separation vector. */
-  for (i = 0; i < n_periodic_; ++i) { /* First handle periodic subspace. */
-    ds[i] = s_2[i] - s_1[i];
-    ds[i] -= NINT(ds[i]);
-  }
-  for (i = 0; i < n_periodic_; ++i) {
-    dr[i] = 0.0;
-    for (j = 0; j < n_periodic_; ++j)
-      dr[i] += unit_cell_[n_dim_ * i + j] * ds[j];
-  }
-  for (i = n_periodic_; i < n_dim_; ++i) /* Then handle free subspace. */
-    dr[i] = r_2[i] - r_1[i];
+  separation_vector<N_DIM>(n_periodic_, r_1, s_1, r_2, s_2, unit_cell_, dr);
 
   /* Compute minimum distance (see Allen et al., Adv. Chem. Phys. 86, 1 (1993)).
      First consider a point and an infinitely long line. */
-  dr_dot_u_2 = 0.0;
-  for (i = 0; i < n_dim_; ++i)
-    dr_dot_u_2 += dr[i] * u_2[i];
-  mu = -dr_dot_u_2;
-  mu_mag = ABS(mu);
+  double mu = -dot_product<N_DIM>(dr, u_2);
+  double mu_mag = ABS(mu);
 
   /* Now take into account the fact that the line segment is of finite length.
    */
@@ -550,7 +524,7 @@ void MinimumDistance::SphereSphero(
 
   /* Calculate minimum distance between sphere and spherocylinder. */
   *r_min_mag2 = 0.0;
-  for (i = 0; i < n_dim_; ++i) {
+  for (int i = 0; i < N_DIM; ++i) {
     r_min[i] = dr[i] + mu * u_2[i];
     contact2[i] = mu * u_2[i];
     *r_min_mag2 += SQR(r_min[i]);
@@ -879,3 +853,6 @@ bool MinimumDistance::CheckOutsideBoundary(Object &obj) {
 }
 
 #undef SMALL
+
+template void MinimumDistance::ObjectObject<2>(Interaction &ix);
+template void MinimumDistance::ObjectObject<3>(Interaction &ix);
@@ -6,9 +6,10 @@
 
 class MinimumDistance {
  private:
-  static int n_dim_, n_periodic_;
-  static double *unit_cell_, boundary_cut2_;
-  static space_struct *space_;
+  int n_dim_ = 0, n_periodic_ = 0;
+  double *unit_cell_ = nullptr, boundary_cut2_ = 0;
+  space_struct *space_ = nullptr;
+  template <int N_DIM>
   void PointPoint(double const *const r1, double const *const s1,
                   double const *const r2, double const *const s2, double *dr,
                   double *dr_mag2, double *midpoint);
@@ -18,6 +19,7 @@ class MinimumDistance {
   void PointCarrierLine(double *r_point, double *s_point, double *r_line,
                         double *s_line, double *u_line, double length,
                         double *dr, double *r_contact, double *mu_ret);
+  template <int N_DIM>
   void Sphero(double const *const r_1, double const *const s_1,
               double const *const u_1, double const length_1,
               double const *const r_2, double const *const s_2,
@@ -27,6 +29,7 @@ class MinimumDistance {
                 double *r_2, double *s_2, double *u_2, double length_2,
                 double *dr, double *r_min, double *r_min_mag2, double *lambda,
                 double *mu);
+  template <int N_DIM>
   void SphereSphero(double const *const r_1, double const *const s_1,
                     double const *const r_2, double const *const s_2,
                     double const *const u_2, double const length_2,
@@ -52,6 +55,9 @@ class MinimumDistance {
   MinimumDistance() {}
   void Init(space_struct *space, double boundary_cutoff_sq);
   void ObjectObject(Interaction &ix);
+  /* ObjectObject for a run of N_DIM dimensions, for callers that have
+     already specialized on the dimension */
+  template <int N_DIM> void ObjectObject(Interaction &ix);
   bool CheckBoundaryInteraction(Interaction &ix);
   bool CheckOutsideBoundary(Object &o1);
 
@@ -1,6 +1,11 @@
 #include "object.hpp"
 
 Object::Object() {
+  ctx_ = &SimulationContext::Current();
+  params_ = ctx_->params;
+  space_ = ctx_->space;
+  n_dim_ = ctx_->n_dim;
+  delta_ = ctx_->delta;
   // Initialize object ID, guaranteeing thread safety
   InitOID();
   // Set some defaults
@@ -14,6 +19,7 @@ Object::Object() {
   std::fill(force_, force_ + 3, 0.0);
   std::fill(torque_, torque_ + 3, 0.0);
   std::fill(dr_zero_, dr_zero_ + 3, 0.0);
+  std::fill(dr_step_zero_, dr_step_zero_ + 3, 0.0);
   draw_ = draw_type::orientation;
   type_ = obj_type::generic;
   color_ = 0;
@@ -36,21 +42,20 @@ Object::Object() {
 
 // Set the object OID in a thread-safe way
 void Object::InitOID() {
-  std::lock_guard<std::mutex> lk(_obj_mtx_);
-  oid_ = ++_next_oid_;
+  std::lock_guard<std::mutex> lk(ctx_->mtx);
+  oid_ = ++ctx_->next_oid;
 }
 
-int Object::_next_oid_ = 0;
-std::mutex Object::_obj_mtx_;
-system_parameters *Object::params_ = nullptr;
-space_struct *Object::space_ = nullptr;
-int Object::n_dim_ = 0;
-double Object::delta_ = 0;
-
-void Object::SetParams(system_parameters *params) { params_ = params; }
-void Object::SetSpace(space_struct *space) { space_ = space; }
-void Object::SetNDim(int n_dim) { n_dim_ = n_dim; }
-void Object::SetDelta(double delta) { delta_ = delta; }
+void Object::SetParams(system_parameters *params) {
+  SimulationContext::Current().params = params;
+}
+void Object::SetSpace(space_struct *space) {
+  SimulationContext::Current().space = space;
+}
+void Object::SetNDim(int n_dim) { SimulationContext::Current().n_dim = n_dim; }
+void Object::SetDelta(double delta) {
+  SimulationContext::Current().delta = delta;
+}
 // Trivial Get/Set functions
 int const Object::GetOID() const { return oid_; }
 void Object::SetPosition(double const *const pos) {
@@ -92,11 +97,11 @@ void Object::SubTorque(double const *const t) {
 void Object::SetTorque(double const *const t) { std::copy(t, t + 3, torque_); }
 void Object::AddPotential(double const p) { p_energy_ += p; }
 void Object::AddPolarOrder(double const po) {
-  std::lock_guard<std::mutex> lk(_obj_mtx_);
+  std::lock_guard<std::mutex> lk(ctx_->mtx);
   polar_order_ += po;
 }
 void Object::AddContactNumber(double const cn) {
-  std::lock_guard<std::mutex> lk(_obj_mtx_);
+  std::lock_guard<std::mutex> lk(ctx_->mtx);
   contact_number_ += cn;
 }
 void Object::CalcPolarOrder() {
@@ -149,7 +154,7 @@ void Object::SetSID(species_id sid) { sid_ = sid; }
 
 // Virtual functions
 void Object::InsertRandom() {
-  Logger::Trace("Inserting object %d randomly", GetOID());
+  LOG_TRACE("Inserting object %d randomly", GetOID());
   double mag;
   double buffer = diameter_;
   if (space_->n_periodic == n_dim_)
@@ -216,10 +221,10 @@ void Object::InsertRandom() {
   }
   generate_random_unit_vector(n_dim_, orientation_, rng_.r);
   UpdatePeriodic();
-  Logger::Trace("Object inserted at [%2.2f, %2.2f, %2.2f] with orientation "
-                "[%2.2f %2.2f %2.2f]",
-                position_[0], position_[1], position_[2], orientation_[0],
-                orientation_[1], orientation_[2]);
+  LOG_TRACE("Object inserted at [%2.2f, %2.2f, %2.2f] with orientation "
+            "[%2.2f %2.2f %2.2f]",
+            position_[0], position_[1], position_[2], orientation_[0],
+            orientation_[1], orientation_[2]);
 }
 
 void Object::InsertRandomOriented(double *u) {
@@ -377,6 +382,18 @@ void Object::UpdateDrTot() {
     dr_tot_ += dr * dr;
   }
 }
+double const Object::GetDrStep() {
+  double dr2 = 0;
+  for (int i = 0; i < n_dim_; ++i) {
+    double dr = position_[i] - dr_step_zero_[i];
+    dr2 += dr * dr;
+  }
+  return dr2;
+}
+void Object::ZeroDrStep() {
+  std::copy(position_, position_ + 3, dr_step_zero_);
+}
+void Object::SetTimeStep(double delta) { delta_ = delta; }
 bool Object::HasNeighbor(int other_oid) {
   // Generic objects are not assumed to have neighbors
   return false;
@@ -426,7 +443,24 @@ void Object::ReadPosit(std::fstream &iposit) {
   iposit.read(reinterpret_cast<char *>(&diameter_), sizeof(diameter_));
   iposit.read(reinterpret_cast<char *>(&length_), sizeof(length_));
 }
-void Object::WriteSpec(std::fstream &ospec) { WritePosit(ospec); }
+/* Same layout as the posit, but positions and orientations are quantized if
+   ospec is a compressed spec stream with a tolerance set */
+void Object::WriteSpec(std::fstream &ospec) {
+  for (auto &pos : position_) {
+    double q = SpecCompression::Quantize(ospec, pos);
+    ospec.write(reinterpret_cast<char *>(&q), sizeof(q));
+  }
+  for (auto &spos : scaled_position_) {
+    double q = SpecCompression::Quantize(ospec, spos);
+    ospec.write(reinterpret_cast<char *>(&q), sizeof(q));
+  }
+  for (auto &u : orientation_) {
+    double q = SpecCompression::Quantize(ospec, u);
+    ospec.write(reinterpret_cast<char *>(&q), sizeof(q));
+  }
+  ospec.write(reinterpret_cast<char *>(&diameter_), sizeof(diameter_));
+  ospec.write(reinterpret_cast<char *>(&length_), sizeof(length_));
+}
 void Object::ReadSpec(std::fstream &ispec) { ReadPosit(ispec); }
 void Object::ReadPositFromSpec(std::fstream &ispec) { ReadPosit(ispec); }
 void Object::GetAvgPosition(double *ap) {
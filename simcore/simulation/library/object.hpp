@@ -4,21 +4,24 @@
 #include "auxiliary.hpp"
 #include "interaction.hpp"
 #include "rng.hpp"
+#include "simulation_context.hpp"
+#include "spec_compression.hpp"
 #include <mutex>
 
 class Object {
 private:
   int oid_;
   int mesh_id_;
-  static int _next_oid_;
-  static std::mutex _obj_mtx_;
   void InitOID();
 
 protected:
-  static system_parameters *params_;
-  static space_struct *space_;
-  static int n_dim_;
-  static double delta_;
+  /* Context of the simulation the object belongs to, and the run constants
+     taken from it at construction */
+  SimulationContext *ctx_;
+  system_parameters *params_;
+  space_struct *space_;
+  int n_dim_;
+  double delta_;
   species_id sid_;
   obj_type type_;
   graph_struct g_;
@@ -36,6 +39,7 @@ protected:
   double force_[3];
   double torque_[3];
   double dr_zero_[3];
+  double dr_step_zero_[3];
   double color_;
   double diameter_;
   double length_;
@@ -61,7 +65,7 @@ public:
   double pos[3];
   double direction[3];
 
-  // Static functions
+  // Static functions, which set the current SimulationContext
   static void SetParams(system_parameters *params);
   static void SetSpace(space_struct *space);
   static void SetNDim(int n_dim);
@@ -140,6 +144,12 @@ public:
   virtual void UpdateDrTot();
   virtual double const GetDrTot();
   virtual void ZeroDrTot();
+  /* Squared displacement since the last call to ZeroDrStep, used to control
+     adaptive time steps */
+  virtual double const GetDrStep();
+  virtual void ZeroDrStep();
+  /* Change the time step of the object, updating anything derived from it */
+  virtual void SetTimeStep(double delta);
   virtual bool HasNeighbor(int other_id);
   virtual void GiveInteraction(Interaction *ix);
   virtual std::vector<Interaction *> *GetInteractions();
@@ -1,4 +1,5 @@
 #include "output_manager.hpp"
+#include "domain_decomposition.hpp"
 
 void OutputManager::Init(system_parameters *params,
                          std::vector<SpeciesBase *> *species,
@@ -17,7 +18,10 @@ void OutputManager::Init(system_parameters *params,
   n_posit_ = n_spec_ = n_checkpoint_ = ABS((int)params_->n_steps);
   posits_only_ = posits_only;
   n_thermo_ = params_->n_thermo;
-  thermo_flag_ = params_->thermo_flag;
+  /* Only the first process writes the thermo file of a decomposed system,
+     the others write their logs only */
+  thermo_flag_ = params_->thermo_flag &&
+                 (reading_inputs || DomainDecomposition::GetProcessRank() == 0);
   if (!reading_inputs && thermo_flag_) {
     InitThermo(run_name_);
   } else if (reading_inputs && thermo_flag_ && thermo_analysis_) {
@@ -46,7 +50,7 @@ void OutputManager::Init(system_parameters *params,
         n_posit_ = (*it)->GetNPosit();
       }
     }
-    if ((*it)->GetSpecFlag()) {
+    if ((*it)->GetSpecFlag() && !params_->in_situ_analysis) {
       spec_flag_ = true;
       if ((*it)->GetNSpec() < n_spec_) {
         n_spec_ = (*it)->GetNSpec();
@@ -113,6 +117,9 @@ void OutputManager::InitThermo(std::string fname) {
   othermo_file_.write(reinterpret_cast<char *>(&(params_->delta)),
                       sizeof(double));
   othermo_file_.write(reinterpret_cast<char *>(&(params_->n_dim)), sizeof(int));
+  if (params_->async_output) {
+    AsyncOutput::Attach(othermo_file_);
+  }
 }
 
 void OutputManager::InitThermoInput(std::string fname) {
@@ -194,7 +201,41 @@ void OutputManager::ReadInputs() {
   }
   if (reduce_flag_) {
     WriteReduce();
+    AsyncOutput::EndFrame();
+  }
+}
+
+/* Last processing step whose spec frames can be read by seeking in every
+   species spec file, or -1 if seeking is not possible */
+int OutputManager::GetLastIndexedStep() {
+  /* Posit and thermo inputs are not indexed */
+  if (posits_only_ || thermo_flag_) {
+    return -1;
+  }
+  int last_step = INT_MAX;
+  for (auto spec = species_->begin(); spec != species_->end(); ++spec) {
+    if (!(*spec)->GetSpecFlag()) {
+      continue;
+    }
+    int n_frames = (*spec)->GetNSpecFrames();
+    if (n_frames == 0) {
+      return -1;
+    }
+    last_step = std::min(last_step, (n_frames - 1) * (*spec)->GetNSpec());
+  }
+  return last_step;
+}
+
+/* Read the spec frames that sequential reading would have reached by the
+   current step */
+bool OutputManager::SeekInputs() {
+  for (auto spec = species_->begin(); spec != species_->end(); ++spec) {
+    if ((*spec)->GetSpecFlag() &&
+        !(*spec)->SeekSpecFrame(*i_step_ / (*spec)->GetNSpec())) {
+      return false;
+    }
   }
+  return true;
 }
 
 void OutputManager::WriteReduce() {
@@ -222,6 +263,7 @@ void OutputManager::Close() {
       ithermo_file_.close();
     }
     if (othermo_file_.is_open()) {
+      AsyncOutput::Detach(othermo_file_);
       othermo_file_.close();
     }
   }
@@ -45,6 +45,8 @@ class OutputManager {
   void WriteOutputs();
   void InitInputs();
   void ReadInputs();
+  int GetLastIndexedStep();
+  bool SeekInputs();
   void Close();
 };
 
@@ -46,6 +46,7 @@ class filament_parameters : public species_parameters {
     double f_grow_to_pause = 0.0;
     double f_grow_to_shrink = 0.00554;
     int metric_forces = 1;
+    int implicit_bending = 0;
     double v_poly = 0.44;
     double v_depoly = 0.793;
     int theta_analysis = 0;
@@ -200,6 +201,7 @@ class crosslink_parameters : public species_parameters {
     double tether_color = 3.1416;
     int end_pausing = 0;
     double r_capture = 5;
+    int event_kinetics = 0;
 };
 
 class system_parameters {
@@ -217,6 +219,12 @@ class system_parameters {
     double delta = 0.001;
     double cell_length = 10;
     int n_update_cells = 0;
+    int n_respa = 1;
+    int adaptive_delta = 0;
+    double delta_min = 0.00001;
+    double delta_max = 0.01;
+    double max_dr_step = 0;
+    double max_force_fraction = 0.5;
     int graph_flag = 0;
     int n_graph = 1000;
     double graph_diameter = 0;
@@ -230,6 +238,16 @@ class system_parameters {
     int movie_flag = 0;
     std::string movie_directory = "frames";
     int time_analysis = 0;
+    int n_profile = 0;
+    int perf_counters = 0;
+    int async_output = 1;
+    int spec_compression = 0;
+    double spec_tolerance = 0;
+    int mmap_analysis = 1;
+    int parallel_analysis = 1;
+    int async_checkpoints = 1;
+    int checkpoint_delta = 0;
+    int in_situ_analysis = 0;
     double bud_height = 680;
     double bud_radius = 300;
     double lj_epsilon = 1;
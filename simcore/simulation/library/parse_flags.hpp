@@ -22,6 +22,10 @@ struct run_options {
   int auto_graph = 0;
   int with_reloads = 0;
   int single_frame = 0;
+  int n_jobs = 1;
+  int threads_per_job = 0;
+  int resume = 0;
+  std::string exe;
   std::string param_file;
   std::string run_name = "sc";
 };
@@ -31,7 +35,7 @@ struct run_options {
    string array below when adding new flags. */
 
 // Define flags here
-static const int n_flags = 14;
+static const int n_flags = 17;
 static struct option long_options[] = {{"help", no_argument, 0, 'h'},
                                        {"debug", no_argument, 0, 'd'},
                                        {"run-name", required_argument, 0, 'r'},
@@ -46,6 +50,10 @@ static struct option long_options[] = {{"help", no_argument, 0, 'h'},
                                        {"blank", no_argument, 0, 'b'},
                                        {"with-reloads", no_argument, 0, 'w'},
                                        {"single-frame", no_argument, 0, 'M'},
+                                       {"jobs", required_argument, 0, 'j'},
+                                       {"threads-per-job", required_argument,
+                                        0, 't'},
+                                       {"resume", no_argument, 0, 'u'},
                                        {0, 0, 0, 0}};
 
 // Descriptions for flags
@@ -77,7 +85,15 @@ static const std::string desc[n_flags][2] = {
     {"run analysis using any existing spec files from reloaded runs", "none"},
     {"runs movie, but only generates a single bitmap image to record the final "
      "system state",
-     "none"}};
+     "none"},
+    {"where njobs is the number of simulations of a batch to run at the same "
+     "time in separate worker processes, or 0 for as many as there are cores "
+     "for",
+     "njobs"},
+    {"where nthreads is the number of cores given to each worker, with "
+     "workers pinned to disjoint cores",
+     "nthreads"},
+    {"skip simulations of the batch that finished in a previous run", "none"}};
 
 /*************************
    SHOW_HELP_INFO
@@ -114,10 +130,11 @@ static run_options parse_opts(int argc, char *argv[]) {
   }
 
   run_options run_opts;
+  run_opts.exe = argv[0];
   int tmp;
   while (1) {
     int option_index = 0;
-    tmp = getopt_long(argc, argv, "hdmaplwbMGg:r:n:R:", long_options,
+    tmp = getopt_long(argc, argv, "hdmaplwbMGug:r:n:R:j:t:", long_options,
                       &option_index);
     if (tmp == -1) break;
     switch (tmp) {
@@ -171,6 +188,15 @@ static run_options parse_opts(int argc, char *argv[]) {
         run_opts.single_frame = 1;
         run_opts.make_movie = 1;
         break;
+      case 'j':
+        run_opts.n_jobs = atoi(optarg);
+        break;
+      case 't':
+        run_opts.threads_per_job = atoi(optarg);
+        break;
+      case 'u':
+        run_opts.resume = 1;
+        break;
       case '?':
         exit(1);
       default:
@@ -218,6 +244,9 @@ static run_options parse_opts(int argc, char *argv[]) {
     printf("  Reducing output file resolution by a factor of %d\n",
            run_opts.reduce_factor);
   }
+  if (run_opts.n_jobs != 1) {
+    printf("  Running simulations in parallel worker processes\n");
+  }
   if (run_opts.blank_flag) {
     printf(
         "  Doing a blank run -- generating parameter files without running "
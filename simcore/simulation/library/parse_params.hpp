@@ -131,6 +131,9 @@ void parse_params(YAML::Node node, system_parameters *params) {
           else if (param_name.compare("metric_forces")==0) {
             params->filament.metric_forces = jt->second.as<int>();
           }
+          else if (param_name.compare("implicit_bending")==0) {
+            params->filament.implicit_bending = jt->second.as<int>();
+          }
           else if (param_name.compare("v_poly")==0) {
             params->filament.v_poly = jt->second.as<double>();
           }
@@ -923,6 +926,9 @@ void parse_params(YAML::Node node, system_parameters *params) {
           else if (param_name.compare("r_capture")==0) {
             params->crosslink.r_capture = jt->second.as<double>();
           }
+          else if (param_name.compare("event_kinetics")==0) {
+            params->crosslink.event_kinetics = jt->second.as<int>();
+          }
           else if (param_name.compare("num")==0) {
             params->crosslink.num = jt->second.as<int>();
           }
@@ -1010,6 +1016,24 @@ void parse_params(YAML::Node node, system_parameters *params) {
       else if (param_name.compare("n_update_cells")==0) {
         params->n_update_cells = it->second.as<int>();
       }
+      else if (param_name.compare("n_respa")==0) {
+        params->n_respa = it->second.as<int>();
+      }
+      else if (param_name.compare("adaptive_delta")==0) {
+        params->adaptive_delta = it->second.as<int>();
+      }
+      else if (param_name.compare("delta_min")==0) {
+        params->delta_min = it->second.as<double>();
+      }
+      else if (param_name.compare("delta_max")==0) {
+        params->delta_max = it->second.as<double>();
+      }
+      else if (param_name.compare("max_dr_step")==0) {
+        params->max_dr_step = it->second.as<double>();
+      }
+      else if (param_name.compare("max_force_fraction")==0) {
+        params->max_force_fraction = it->second.as<double>();
+      }
       else if (param_name.compare("graph_flag")==0) {
         params->graph_flag = it->second.as<int>();
       }
@@ -1049,6 +1073,36 @@ void parse_params(YAML::Node node, system_parameters *params) {
       else if (param_name.compare("time_analysis")==0) {
         params->time_analysis = it->second.as<int>();
       }
+      else if (param_name.compare("n_profile")==0) {
+        params->n_profile = it->second.as<int>();
+      }
+      else if (param_name.compare("perf_counters")==0) {
+        params->perf_counters = it->second.as<int>();
+      }
+      else if (param_name.compare("async_output")==0) {
+        params->async_output = it->second.as<int>();
+      }
+      else if (param_name.compare("spec_compression")==0) {
+        params->spec_compression = it->second.as<int>();
+      }
+      else if (param_name.compare("spec_tolerance")==0) {
+        params->spec_tolerance = it->second.as<double>();
+      }
+      else if (param_name.compare("mmap_analysis")==0) {
+        params->mmap_analysis = it->second.as<int>();
+      }
+      else if (param_name.compare("parallel_analysis")==0) {
+        params->parallel_analysis = it->second.as<int>();
+      }
+      else if (param_name.compare("async_checkpoints")==0) {
+        params->async_checkpoints = it->second.as<int>();
+      }
+      else if (param_name.compare("checkpoint_delta")==0) {
+        params->checkpoint_delta = it->second.as<int>();
+      }
+      else if (param_name.compare("in_situ_analysis")==0) {
+        params->in_situ_analysis = it->second.as<int>();
+      }
       else if (param_name.compare("bud_height")==0) {
         params->bud_height = it->second.as<double>();
       }
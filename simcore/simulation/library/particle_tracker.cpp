@@ -15,7 +15,7 @@ void ParticleTracker::Init(system_parameters *p, std::vector<Object *> *o,
 }
 
 void ParticleTracker::AllocateCellList() {
-  Logger::Debug("Allocating cell lists");
+  LOG_DEBUG("Allocating cell lists");
   int third_dim = (n_dim_ == 3 ? n_cells_1d_ : 1);
   clist_ = new Cell **[n_cells_1d_];
   for (int i = 0; i < n_cells_1d_; ++i) {
@@ -37,7 +37,7 @@ void ParticleTracker::DeallocateCellList() {
 }
 
 void ParticleTracker::ClearCells() {
-  Logger::Debug("Clearing cells");
+  LOG_DEBUG("Clearing cells");
 #ifdef ENABLE_OPENMP
 #pragma omp parallel
   {
@@ -69,7 +69,7 @@ void ParticleTracker::ClearCells() {
 void ParticleTracker::AssignCells() {
   ClearCells();
   int n_objs_ = objs_->size();
-  Logger::Debug("Assigning cells");
+  LOG_DEBUG("Assigning cells");
 #ifdef ENABLE_OPENMP
 #pragma omp parallel
   {
@@ -122,7 +122,7 @@ void ParticleTracker::AssignCells() {
 }
 
 void ParticleTracker::CreatePairsCellList() {
-  Logger::Debug("Creating pairs");
+  LOG_DEBUG("Creating pairs");
   nlist_->clear();
 #ifdef ENABLE_OPENMP
 #pragma omp parallel
@@ -15,7 +15,7 @@ void ParticleTracker::Init(system_parameters *p, std::vector<Object *> *o,
 }
 
 void ParticleTracker::AllocateCellList() {
-  Logger::Debug("Allocating cell lists\n");
+  LOG_DEBUG("Allocating cell lists\n");
   // printf("Cell length: %2.2f\n",cell_length_1d_);
   int third_dim = (n_dim_ == 3 ? n_cells_1d_ : 1);
   clist_ = new Cell **[n_cells_1d_];
@@ -38,7 +38,7 @@ void ParticleTracker::DeallocateCellList() {
 }
 
 void ParticleTracker::ClearCells() {
-  Logger::Debug("Clearing cells\n");
+  LOG_DEBUG("Clearing cells\n");
 #ifdef ENABLE_OPENMP
 #pragma omp parallel
   {
@@ -70,7 +70,7 @@ void ParticleTracker::ClearCells() {
 void ParticleTracker::AssignCells() {
   ClearCells();
   int n_objs_ = objs_->size();
-  Logger::Debug("Assigning cells\n");
+  LOG_DEBUG("Assigning cells\n");
 #ifdef ENABLE_OPENMP
 #pragma omp parallel
   {
@@ -126,7 +126,7 @@ void ParticleTracker::AssignCells() {
 }
 
 void ParticleTracker::CreatePairsCellList() {
-  Logger::Debug("Creating pairs\n");
+  LOG_DEBUG("Creating pairs\n");
   nlist_->clear();
 #ifdef ENABLE_OPENMP
 #pragma omp parallel
@@ -0,0 +1,142 @@
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+const int PerfCounters::n_events_;
+const char *PerfCounters::event_names_[n_events_] = {
+    "cycles", "instructions", "llc_misses", "branch_misses"};
+
+PerfCounters::PerfCounters() {
+  for (int i = 0; i < n_events_; ++i) {
+    available_[i] = false;
+  }
+}
+
+/* Open a group of counters for the calling thread. Returns false if not even
+   the group leader could be opened. */
+bool PerfCounters::OpenThread(int i_thread) {
+#ifdef __linux__
+  static const uint64_t configs[n_events_] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  std::vector<int> &fds = fds_[i_thread];
+  for (int i = 0; i < n_events_; ++i) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, fds[0],
+                     PERF_FLAG_FD_CLOEXEC);
+    if (fds[0] < 0) {
+      return false;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* Open counters for every OpenMP thread. OpenMP runtimes keep their threads
+   between parallel regions, so the counters keep following the threads that
+   run the parallel loops of the simulation. */
+bool PerfCounters::Open() {
+  Close();
+  int n_threads = 1;
+#ifdef ENABLE_OPENMP
+  n_threads = omp_get_max_threads();
+#endif
+  fds_.assign(n_threads, std::vector<int>(n_events_, -1));
+  std::vector<char> opened(n_threads, 0);
+  std::vector<int> errors(n_threads, 0);
+#ifdef ENABLE_OPENMP
+#pragma omp parallel num_threads(n_threads)
+  {
+    int i_thread = omp_get_thread_num();
+    opened[i_thread] = OpenThread(i_thread);
+    errors[i_thread] = errno;
+  }
+#else
+  opened[0] = OpenThread(0);
+  errors[0] = errno;
+#endif
+  for (int i = 0; i < n_threads; ++i) {
+    if (!opened[i]) {
+      Logger::Warning("Hardware counters are not available (%s), check "
+                      "/proc/sys/kernel/perf_event_paranoid",
+                      strerror(errors[i]));
+      Close();
+      return false;
+    }
+  }
+  for (int i = 0; i < n_events_; ++i) {
+    available_[i] = true;
+    for (int j = 0; j < n_threads; ++j) {
+      available_[i] = available_[i] && (fds_[j][i] >= 0);
+    }
+    if (!available_[i]) {
+      Logger::Warning("Hardware counter %s is not available, leaving it out "
+                      "of the timing file",
+                      event_names_[i]);
+    }
+  }
+  buffer_.resize(3 + n_events_);
+  return true;
+}
+
+void PerfCounters::Close() {
+#ifdef __linux__
+  for (auto it = fds_.begin(); it != fds_.end(); ++it) {
+    for (auto fd = it->rbegin(); fd != it->rend(); ++fd) {
+      if (*fd >= 0) {
+        close(*fd);
+      }
+    }
+  }
+#endif
+  fds_.clear();
+  for (int i = 0; i < n_events_; ++i) {
+    available_[i] = false;
+  }
+}
+
+void PerfCounters::Read(double *counts) {
+  std::fill(counts, counts + n_events_ * fds_.size(), 0.0);
+#ifdef __linux__
+  for (size_t i = 0; i < fds_.size(); ++i) {
+    /* The group reads as { nr, time_enabled, time_running, values[nr] } with
+       the values of the events that were opened, in order */
+    ssize_t size = buffer_.size() * sizeof(uint64_t);
+    if (read(fds_[i][0], buffer_.data(), size) <= 0) {
+      continue;
+    }
+    double scale = 1;
+    if (buffer_[2] > 0 && buffer_[2] < buffer_[1]) {
+      scale = (double)buffer_[1] / buffer_[2];
+    }
+    uint64_t i_value = 0;
+    for (int j = 0; j < n_events_ && i_value < buffer_[0]; ++j) {
+      if (fds_[i][j] >= 0) {
+        if (available_[j]) {
+          counts[n_events_ * i + j] = scale * buffer_[3 + i_value];
+        }
+        i_value++;
+      }
+    }
+  }
+#endif
+}
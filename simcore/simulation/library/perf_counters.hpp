@@ -0,0 +1,48 @@
+#ifndef _SIMCORE_PERF_COUNTERS_H_
+#define _SIMCORE_PERF_COUNTERS_H_
+
+#include "definitions.hpp"
+#include "logger.hpp"
+#include <cstdint>
+#include <vector>
+
+/* Hardware event counters of every OpenMP thread, read through
+   perf_event_open. Each thread gets a group of counters measuring only that
+   thread in user space, so the counters of all threads can be read from the
+   main thread at phase boundaries.
+
+   If the kernel does not allow counters (e.g. perf_event_paranoid is too
+   high, or in containers and virtual machines without a PMU), Open returns
+   false and nothing is counted. Events that are not supported are skipped
+   and read as zero. Counts are scaled up if the kernel had to multiplex the
+   counters. */
+class PerfCounters {
+public:
+  static const int n_events_ = 4;
+
+private:
+  static const char *event_names_[n_events_];
+  /* fd of each event of each thread, -1 if the event is not counted. The
+     first event is the group leader. */
+  std::vector<std::vector<int>> fds_;
+  bool available_[n_events_];
+  std::vector<uint64_t> buffer_;
+  bool OpenThread(int i_thread);
+
+public:
+  PerfCounters();
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+  ~PerfCounters() { Close(); }
+  bool Open();
+  void Close();
+  bool IsOpen() const { return !fds_.empty(); }
+  int GetNThreads() const { return fds_.size(); }
+  bool IsAvailable(int event) const { return available_[event]; }
+  static const char *GetEventName(int event) { return event_names_[event]; }
+  /* Write the count of each event of each thread since Open to
+     counts[n_events_ * i_thread + event] */
+  void Read(double *counts);
+};
+
+#endif // _SIMCORE_PERF_COUNTERS_H_
@@ -8,6 +8,18 @@ class PotentialBase {
  protected:
   int n_dim_;
   double fcut_, rcut_, rcut2_;
+  /* Sets the central force ffac * dr * rinv on the pair and its
+     contribution to the stress tensor */
+  template <int N_DIM>
+  static void SetCentralForce(Interaction &ix, double const *const dr,
+                              double ffac, double rinv) {
+    for (int i = 0; i < N_DIM; ++i) {
+      ix.force[i] = ffac * dr[i] * rinv;
+    }
+    for (int i = 0; i < N_DIM; ++i)
+      for (int j = 0; j < N_DIM; ++j)
+        ix.stress[N_DIM * i + j] = -dr[i] * ix.force[j];
+  }
 
  public:
   PotentialBase() {}
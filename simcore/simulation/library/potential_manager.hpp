@@ -50,6 +50,19 @@ class PotentialManager {
     }
     pot_->CalcPotential(ix);
   }
+  /* CalcPotential for a run of N_DIM dimensions, calling the potential
+     directly rather than through PotentialBase */
+  template <int N_DIM> void CalcPotential(Interaction &ix) {
+    if (pot_type_ == +potential_type::wca) {
+      if (ix.dr_mag2 < 1e-12) {
+        max_.CalcPotential<N_DIM>(ix);
+      } else {
+        wca_.CalcPotential<N_DIM>(ix);
+      }
+    } else if (pot_type_ == +potential_type::soft) {
+      soft_.CalcPotential<N_DIM>(ix);
+    }
+  }
   double GetRCut2() { return pot_->GetRCut2(); }
 };
 
@@ -12,6 +12,13 @@ class R2Potential : public PotentialBase {
  public:
   R2Potential() {}
   void CalcPotential(Interaction &ix) {
+    if (n_dim_ == 2) {
+      CalcPotential<2>(ix);
+    } else {
+      CalcPotential<3>(ix);
+    }
+  }
+  template <int N_DIM> void CalcPotential(Interaction &ix) {
     double rmag = ix.dr_mag2;
     double *dr = ix.dr;
     double ffac = 0;
@@ -29,12 +36,7 @@ class R2Potential : public PotentialBase {
     if (ABS(ffac) > fcut_) {
       ffac = SIGNOF(ffac) * fcut_;
     }
-    for (int i = 0; i < n_dim_; ++i) {
-      ix.force[i] = ffac * dr[i] / rmag;
-    }
-    for (int i = 0; i < n_dim_; ++i)
-      for (int j = 0; j < n_dim_; ++j)
-        ix.stress[n_dim_ * i + j] = -dr[i] * ix.force[j];
+    SetCentralForce<N_DIM>(ix, dr, ffac, 1.0 / rmag);
     ix.pote = rinv2 - eps_;
   }
 
@@ -4,30 +4,36 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>
 #include <math.h>
+#include "simulation_context.hpp"
 #include <mutex>
 //#include "definitions.hpp"
 
+/* Every RNG is seeded from the seed chain of the current SimulationContext,
+   and advances it for the next RNG */
 class RNG {
 private:
   const gsl_rng_type *T;
-  static long _seed_;
-  static std::mutex _rng_mtx_;
+  static std::mutex _rng_mtx_; // gsl_rng_env_setup sets GSL globals
   void Clear() { gsl_rng_free(r); }
   void Init() {
-    std::lock_guard<std::mutex> lk(_rng_mtx_);
-    gsl_rng_env_setup();
-    T = gsl_rng_default;
+    {
+      std::lock_guard<std::mutex> lk(_rng_mtx_);
+      gsl_rng_env_setup();
+      T = gsl_rng_default;
+    }
     r = gsl_rng_alloc(T);
-    gsl_rng_set(r, _seed_);
-    _seed_ = gsl_rng_get(this->r);
+    SimulationContext &ctx = SimulationContext::Current();
+    std::lock_guard<std::mutex> lk(ctx.mtx);
+    gsl_rng_set(r, ctx.seed);
+    ctx.seed = gsl_rng_get(this->r);
   }
 
 public:
   gsl_rng *r;
   RNG() { Init(); }
   ~RNG() { Clear(); }
-  static void SetSeed(long seed) { _seed_ = seed; }
-  static long GetSeed() { return _seed_; }
+  static void SetSeed(long seed) { SimulationContext::Current().seed = seed; }
+  static long GetSeed() { return SimulationContext::Current().seed; }
   RNG(const RNG &that) : RNG() { gsl_rng_memcpy(this->r, that.r); }
   RNG &operator=(RNG const &that) {
     gsl_rng_memcpy(this->r, that.r);
@@ -6,7 +6,13 @@
 /* Initialize simulation parameters and run simulation */
 void Simulation::Run(system_parameters params) {
   params_ = params;
-  run_name_ = params.run_name;
+  /* With the system split across processes, the first process writes the
+     outputs of the run, and the others write their logs under their rank */
+  int rank = DomainDecomposition::GetProcessRank();
+  if (rank > 0) {
+    params_.run_name += "_rank" + std::to_string(rank);
+  }
+  run_name_ = params_.run_name;
   // Initialize simulation data structures
   InitSimulation();
   // Begin simulation
@@ -32,9 +38,10 @@ void Simulation::RunSimulation() {
    sane step frequency functions (e.g. n_graph, n_thermo, etc) are even numbers,
    we want these to represent filaments in their fullstep configurations. We
    also update other objects' positions on every even step too (e.g. xlinks). */
-  for (i_step_ = 1; i_step_ < params_.n_steps + 1; ++i_step_) {
+  for (i_step_ = 1; out_step_ < params_.n_steps; ++i_step_) {
+    StepProfiler::StartStep();
     params_.i_step = i_step_;
-    time_ = (i_step_ + 1) * params_.delta;
+    AdvanceTime();
     // Output progress
     PrintComplete();
     /* Zero the force_ array on all objects for bookkeeping */
@@ -48,13 +55,162 @@ void Simulation::RunSimulation() {
     /* Draw the particles in graphics window, if using graphics */
     Draw();
     /* Catch soft exceptions and terminate the simulation early */
-    if (early_exit) {
-      early_exit = false;
+    if (domains_.IsActive()) {
+      context_.early_exit = domains_.AnyProcess(context_.early_exit);
+    }
+    if (context_.early_exit) {
+      context_.early_exit = false;
       Logger::Info("Early exit triggered. Ending simulation.");
       return;
     }
     /* Generate all output files */
     WriteOutputs();
+    /* Choose the time step of the next full step, if adapting it */
+    UpdateTimeStep();
+    StepProfiler::EndStep(i_step_);
+  }
+}
+
+/* Advance the simulated time by one step. With a fixed time step, outputs
+ * are due on every step and counted by i_step. With an adaptive time step,
+ * they are only due on the full steps that land on the next output time. */
+void Simulation::AdvanceTime() {
+  if (!adaptive_delta_) {
+    out_step_ = i_step_;
+    time_ = (i_step_ + 1) * params_.delta;
+    return;
+  }
+  time_ += delta_;
+  int next_out = std::min(out_step_ + n_out_steps_, params_.n_steps);
+  double t_out = next_out * params_.delta;
+  output_step_ = (i_step_ % 2 == 0 && time_ > t_out - 0.5 * delta_);
+  if (output_step_) {
+    time_ = t_out;
+    out_step_ = next_out;
+  }
+}
+
+/* Set up adaptive time stepping. The time step may vary between delta_min
+ * and delta_max, while delta remains the unit of the output cadences
+ * (n_posit, n_spec, n_checkpoint, n_thermo), so that outputs are written at
+ * the same simulated times as in a run with a fixed time step of delta. */
+void Simulation::InitTimeStep() {
+  out_step_ = 0;
+  output_step_ = true;
+  delta_ = params_.delta;
+  time_ = 0;
+  adaptive_delta_ = params_.adaptive_delta;
+  if (!adaptive_delta_) {
+    return;
+  }
+  if (params_.delta_min <= 0 || params_.delta_min > params_.delta ||
+      params_.delta > params_.delta_max) {
+    Logger::Error("Adaptive time steps require 0 < delta_min <= delta <= "
+                  "delta_max, got %2.2e, %2.2e, %2.2e",
+                  params_.delta_min, params_.delta, params_.delta_max);
+  }
+  /* Full steps land on every common multiple of the output cadences */
+  n_out_steps_ = params_.n_steps;
+  std::vector<int> cadences;
+  for (auto spec = species_.begin(); spec != species_.end(); ++spec) {
+    if ((*spec)->GetPositFlag()) {
+      cadences.push_back((*spec)->GetNPosit());
+    }
+    if ((*spec)->GetSpecFlag()) {
+      cadences.push_back((*spec)->GetNSpec());
+    }
+    if ((*spec)->GetCheckpointFlag()) {
+      cadences.push_back((*spec)->GetNCheckpoint());
+    }
+  }
+  if (params_.thermo_flag || params_.constant_pressure ||
+      params_.constant_volume) {
+    cadences.push_back(params_.n_thermo);
+  }
+  if (params_.crosslink.concentration >= 1e-12) {
+    if (params_.crosslink.spec_flag) {
+      cadences.push_back(params_.crosslink.n_spec);
+    }
+    if (params_.crosslink.checkpoint_flag) {
+      cadences.push_back(params_.crosslink.n_checkpoint);
+    }
+  }
+  for (auto n = cadences.begin(); n != cadences.end(); ++n) {
+    int a = n_out_steps_;
+    int b = *n;
+    while (b > 0) {
+      int r = a % b;
+      a = b;
+      b = r;
+    }
+    n_out_steps_ = a;
+  }
+  Logger::Info("Adapting time step between %2.2e and %2.2e, landing on "
+               "outputs every %d steps of %2.2e",
+               params_.delta_min, params_.delta_max, n_out_steps_,
+               params_.delta);
+  SetTimeStep(FitTimeStep(delta_));
+  for (auto spec = species_.begin(); spec != species_.end(); ++spec) {
+    (*spec)->ZeroDrStep();
+  }
+}
+
+/* After every full step, choose the next time step from the largest
+ * displacement of any object over the last full step, if max_dr_step is set,
+ * and the largest pair force. The step grows by at most 10% and shrinks by
+ * at most half per full step, and does not grow while a pair force comes close
+ * to f_cutoff, where the potential is no longer resolved. Midsteps keep the
+ * time step of their full step, so that filaments and crosslinks see one time
+ * step between their full step configurations. */
+void Simulation::UpdateTimeStep() {
+  if (!adaptive_delta_ || i_step_ % 2 != 0) {
+    return;
+  }
+  double max_dr2 = 0;
+  for (auto spec = species_.begin(); spec != species_.end(); ++spec) {
+    max_dr2 = std::max(max_dr2, (*spec)->GetDrStepMax());
+    (*spec)->ZeroDrStep();
+  }
+  double stats[2] = {max_dr2, iengine_.GetMaxPairForce()};
+  iengine_.ZeroMaxPairForce();
+  domains_.MaxOverProcesses(stats, 2);
+  double factor = 1.1;
+  if (params_.max_dr_step > 0 && stats[0] > 0) {
+    factor = std::min(factor, 0.9 * params_.max_dr_step / sqrt(stats[0]));
+  }
+  if (stats[1] > params_.max_force_fraction * params_.f_cutoff) {
+    factor = std::min(factor, 1.0);
+  }
+  factor = std::max(factor, 0.5);
+  double delta = std::min(std::max(factor * delta_, params_.delta_min),
+                          params_.delta_max);
+  delta = FitTimeStep(delta);
+  if (delta != delta_) {
+    SetTimeStep(delta);
+  }
+}
+
+/* Largest time step no larger than delta for which a whole number of full
+ * steps ends on the next output time */
+double Simulation::FitTimeStep(double delta) {
+  int next_out = std::min(out_step_ + n_out_steps_, params_.n_steps);
+  double t_left = next_out * params_.delta - time_;
+  if (t_left <= 0) {
+    return delta;
+  }
+  int n_full = std::max((int)ceil(t_left / (2 * delta) - 1e-9), 1);
+  return t_left / (2 * n_full);
+}
+
+/* Hand a new time step to everything that keeps quantities derived from it.
+ * Objects created from here on take it from the context. */
+void Simulation::SetTimeStep(double delta) {
+  delta_ = delta;
+  context_.delta = delta;
+  space_.SetTimeStep(delta);
+  iengine_.SetTimeStep(delta);
+  for (auto spec = species_.begin(); spec != species_.end(); ++spec) {
+    (*spec)->SetTimeStep(delta);
   }
 }
 
@@ -63,26 +219,37 @@ void Simulation::RunSimulation() {
  * which can be useful for logging. Otherwise, the progress will be refreshed
  * in a single line printed to standard output. */
 void Simulation::PrintComplete() {
-  long iteration = i_step_ * 10;
-  long steps = params_.n_steps;
-  if (iteration % steps == 0) {
-    Logger::Info("%d%% complete", 10 * iteration / steps);
+  if (adaptive_delta_) {
+    double t_run = params_.n_steps * params_.delta;
+    int complete = (int)(10 * time_ / t_run);
+    if (complete != (int)(10 * (time_ - delta_) / t_run)) {
+      Logger::Info("%d%% complete", 10 * complete);
+    }
+  } else {
+    long iteration = i_step_ * 10;
+    long steps = params_.n_steps;
+    if (iteration % steps == 0) {
+      Logger::Info("%d%% complete", 10 * iteration / steps);
+    }
   }
-  Logger::Trace("*****Step %d*****", i_step_);
+  LOG_TRACE("*****Step %d*****", i_step_);
 }
 
 /* Update the positions of all objects in the system using numerical
  * integration for one time step defined by the delta parameter. */
 void Simulation::Integrate() {
-  Logger::Debug("Updating object positions");
-  for (auto it = species_.begin(); it != species_.end(); ++it) {
-    (*it)->UpdatePositions();
+  LOG_DEBUG("Updating object positions");
+  ProfileTimer timer(profile_phase::integrate);
+  for (size_t i = 0; i < species_.size(); ++i) {
+    ProfileTimer spec_timer(integrate_phases_[i]);
+    species_[i]->UpdatePositions();
   }
 }
 
 /* Calculate interaction forces between all objects if necessary. */
 void Simulation::Interact() {
-  Logger::Debug("Calculating object interactions");
+  LOG_DEBUG("Calculating object interactions");
+  ProfileTimer timer(profile_phase::interact);
   iengine_.Interact();
 }
 
@@ -90,6 +257,7 @@ void Simulation::Interact() {
  * schemes with dependence on previous forces need to save their forces in
  * prev_forces_ arrays. */
 void Simulation::ZeroForces() {
+  ProfileTimer timer(profile_phase::zero_forces);
   for (auto it = species_.begin(); it != species_.end(); ++it) {
     (*it)->ZeroForces();
   }
@@ -98,9 +266,10 @@ void Simulation::ZeroForces() {
 /* Update system pressure, volume and rescale system size if necessary,
  * handling periodic boundaries in a sane way. */
 void Simulation::Statistics() {
-  if (i_step_ % params_.n_thermo == 0 && i_step_ > 0) {
+  ProfileTimer timer(profile_phase::statistics);
+  if (output_step_ && out_step_ % params_.n_thermo == 0 && out_step_ > 0) {
     /* Calculate system pressure from stress tensor */
-    Logger::Debug("Calculating system thermodynamics");
+    LOG_DEBUG("Calculating system thermodynamics");
     iengine_.CalculatePressure();
     if (params_.constant_pressure) {
       space_.ConstantPressure();
@@ -145,23 +314,65 @@ void Simulation::InitSimulation() {
     }
   }
 #endif
+  checkpoints_.Init(params_.async_checkpoints, params_.checkpoint_delta);
   space_.Init(&params_);
+  InitContext();
   InitObjects();
   InitSpecies();
   iengine_.Init(&params_, &species_, space_.GetStruct(), &i_step_);
   InsertSpecies(params_.load_checkpoint, params_.load_checkpoint);
+  domains_.Init(&params_, space_.GetStruct(), &species_,
+                iengine_.GetInteractionRange());
+  if (params_.in_situ_analysis) {
+    InitInSituAnalysis();
+  }
   InitOutputs();
   if (params_.graph_flag) {
     InitGraphics();
   }
+  InitProfiler();
+  InitTimeStep();
 }
 
-/* Initialize static object parameters that are used everywhere */
+/* Register a profiler phase for the position updates of each species */
+void Simulation::InitProfiler() {
+  StepProfiler::Init(run_name_, params_.n_profile, params_.perf_counters);
+  integrate_phases_.clear();
+  for (auto it = species_.begin(); it != species_.end(); ++it) {
+    integrate_phases_.push_back(StepProfiler::AddPhase(
+        (*it)->GetSID()._to_string(), profile_phase::integrate));
+  }
+}
+
+/* Make the context of this simulation current on the calling thread and
+   start its seed chain from the seed parameter, so that a run only depends
+   on its own parameters, whether it runs alone, in a batch or next to other
+   simulations in the same process */
+void Simulation::InitContext() {
+  if (previous_context_ == nullptr) {
+    previous_context_ = SimulationContext::MakeCurrent(&context_);
+  }
+  context_.seed = params_.seed;
+  context_.early_exit = false;
+  rng_ = RNG();
+}
+
+/* Give the calling thread back the context that was current before */
+void Simulation::ReleaseContext() {
+  if (previous_context_ != nullptr) {
+    SimulationContext::MakeCurrent(previous_context_);
+    previous_context_ = nullptr;
+  }
+}
+
+/* Initialize object parameters that are used everywhere */
 void Simulation::InitObjects() {
-  Object::SetParams(&params_);
-  Object::SetNDim(params_.n_dim);
-  Object::SetDelta(params_.delta);
-  Object::SetSpace(space_.GetStruct());
+  context_.params = &params_;
+  context_.n_dim = params_.n_dim;
+  context_.delta = params_.delta;
+  context_.space = space_.GetStruct();
+  context_.domains = &domains_;
+  context_.checkpoints = &checkpoints_;
 }
 
 /* Generate graphics window and draw initial simulation setup */
@@ -228,6 +439,33 @@ void Simulation::InitSpecies() {
   }
 }
 
+/* Set up in-situ analysis of every species that writes spec files. Structure
+   analyses need the interaction engine to be rebuilt from the analyzed
+   frames, so they are left to post-processing. */
+void Simulation::InitInSituAnalysis() {
+  if (params_.local_order_analysis || params_.polar_order_analysis ||
+      params_.overlap_analysis || params_.density_analysis ||
+      params_.filament.flocking_analysis) {
+    Logger::Warning("Structure analyses cannot run in situ. Writing spec "
+                    "files for post-processing instead.");
+    params_.in_situ_analysis = 0;
+    return;
+  }
+  Logger::Info("Running species analyses in situ");
+  in_situ_.Init(&params_);
+  /* Creating the snapshot species must not change the object ids or random
+     number streams of the simulation */
+  SimulationContext::Counters counters = context_.SaveCounters();
+  for (auto it = species_.begin(); it != species_.end(); ++it) {
+    if ((*it)->GetSpecFlag()) {
+      SpeciesBase *snapshot = (SpeciesBase *)species_factory_.construct(
+          (*it)->GetSID()._to_string());
+      in_situ_.AddSpecies(*it, snapshot, space_.GetStruct());
+    }
+  }
+  context_.RestoreCounters(counters);
+}
+
 /* Initialize object positions and orientations.*/
 void Simulation::InsertSpecies(bool force_overlap, bool processing) {
   Logger::Info("Inserting species");
@@ -369,7 +607,12 @@ void Simulation::InsertSpecies(bool force_overlap, bool processing) {
 /* Tear down data structures, e.g. cell lists, and close graphics window if
  * necessary. */
 void Simulation::ClearSimulation() {
-  Logger::Debug("Clearing simulation resources");
+  LOG_DEBUG("Clearing simulation resources");
+  StepProfiler::Finalize();
+  /* Flush outstanding asynchronous output before closing files */
+  AsyncOutput::DetachAll();
+  checkpoints_.Flush();
+  in_situ_.Finalize();
   output_mgr_.Close();
   ClearSpecies();
   iengine_.Clear();
@@ -378,6 +621,7 @@ void Simulation::ClearSimulation() {
     graphics_.Clear();
   }
 #endif
+  ReleaseContext();
   Logger::Info("Simulation complete");
 }
 
@@ -393,7 +637,8 @@ void Simulation::ClearSpecies() {
 /* Update the OpenGL graphics window */
 void Simulation::Draw(bool single_frame) {
 #ifndef NOGRAPH
-  Logger::Trace("Drawing graphable objects");
+  LOG_TRACE("Drawing graphable objects");
+  ProfileTimer timer(profile_phase::draw);
   if (params_.graph_flag && i_step_ % params_.n_graph == 0) {
     /* Get updated object positions and orientations */
     GetGraphicsStructure();
@@ -410,7 +655,7 @@ void Simulation::Draw(bool single_frame) {
 /* Loop through objects in simulation to update their positions and
  * orientations in the graphics window */
 void Simulation::GetGraphicsStructure() {
-  Logger::Trace("Retrieving graphics structures from objects");
+  LOG_TRACE("Retrieving graphics structures from objects");
   graph_array_.clear();
   for (auto it = species_.begin(); it != species_.end(); ++it) {
     (*it)->Draw(&graph_array_);
@@ -421,8 +666,8 @@ void Simulation::GetGraphicsStructure() {
 
 /* Initialize output files */
 void Simulation::InitOutputs() {
-  Logger::Debug("Initializing output files");
-  output_mgr_.Init(&params_, &species_, space_.GetStruct(), &i_step_,
+  LOG_DEBUG("Initializing output files");
+  output_mgr_.Init(&params_, &species_, space_.GetStruct(), &out_step_,
                    run_name_);
   //if (!params_.load_checkpoint)
     iengine_.InitOutputs();
@@ -442,12 +687,22 @@ void Simulation::InitInputs(run_options run_opts) {
 
 /* Write object positions, etc if necessary */
 void Simulation::WriteOutputs() {
+  if (!output_step_) {
+    return;
+  }
+  ProfileTimer timer(profile_phase::outputs);
   output_mgr_.WriteOutputs();
+  /* Analyze this step's spec frames, if running analyses in situ */
+  if (params_.in_situ_analysis) {
+    in_situ_.Update(out_step_);
+  }
   /* Write interaction information/crosslink positions, etc */
-  iengine_.WriteOutputs();
+  iengine_.WriteOutputs(out_step_);
+  /* Hand this step's output frame to the background writers */
+  AsyncOutput::EndFrame();
   /* If we are analyzing run time and this is the last step, record final time
    * here. */
-  if (params_.time_analysis && i_step_ == params_.n_steps) {
+  if (params_.time_analysis && out_step_ == params_.n_steps) {
     double cpu_final_time = cpu_time();
     double cpu_time = cpu_final_time - cpu_init_time_;
     Logger::Info("CPU Time for Initialization: %2.6f", cpu_init_time_);
@@ -465,6 +720,8 @@ void Simulation::ProcessOutputs(system_parameters params,
   // Ensure that we are not trying to load any checkpoints when processing
   // outputs
   params_.load_checkpoint = 0;
+  // In-situ analysis only applies while simulating
+  params_.in_situ_analysis = 0;
   InitProcessing(run_opts);
   RunProcessing(run_opts);
   ClearSimulation();
@@ -473,7 +730,9 @@ void Simulation::ProcessOutputs(system_parameters params,
 // Initialize data structures for post-processing
 void Simulation::InitProcessing(run_options run_opts) {
   Logger::Info("Initializing datastructures for post-processing outputs");
+  checkpoints_.Init(params_.async_checkpoints, params_.checkpoint_delta);
   space_.Init(&params_);
+  InitContext();
   InitObjects();
   InitSpecies();
   iengine_.Init(&params_, &species_, space_.GetStruct(), &i_step_, true);
@@ -496,6 +755,17 @@ void Simulation::InitProcessing(run_options run_opts) {
   } else {
     params_.graph_flag = 0;
   }
+  /* Species can analyze spec frames in place if nothing else needs their
+     members: no drawing, reducing, checkpointing or structure analysis */
+  if (params_.mmap_analysis && run_opts.analysis_flag &&
+      !params_.graph_flag && !run_opts.use_posits && !run_opts.reduce_flag &&
+      !params_.checkpoint_from_spec && !params_.local_order_analysis &&
+      !params_.polar_order_analysis && !params_.overlap_analysis &&
+      !params_.density_analysis) {
+    for (auto it = species_.begin(); it != species_.end(); ++it) {
+      (*it)->EnableSpecViews();
+    }
+  }
   // if (run_opts.analysis_flag) {
   // for (auto it=species_.begin(); it!=species_.end(); ++it) {
   //(*it)->InitAnalysis();
@@ -503,6 +773,39 @@ void Simulation::InitProcessing(run_options run_opts) {
   //}
 }
 
+/* Use spec file indices to skip frames that post-processing would read but
+   not use: equilibration frames when nothing is drawn, and every frame but
+   the last drawn frame for single-frame movies. Returns the step that was
+   skipped to, or 0 if no frames were skipped. */
+int Simulation::SeekInputs(run_options run_opts) {
+  int last_step = std::min(output_mgr_.GetLastIndexedStep(),
+                           iengine_.GetLastIndexedStep());
+  if (last_step <= 0 || last_step == INT_MAX) {
+    return 0;
+  }
+  int seek_step = 0;
+  bool draw = false;
+  if (!params_.graph_flag) {
+    seek_step = std::min(params_.n_steps_equil, last_step);
+  } else if (run_opts.single_frame && !run_opts.analysis_flag) {
+    seek_step = last_step - last_step % params_.n_graph;
+    draw = true;
+  }
+  if (seek_step <= 0) {
+    return 0;
+  }
+  i_step_ = params_.i_step = seek_step;
+  if (!output_mgr_.SeekInputs() || !iengine_.SeekInputs(seek_step)) {
+    Logger::Error("Failed to seek to step %d using spec file indices",
+                  seek_step);
+  }
+  Logger::Info("Skipped to step %d using spec file indices", seek_step);
+  if (draw) {
+    Draw(run_opts.single_frame);
+  }
+  return seek_step;
+}
+
 /* Post-processing on simulation outputs for movie generation, analysis output
  * generation, etc. */
 void Simulation::RunProcessing(run_options run_opts) {
@@ -515,15 +818,21 @@ void Simulation::RunProcessing(run_options run_opts) {
   int last_step =
       (run_opts.with_reloads ? params_.n_steps - 1 : 2 * params_.n_steps);
   bool run_analyses = run_opts.analysis_flag;
-  for (i_step_ = 1; true; ++i_step_) {
+  int first_step = 1;
+  /* Reducing and checkpointing from specs need every frame */
+  if (!run_opts.with_reloads && !run_opts.reduce_flag &&
+      !params_.checkpoint_from_spec) {
+    first_step = SeekInputs(run_opts) + 1;
+  }
+  for (i_step_ = first_step; true; ++i_step_) {
     params_.i_step = i_step_;
     // i_step_ = params_.i_step_;
     time_ = (i_step_)*params_.delta;
     PrintComplete();
     output_mgr_.ReadInputs();
     iengine_.ReadInputs();
-    if (early_exit) {
-      early_exit = false;
+    if (context_.early_exit) {
+      context_.early_exit = false;
       Logger::Info("Early exit triggered. Ending simulation.");
       if (run_analyses && i_step_ > params_.n_steps_equil) {
         for (auto it = species_.begin(); it != species_.end(); ++it) {
@@ -4,9 +4,11 @@
 #include "auxiliary.hpp"
 #include "graphics.hpp"
 #include "helpers.hpp"
+#include "in_situ_analysis.hpp"
 #include "interaction_engine.hpp"
 #include "output_manager.hpp"
 #include "space.hpp"
+#include "step_profiler.hpp"
 #include "filament_species.hpp"
 //#include "centrosome.hpp"
 //#include "bead_spring.hpp"
@@ -21,16 +23,33 @@ private:
   int i_step_ = 0;
   int n_steps_;
   int frame_num_ = 0;
-  double time_;
+  /* Step of a fixed delta run that the simulated time has reached, which is
+     what output cadences count. It is i_step_ unless the time step adapts. */
+  int out_step_ = 0;
+  bool output_step_ = true;
+  /* Adaptive time stepping: the time step lands on every multiple of
+     n_out_steps_ fixed steps, so every output falls on a full step */
+  bool adaptive_delta_ = false;
+  int n_out_steps_;
+  double delta_;
+  double time_ = 0;
   double cpu_init_time_;
   std::string run_name_;
   std::vector<std::string> posit_files_;
 
+  /* State shared by the objects of this simulation, current on the calling
+     thread from initialization until the simulation is cleared */
+  SimulationContext context_;
+  SimulationContext *previous_context_ = nullptr;
   OutputManager output_mgr_;
   system_parameters params_;
   RNG rng_;
 
+  DomainDecomposition domains_;
+  CheckpointWriter checkpoints_;
   InteractionEngine iengine_;
+  InSituAnalysis in_situ_;
+  std::vector<int> integrate_phases_; // Profiler phase of each species
 
 #ifndef NOGRAPH
   Graphics graphics_;
@@ -39,8 +58,12 @@ private:
   std::vector<SpeciesBase *> species_;
   rfh::factory species_factory_;
   void InitSimulation();
+  void InitContext();
+  void ReleaseContext();
   void InitObjects();
   void InitSpecies();
+  void InitInSituAnalysis();
+  void InitProfiler();
   void InitPositInput();
   void ClearSpecies();
   void InitOutputs();
@@ -56,17 +79,24 @@ private:
   void ReadSpeciesPositions();
   void ZeroForces();
   void Statistics();
+  void InitTimeStep();
+  void AdvanceTime();
+  void UpdateTimeStep();
+  double FitTimeStep(double delta);
+  void SetTimeStep(double delta);
   void ScaleSpeciesPositions();
   std::vector<graph_struct *> graph_array_;
   void PrintComplete();
   void InsertSpecies(bool force_overlap = false, bool processing = false);
   void RunProcessing(run_options run_opts);
+  int SeekInputs(run_options run_opts);
   void InitGraphics();
   void InitProcessing(run_options run_opts);
   UNIT_TESTER;
 
 public:
   Simulation() {}
+  ~Simulation() { ReleaseContext(); }
   void Run(system_parameters params);
   void ProcessOutputs(system_parameters params, run_options run_opts);
 };
@@ -0,0 +1,5 @@
+#include "simulation_context.hpp"
+
+SimulationContext SimulationContext::default_;
+thread_local SimulationContext *SimulationContext::current_ =
+    &SimulationContext::default_;
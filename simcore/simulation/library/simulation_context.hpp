@@ -0,0 +1,76 @@
+#ifndef _SIMCORE_SIMULATION_CONTEXT_H_
+#define _SIMCORE_SIMULATION_CONTEXT_H_
+
+#include <mutex>
+
+struct system_parameters;
+struct space_struct;
+class DomainDecomposition;
+class CheckpointWriter;
+
+/* Run-wide state of a simulation that objects need without being handed it:
+   parameters, space, dimension, time step, object and mesh id counters, the
+   seed chain of object RNGs, the early exit flag, the decomposition of the
+   system across processes, and the writer of its checkpoints. Every
+   Simulation owns its context, so independent simulations can run side by
+   side in one process, each on its own thread.
+
+   Each thread has a current context, which is a process-wide default context
+   until a Simulation makes its own current. Objects and RNGs take what they
+   need from the current context when they are constructed, and keep a
+   pointer to it, so that OpenMP threads working on them see the context of
+   the simulation that owns them. */
+class SimulationContext {
+private:
+  static SimulationContext default_;
+  static thread_local SimulationContext *current_;
+
+public:
+  system_parameters *params = nullptr;
+  space_struct *space = nullptr;
+  int n_dim = 0;
+  double delta = 0;
+  int next_oid = 0;
+  int next_mesh_id = 0;
+  long seed = 7777777;
+  /* Soft exception raised by objects or managers to end the run early */
+  bool early_exit = false;
+  DomainDecomposition *domains = nullptr;
+  CheckpointWriter *checkpoints = nullptr;
+  /* Guards the id counters and the seed chain */
+  std::mutex mtx;
+
+  /* Id counters and seed chain, saved before creating objects that must not
+     change the ids and random numbers of the simulation's own objects, and
+     restored afterwards */
+  struct Counters {
+    int next_oid;
+    int next_mesh_id;
+    long seed;
+  };
+
+  SimulationContext() {}
+  SimulationContext(const SimulationContext &) = delete;
+  SimulationContext &operator=(const SimulationContext &) = delete;
+  static SimulationContext &Current() { return *current_; }
+  Counters SaveCounters() {
+    std::lock_guard<std::mutex> lk(mtx);
+    Counters counters = {next_oid, next_mesh_id, seed};
+    return counters;
+  }
+  void RestoreCounters(Counters const &counters) {
+    std::lock_guard<std::mutex> lk(mtx);
+    next_oid = counters.next_oid;
+    next_mesh_id = counters.next_mesh_id;
+    seed = counters.seed;
+  }
+  /* Make ctx the current context of the calling thread, or the default
+     context if ctx is null, and return the previous one */
+  static SimulationContext *MakeCurrent(SimulationContext *ctx) {
+    SimulationContext *previous = current_;
+    current_ = (ctx == nullptr ? &default_ : ctx);
+    return previous;
+  }
+};
+
+#endif // _SIMCORE_SIMULATION_CONTEXT_H_
@@ -1,6 +1,18 @@
 #include "simulation_manager.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <sched.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#ifdef ENABLE_OPENMP
+#include <omp.h>
+#endif
 
-bool early_exit;
+extern char **environ;
 
 /****************************************
    ::InitManaager::
@@ -87,6 +99,10 @@ void SimulationManager::InitLogger() {
       log_name << nload.str();
     }
   }
+  int rank = DomainDecomposition::GetProcessRank();
+  if (rank > 0) {
+    log_name << "_rank" << rank;
+  }
   Logger::SetOutput((log_name.str() + ".log").c_str());
 }
 
@@ -410,10 +426,12 @@ void SimulationManager::WriteParams() {
           pvector_[i_var]["reduced"] = run_opts_.reduce_factor;
         }
         red_file_name = red_file_name + "_params.yaml";
-        std::ofstream pfile(red_file_name, std::ios_base::out);
-        YAML::Emitter out;
-        pfile << (out << pvector_[i_var]).c_str();
-        pfile.close();
+        if (DomainDecomposition::GetProcessRank() == 0) {
+          std::ofstream pfile(red_file_name, std::ios_base::out);
+          YAML::Emitter out;
+          pfile << (out << pvector_[i_var]).c_str();
+          pfile.close();
+        }
       }
       if (run_opts_.load_checkpoint) {
         pvector_[i_var]["load_checkpoint"] = 1;
@@ -434,14 +452,19 @@ void SimulationManager::WriteParams() {
         }
       }
       pvector_[i_var]["run_name"] = file_name.str();
+      run_names_.push_back(file_name.str());
       file_name << "_params.yaml";
       pfiles_.push_back(file_name.str());
-      std::ofstream pfile(file_name.str(), std::ios_base::out);
-      YAML::Emitter out;
-      pfile << (out << pvector_[i_var]).c_str();
-      pfile.close();
+      // Processes of a decomposed simulation all generate the same files
+      if (DomainDecomposition::GetProcessRank() == 0) {
+        std::ofstream pfile(file_name.str(), std::ios_base::out);
+        YAML::Emitter out;
+        pfile << (out << pvector_[i_var]).c_str();
+        pfile.close();
+      }
     }
   }
+  DomainDecomposition::WaitForProcesses();
 }
 
 /***************************************
@@ -450,20 +473,295 @@ void SimulationManager::WriteParams() {
    a YAML::Node. Parse the parameters of that node using the
    parse_params function (that is generated automatically using
    simcore_config) and create (and delete) a new simulation using
-   those parameters.
+   those parameters. Simulations that finished in an earlier run of the batch
+   are skipped with --resume, and with --jobs the rest are handed to worker
+   processes by RunSweep.
    *************************************/
 void SimulationManager::RunSimulations() {
-  int n_sims = n_var_ * n_runs_;
-  int i_sim = 1;
-  for (std::vector<std::string>::iterator it = pfiles_.begin();
-       it != pfiles_.end(); ++it) {
-    ParseParams(*it);
+  std::set<std::string> finished;
+  if (run_opts_.resume) {
+    finished = ReadFinishedRuns();
+  }
+  std::vector<int> pending;
+  for (int i_sim = 0; i_sim < (int)pfiles_.size(); ++i_sim) {
+    if (finished.count(run_names_[i_sim])) {
+      Logger::Info("Skipping finished simulation: %s",
+                   run_names_[i_sim].c_str());
+    } else {
+      pending.push_back(i_sim);
+    }
+  }
+  if (run_opts_.n_jobs != 1 && pending.size() > 1) {
+    if (DomainDecomposition::GetNProcesses() > 1) {
+      Logger::Error("Parameter sweeps with --jobs cannot be combined with "
+                    "decomposed simulations");
+    }
+    RunSweep(pending);
+    return;
+  }
+#ifdef ENABLE_OPENMP
+  if (run_opts_.threads_per_job > 0) {
+    omp_set_num_threads(run_opts_.threads_per_job);
+  }
+#endif
+  for (auto it = pending.begin(); it != pending.end(); ++it) {
+    ParseParams(pfiles_[*it]);
     sim_ = new Simulation;
     Logger::Info("Starting simulation: %s", params_.run_name.c_str());
+    auto start = std::chrono::steady_clock::now();
     sim_->Run(params_);
     delete sim_;
-    i_sim++;
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    RecordRun(run_names_[*it], 0, elapsed.count());
+  }
+}
+
+/***************************************
+   ::RunSweep::
+   Run the pending simulations of the batch in worker processes, n_jobs at a
+   time, each with threads_per_job OpenMP threads pinned to its own cores.
+   Workers are simcore itself run on a single parameter file, so each writes
+   its own log, with stdout and stderr going to <run_name>.out. The exit
+   status of every worker is logged and recorded in <run_name>.sweep, from
+   which --resume skips finished simulations.
+   *************************************/
+void SimulationManager::RunSweep(const std::vector<int> &pending) {
+  std::vector<int> cores = GetAvailableCores();
+  int n_cores = cores.size();
+  int n_jobs = run_opts_.n_jobs;
+  if (n_jobs < 1) {
+    n_jobs = std::max(1, n_cores / std::max(1, run_opts_.threads_per_job));
+  }
+  n_jobs = std::min(n_jobs, (int)pending.size());
+  if (run_opts_.threads_per_job < 1) {
+    run_opts_.threads_per_job = std::max(1, n_cores / n_jobs);
+  }
+  int n_threads = run_opts_.threads_per_job;
+  /* Workers are pinned to disjoint sets of cores if they fit */
+  std::vector<std::vector<int>> worker_cores(n_jobs);
+  if (n_jobs * n_threads <= n_cores) {
+    for (int i = 0; i < n_jobs * n_threads; ++i) {
+      worker_cores[i / n_threads].push_back(cores[i]);
+    }
+  } else {
+    Logger::Warning("%d jobs with %d threads each oversubscribe the %d "
+                    "available cores, workers will not be pinned",
+                    n_jobs, n_threads, n_cores);
+  }
+  Logger::Info("Running %lu simulations, %d at a time with %d threads each",
+               pending.size(), n_jobs, n_threads);
+
+  struct Worker {
+    int i_sim, slot;
+    std::chrono::steady_clock::time_point start;
+  };
+  std::map<pid_t, Worker> workers;
+  std::vector<int> free_slots;
+  for (int slot = n_jobs - 1; slot >= 0; --slot) {
+    free_slots.push_back(slot);
+  }
+  int n_finished = 0, n_failed = 0;
+  auto next = pending.begin();
+  while (next != pending.end() || !workers.empty()) {
+    while (next != pending.end() && !free_slots.empty()) {
+      Worker worker = {*next++, free_slots.back(),
+                       std::chrono::steady_clock::now()};
+      free_slots.pop_back();
+      pid_t pid = LaunchWorker(worker.i_sim, worker_cores[worker.slot]);
+      workers[pid] = worker;
+      Logger::Info("Starting simulation: %s (pid %d)",
+                   run_names_[worker.i_sim].c_str(), pid);
+    }
+    int wstatus;
+    pid_t pid = waitpid(-1, &wstatus, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      Logger::Error("Lost track of worker processes: %s", strerror(errno));
+    }
+    auto it = workers.find(pid);
+    if (it == workers.end()) {
+      continue;
+    }
+    Worker worker = it->second;
+    workers.erase(it);
+    free_slots.push_back(worker.slot);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - worker.start;
+    /* Deaths by signal are reported as 128 + signal, as shells do */
+    int status = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus)
+                                    : 128 + WTERMSIG(wstatus);
+    std::string run_name = run_names_[worker.i_sim];
+    RecordRun(run_name, status, elapsed.count());
+    n_finished++;
+    if (status == 0) {
+      Logger::Info("Finished simulation %s in %.1f s (%d of %lu)",
+                   run_name.c_str(), elapsed.count(), n_finished,
+                   pending.size());
+    } else {
+      n_failed++;
+      Logger::Warning("Simulation %s failed with exit status %d, see %s.log "
+                      "and %s.out",
+                      run_name.c_str(), status, run_name.c_str(),
+                      run_name.c_str());
+    }
+  }
+  if (n_failed > 0) {
+    Logger::Warning("%d of %lu simulations failed, rerun with --resume to "
+                    "retry them",
+                    n_failed, pending.size());
+  }
+}
+
+/* Cores this process is allowed to run on */
+std::vector<int> SimulationManager::GetAvailableCores() {
+  std::vector<int> cores;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int i = 0; i < CPU_SETSIZE; ++i) {
+      if (CPU_ISSET(i, &set)) {
+        cores.push_back(i);
+      }
+    }
+  }
+#endif
+  if (cores.empty()) {
+    for (int i = 0; i < (int)std::thread::hardware_concurrency(); ++i) {
+      cores.push_back(i);
+    }
+  }
+  if (cores.empty()) {
+    cores.push_back(0);
+  }
+  return cores;
+}
+
+/* Path of the running simcore executable, for starting workers */
+std::string SimulationManager::GetExecutable() {
+#ifdef __linux__
+  char path[4096];
+  ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  if (len > 0) {
+    path[len] = '\0';
+    return path;
+  }
+#endif
+  return run_opts_.exe;
+}
+
+/* Command line of the worker running simulation i_sim. Run options that a
+   single run honours are passed on, except those already written into its
+   parameter file (run name, number of runs, reloads) and the sweep options,
+   since the worker runs one simulation by itself. */
+std::vector<std::string> SimulationManager::GetWorkerArgs(int i_sim) {
+  std::vector<std::string> args = {GetExecutable(), pfiles_[i_sim]};
+  if (run_opts_.debug) {
+    args.push_back("-d");
+  }
+  if (run_opts_.graphics_flag) {
+    args.push_back("-g");
+    args.push_back(std::to_string(run_opts_.n_graph));
+  }
+  if (run_opts_.auto_graph) {
+    args.push_back("-G");
+  }
+  return args;
+}
+
+/* Fork a worker running simulation i_sim and return its pid. The worker runs
+   with OMP_NUM_THREADS set to threads_per_job and, on Linux, pinned to the
+   given cores. */
+pid_t SimulationManager::LaunchWorker(int i_sim,
+                                      const std::vector<int> &cores) {
+  /* Everything the worker needs is prepared before forking, since the child
+     of a threaded process may only make async-signal-safe calls before exec */
+  std::string out_file = run_names_[i_sim] + ".out";
+  std::vector<std::string> args = GetWorkerArgs(i_sim);
+  std::vector<char *> argv;
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    argv.push_back(&(*it)[0]);
+  }
+  argv.push_back(nullptr);
+  std::vector<std::string> env;
+  for (char **var = environ; *var != nullptr; ++var) {
+    if (strncmp(*var, "OMP_NUM_THREADS=", 16) != 0) {
+      env.push_back(*var);
+    }
+  }
+  env.push_back("OMP_NUM_THREADS=" +
+                std::to_string(run_opts_.threads_per_job));
+  std::vector<char *> envp;
+  for (auto it = env.begin(); it != env.end(); ++it) {
+    envp.push_back(&(*it)[0]);
+  }
+  envp.push_back(nullptr);
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto it = cores.begin(); it != cores.end(); ++it) {
+    CPU_SET(*it, &set);
+  }
+#endif
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid < 0) {
+    Logger::Error("Unable to start worker for %s: %s",
+                  run_names_[i_sim].c_str(), strerror(errno));
+  }
+  if (pid == 0) {
+    int fd = open(out_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+#ifdef __linux__
+    if (!cores.empty()) {
+      sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+    execve(argv[0], argv.data(), envp.data());
+    _exit(127);
+  }
+  return pid;
+}
+
+/* Run names of the batch that finished successfully according to
+   <run_name>.sweep */
+std::set<std::string> SimulationManager::ReadFinishedRuns() {
+  std::set<std::string> finished;
+  std::ifstream sweep_file(run_name_ + ".sweep");
+  std::string run_name;
+  int status;
+  double seconds;
+  while (sweep_file >> run_name >> status >> seconds) {
+    if (status == 0) {
+      finished.insert(run_name);
+    } else {
+      finished.erase(run_name);
+    }
+  }
+  if (!finished.empty()) {
+    Logger::Info("Resuming batch %s with %lu of %lu simulations finished",
+                 run_name_.c_str(), finished.size(), pfiles_.size());
+  }
+  return finished;
+}
+
+/* Append the exit status and wall time of a simulation of the batch to
+   <run_name>.sweep. Single simulations are not recorded. */
+void SimulationManager::RecordRun(std::string run_name, int status,
+                                  double seconds) {
+  if (pfiles_.size() < 2 || DomainDecomposition::GetProcessRank() != 0) {
+    return;
   }
+  std::ofstream sweep_file(run_name_ + ".sweep", std::ios::app);
+  sweep_file << run_name << " " << status << " " << seconds << std::endl;
 }
 
 /****************************************
@@ -3,6 +3,8 @@
 
 #include "simulation.hpp"
 #include "yaml-cpp/yaml.h"
+#include <set>
+#include <sys/types.h>
 
 class SimulationManager {
 private:
@@ -12,6 +14,7 @@ private:
       n_random_ = 1;            // Number of random params
   std::string run_name_ = "sc"; // simulation batch name
   std::vector<std::string> pfiles_;
+  std::vector<std::string> run_names_; // Run name of each parameter file
   Simulation *sim_;  // New sim created and destroyed for every set of
                      // parameters
   YAML::Node pnode_; // Main node to initialize pvector
@@ -29,15 +32,20 @@ private:
   void GenerateParameters();
   void WriteParams();
   void RunSimulations();
+  void RunSweep(const std::vector<int> &pending);
+  std::vector<int> GetAvailableCores();
+  std::string GetExecutable();
+  std::vector<std::string> GetWorkerArgs(int i_sim);
+  pid_t LaunchWorker(int i_sim, const std::vector<int> &cores);
+  std::set<std::string> ReadFinishedRuns();
+  void RecordRun(std::string run_name, int status, double seconds);
   void ParseParams(std::string file_name);
   void ProcessOutputs();
   void InitLogger();
   UNIT_TESTER;
 
 public:
-  SimulationManager() {
-    early_exit = false;
-  }
+  SimulationManager() {}
   ~SimulationManager() {
     if (rng_ != nullptr) {
       delete rng_;
@@ -136,8 +136,10 @@ void Site::Draw(std::vector<graph_struct*>* graph_array) {
 }
 
 void Site::WriteSpec(std::fstream &op) {
-  for (int i=0; i<3; ++i)
-    op.write(reinterpret_cast<char *>(&position_[i]), sizeof(double));
+  for (int i=0; i<3; ++i) {
+    double q = SpecCompression::Quantize(op, position_[i]);
+    op.write(reinterpret_cast<char *>(&q), sizeof(double));
+  }
 }
 
 void Site::ReadSpec(std::fstream &ip) {
@@ -13,6 +13,13 @@ class SoftPotential : public PotentialBase {
  public:
   SoftPotential() {}
   void CalcPotential(Interaction &ix) {
+    if (n_dim_ == 2) {
+      CalcPotential<2>(ix);
+    } else {
+      CalcPotential<3>(ix);
+    }
+  }
+  template <int N_DIM> void CalcPotential(Interaction &ix) {
     if (current_step_ != *i_step_) {
       int n_steps = *i_step_ - current_step_;
       current_step_ = *i_step_;
@@ -39,17 +46,8 @@ class SoftPotential : public PotentialBase {
     if (ABS(ffac) > fcut_) {
       ffac = SIGNOF(ffac) * fcut_;
     }
-    double fmag = 0.0;
-    for (int i = 0; i < n_dim_; ++i) {
-      /* The final factor of dr is applied HERE */
-      ix.force[i] = ffac * dr[i];
-      fmag += ix.force[i] * ix.force[i];
-    }
-    // printf("%2.2f %2.2f %2.2f\n", dr[0], dr[1], dr[2]);
-    // printf("%2.2f\n", sqrt(fmag));
-    for (int i = 0; i < n_dim_; ++i)
-      for (int j = 0; j < n_dim_; ++j)
-        ix.stress[n_dim_ * i + j] = -dr[i] * ix.force[j];
+    /* The final factor of dr is applied HERE */
+    SetCentralForce<N_DIM>(ix, dr, ffac, 1.0);
     ix.pote = exp1;
   }
 
@@ -55,6 +55,7 @@ class Space {
   void ConstantVolume();
   space_struct *GetStruct();
   bool GetUpdate() { return update_; }
+  void SetTimeStep(double delta) { delta_ = delta; }
 };
 
 #endif  // _SIMCORE_SPACE_PROPERTIES_H_
@@ -0,0 +1,213 @@
+#include "spec_compression.hpp"
+#ifdef ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+const int codec_stored = 0;
+const int codec_zstd = 1;
+const int zstd_level = 3;
+/* raw_size, stored_size, codec, delta */
+const int block_header_size = 2 * sizeof(uint32_t) + 2;
+} // namespace
+
+const int SpecCompression::quantize_flag_index_ = std::ios_base::xalloc();
+const int SpecCompression::quantize_exp_index_ = std::ios_base::xalloc();
+thread_local std::map<std::fstream *, CompressedSpecWriter *>
+    SpecCompression::writers_;
+thread_local std::map<std::fstream *, CompressedSpecReader *>
+    SpecCompression::readers_;
+
+CompressedSpecWriter::CompressedSpecWriter(std::streambuf *sink)
+    : sink_(sink) {}
+
+CompressedSpecWriter::int_type CompressedSpecWriter::overflow(int_type c) {
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    frame_.push_back(traits_type::to_char_type(c));
+  }
+  return traits_type::not_eof(c);
+}
+
+std::streamsize CompressedSpecWriter::xsputn(const char *s,
+                                             std::streamsize n) {
+  frame_.insert(frame_.end(), s, s + n);
+  return n;
+}
+
+int CompressedSpecWriter::sync() {
+  if (EncodeFrame() != 0) {
+    return -1;
+  }
+  return sink_->pubsync();
+}
+
+/* Compress the current frame and write it to the sink as one block */
+int CompressedSpecWriter::EncodeFrame() {
+  if (frame_.empty()) {
+    return 0;
+  }
+  uint32_t raw_size = frame_.size();
+  unsigned char delta = (frame_.size() == prev_.size());
+  work_.resize(raw_size);
+  for (uint32_t i = 0; i < raw_size; ++i) {
+    work_[i] = (delta ? frame_[i] ^ prev_[i] : frame_[i]);
+  }
+  unsigned char codec = codec_stored;
+  uint32_t stored_size = raw_size;
+  const char *payload = work_.data();
+#ifdef ENABLE_ZSTD
+  out_.resize(ZSTD_compressBound(raw_size));
+  size_t size = ZSTD_compress(out_.data(), out_.size(), work_.data(),
+                              raw_size, zstd_level);
+  if (ZSTD_isError(size)) {
+    Logger::Error("Spec frame compression failed: %s",
+                  ZSTD_getErrorName(size));
+  }
+  if (size < raw_size) {
+    codec = codec_zstd;
+    stored_size = size;
+    payload = out_.data();
+  }
+#endif
+  char header[block_header_size];
+  std::copy(reinterpret_cast<char *>(&raw_size),
+            reinterpret_cast<char *>(&raw_size) + sizeof(uint32_t), header);
+  std::copy(reinterpret_cast<char *>(&stored_size),
+            reinterpret_cast<char *>(&stored_size) + sizeof(uint32_t),
+            header + sizeof(uint32_t));
+  header[2 * sizeof(uint32_t)] = codec;
+  header[2 * sizeof(uint32_t) + 1] = delta;
+  if (sink_->sputn(header, block_header_size) != block_header_size ||
+      sink_->sputn(payload, stored_size) != stored_size) {
+    return -1;
+  }
+  frame_.swap(prev_);
+  frame_.clear();
+  return 0;
+}
+
+/* Decode the next block of the file once the current frame is used up */
+CompressedSpecReader::int_type CompressedSpecReader::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  char header[block_header_size];
+  if (source_->sgetn(header, block_header_size) != block_header_size) {
+    return traits_type::eof();
+  }
+  uint32_t raw_size, stored_size;
+  std::copy(header, header + sizeof(uint32_t),
+            reinterpret_cast<char *>(&raw_size));
+  std::copy(header + sizeof(uint32_t), header + 2 * sizeof(uint32_t),
+            reinterpret_cast<char *>(&stored_size));
+  int codec = header[2 * sizeof(uint32_t)];
+  bool delta = header[2 * sizeof(uint32_t) + 1];
+  in_.resize(stored_size);
+  if (source_->sgetn(in_.data(), stored_size) != stored_size) {
+    Logger::Warning("Compressed spec file ends with a truncated frame");
+    return traits_type::eof();
+  }
+  if (codec == codec_stored && stored_size == raw_size) {
+    next_.swap(in_);
+  } else if (codec == codec_zstd) {
+#ifdef ENABLE_ZSTD
+    next_.resize(raw_size);
+    size_t size = ZSTD_decompress(next_.data(), raw_size, in_.data(),
+                                  stored_size);
+    if (ZSTD_isError(size) || size != raw_size) {
+      Logger::Error("Spec frame decompression failed");
+    }
+#else
+    Logger::Error("Spec file is compressed with zstd, but simcore was built "
+                  "without zstd support");
+#endif
+  } else {
+    Logger::Error("Compressed spec file has a corrupt frame header");
+  }
+  if (delta) {
+    if (frame_.size() != raw_size) {
+      Logger::Error("Compressed spec file has a delta frame without a "
+                    "matching reference frame");
+    }
+    for (uint32_t i = 0; i < raw_size; ++i) {
+      next_[i] ^= frame_[i];
+    }
+  }
+  frame_.swap(next_);
+  if (frame_.empty()) {
+    return traits_type::eof();
+  }
+  setg(frame_.data(), frame_.data(), frame_.data() + frame_.size());
+  return traits_type::to_int_type(*gptr());
+}
+
+void SpecCompression::AttachOutput(std::fstream &ofile, double tolerance) {
+  if (writers_.count(&ofile)) {
+    return;
+  }
+  if (!HasZstd()) {
+    Logger::Warning("simcore was built without zstd, spec frames will be "
+                    "delta encoded but not compressed");
+  }
+  uint32_t magic = magic_;
+  ofile.write(reinterpret_cast<char *>(&magic), sizeof(uint32_t));
+  ofile.flush();
+  CompressedSpecWriter *writer =
+      new CompressedSpecWriter(static_cast<std::ios &>(ofile).rdbuf());
+  static_cast<std::ios &>(ofile).rdbuf(writer);
+  writers_[&ofile] = writer;
+  SetTolerance(ofile, tolerance);
+}
+
+bool SpecCompression::HasZstd() {
+#ifdef ENABLE_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SpecCompression::SetTolerance(std::ios_base &os, double tolerance) {
+  if (tolerance > 0) {
+    int exp;
+    frexp(tolerance, &exp);
+    os.iword(quantize_flag_index_) = 1;
+    os.iword(quantize_exp_index_) = exp - 1;
+  }
+}
+
+/* Check whether the input spec file, positioned just after its header, is
+   compressed, and if so attach a reader to it. Returns true if it is. */
+bool SpecCompression::AttachInput(std::fstream &ifile) {
+  Detach(ifile);
+  std::streampos pos = ifile.tellg();
+  uint32_t magic = 0;
+  ifile.read(reinterpret_cast<char *>(&magic), sizeof(uint32_t));
+  if (!ifile.good() || magic != magic_) {
+    ifile.clear();
+    ifile.seekg(pos);
+    return false;
+  }
+  CompressedSpecReader *reader =
+      new CompressedSpecReader(static_cast<std::ios &>(ifile).rdbuf());
+  static_cast<std::ios &>(ifile).rdbuf(reader);
+  readers_[&ifile] = reader;
+  return true;
+}
+
+void SpecCompression::Detach(std::fstream &file) {
+  auto wt = writers_.find(&file);
+  if (wt != writers_.end()) {
+    file.flush();
+    static_cast<std::ios &>(file).rdbuf(wt->second->GetSink());
+    file.iword(quantize_flag_index_) = 0;
+    delete wt->second;
+    writers_.erase(wt);
+  }
+  auto rt = readers_.find(&file);
+  if (rt != readers_.end()) {
+    static_cast<std::ios &>(file).rdbuf(rt->second->GetSource());
+    delete rt->second;
+    readers_.erase(rt);
+  }
+}
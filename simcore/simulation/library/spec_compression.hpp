@@ -0,0 +1,107 @@
+#ifndef _SIMCORE_SPEC_COMPRESSION_H_
+#define _SIMCORE_SPEC_COMPRESSION_H_
+
+#include "logger.hpp"
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <streambuf>
+#include <vector>
+
+/* Compressed spec streams. The spec file header (n_steps, n_spec, delta) is
+   written uncompressed, followed by a magic number and one block per spec
+   frame:
+
+     uint32 raw_size, uint32 stored_size, uint8 codec, uint8 delta,
+     char payload[stored_size]
+
+   If a frame has the same size as the previous frame (the usual case, since
+   frames only change size when members are added or removed), the frame is
+   XOR'd bytewise with the previous frame before it is compressed, so that
+   the unchanged bytes of the frame compress to almost nothing. The payload is
+   compressed with zstd (codec 1) when simcore is built with zstd, and stored
+   as is (codec 0) otherwise.
+
+   Only one frame is held in memory at a time, along with the previous frame
+   used as the delta reference. The writer is told that a frame is complete
+   when the stream is flushed, and the reader decodes a frame whenever the
+   stream runs out of input, so compressed spec files are read through the
+   usual ReadSpecs calls. */
+class CompressedSpecWriter : public std::streambuf {
+private:
+  std::streambuf *sink_;
+  std::vector<char> frame_; // Frame being written by the simulation
+  std::vector<char> prev_;  // Previous frame, used as delta reference
+  std::vector<char> work_;
+  std::vector<char> out_;
+  int EncodeFrame();
+
+protected:
+  int_type overflow(int_type c);
+  std::streamsize xsputn(const char *s, std::streamsize n);
+  int sync();
+
+public:
+  CompressedSpecWriter(std::streambuf *sink);
+  std::streambuf *GetSink() { return sink_; }
+};
+
+class CompressedSpecReader : public std::streambuf {
+private:
+  std::streambuf *source_;
+  std::vector<char> frame_; // Current frame, delta reference for the next
+  std::vector<char> next_;
+  std::vector<char> in_;
+
+protected:
+  int_type underflow();
+
+public:
+  CompressedSpecReader(std::streambuf *source) : source_(source) {}
+  std::streambuf *GetSource() { return source_; }
+};
+
+/* Registry of spec file streams that are read or written through compressed
+   stream buffers. Output streams are attached right after the spec header is
+   written, and input streams right after the header is read, when the file
+   turns out to be compressed. Streams must be detached before they are
+   closed (and after any AsyncOutput buffer on top of them is detached).
+
+   Output streams may also be given a quantization tolerance, which is stored
+   with the stream itself so that objects writing their specs to it can round
+   positions and orientations with Quantize. Checkpoints are written with the
+   same WriteSpec functions to their own streams, and are never quantized. */
+class SpecCompression {
+private:
+  static const uint32_t magic_ = 0x315A4353; // "SCZ1"
+  static const int quantize_flag_index_;
+  static const int quantize_exp_index_;
+  /* Per thread, like the streams of the simulation that attached them */
+  static thread_local std::map<std::fstream *, CompressedSpecWriter *> writers_;
+  static thread_local std::map<std::fstream *, CompressedSpecReader *> readers_;
+
+public:
+  static void AttachOutput(std::fstream &ofile, double tolerance);
+  static bool AttachInput(std::fstream &ifile);
+  static bool IsCompressed(std::fstream &file) {
+    return writers_.count(&file) || readers_.count(&file);
+  }
+  static void Detach(std::fstream &file);
+  /* Whether frames are compressed with zstd or only delta encoded */
+  static bool HasZstd();
+  /* Quantize positions and orientations written to os to tolerance */
+  static void SetTolerance(std::ios_base &os, double tolerance);
+  /* Round x to the quantization step of the stream, if any. The step is the
+     largest power of two not exceeding the tolerance, so quantized values
+     have trailing zero mantissa bits and the rounding is exact. */
+  static double Quantize(std::ios_base &os, double x) {
+    if (!os.iword(quantize_flag_index_)) {
+      return x;
+    }
+    int exp = os.iword(quantize_exp_index_);
+    return ldexp(round(ldexp(x, -exp)), exp);
+  }
+};
+
+#endif // _SIMCORE_SPEC_COMPRESSION_H_
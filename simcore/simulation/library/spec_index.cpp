@@ -0,0 +1,160 @@
+#include "spec_index.hpp"
+
+void SpecIndex::WriteHeader(std::fstream &oindex) {
+  int magic = magic_;
+  int version = version_;
+  int endianness = 1;
+  int sid_length = sid_.size();
+  oindex.write(reinterpret_cast<char *>(&magic), sizeof(int));
+  oindex.write(reinterpret_cast<char *>(&version), sizeof(int));
+  oindex.write(reinterpret_cast<char *>(&endianness), sizeof(int));
+  oindex.write(reinterpret_cast<char *>(&n_dim_), sizeof(int));
+  oindex.write(reinterpret_cast<char *>(&delta_), sizeof(double));
+  oindex.write(reinterpret_cast<char *>(&n_steps_), sizeof(int));
+  oindex.write(reinterpret_cast<char *>(&n_spec_), sizeof(int));
+  oindex.write(reinterpret_cast<char *>(&sid_length), sizeof(int));
+  oindex.write(sid_.c_str(), sid_length);
+}
+
+/* Returns true if the index header matches this spec file */
+bool SpecIndex::ReadHeader(std::fstream &iindex) {
+  int magic = -1, version = -1, endianness = -1, n_dim = -1, n_steps = -1,
+      n_spec = -1, sid_length = -1;
+  double delta = -1;
+  iindex.read(reinterpret_cast<char *>(&magic), sizeof(int));
+  iindex.read(reinterpret_cast<char *>(&version), sizeof(int));
+  iindex.read(reinterpret_cast<char *>(&endianness), sizeof(int));
+  if (magic != magic_ || endianness != 1) {
+    Logger::Warning("Spec index file %s is not a spec index or has the wrong "
+                    "endianness, ignoring",
+                    index_file_.c_str());
+    return false;
+  }
+  if (version != version_) {
+    Logger::Warning("Spec index file %s has unsupported version %d, ignoring",
+                    index_file_.c_str(), version);
+    return false;
+  }
+  iindex.read(reinterpret_cast<char *>(&n_dim), sizeof(int));
+  iindex.read(reinterpret_cast<char *>(&delta), sizeof(double));
+  iindex.read(reinterpret_cast<char *>(&n_steps), sizeof(int));
+  iindex.read(reinterpret_cast<char *>(&n_spec), sizeof(int));
+  iindex.read(reinterpret_cast<char *>(&sid_length), sizeof(int));
+  if (!iindex.good() || sid_length < 0 || sid_length > 1024) {
+    Logger::Warning("Spec index file %s has a corrupt header, ignoring",
+                    index_file_.c_str());
+    return false;
+  }
+  std::string sid(sid_length, ' ');
+  iindex.read(&sid[0], sid_length);
+  if (n_dim != n_dim_ || delta != delta_ || n_steps != n_steps_ ||
+      n_spec != n_spec_ || sid.compare(sid_) != 0) {
+    Logger::Warning("Spec index file %s does not match parameter file, "
+                    "ignoring",
+                    index_file_.c_str());
+    return false;
+  }
+  return true;
+}
+
+void SpecIndex::InitOutput(std::string spec_file_name, int n_dim,
+                           double delta, int n_steps, int n_spec,
+                           std::string sid) {
+  n_dim_ = n_dim;
+  delta_ = delta;
+  n_steps_ = n_steps;
+  n_spec_ = n_spec;
+  sid_ = sid;
+  index_file_ = GetIndexFileName(spec_file_name);
+  oindex_.open(index_file_, std::ios::out | std::ios::binary);
+  if (!oindex_.is_open()) {
+    Logger::Error("Output file %s did not open", index_file_.c_str());
+  }
+  WriteHeader(oindex_);
+}
+
+/* Record the offset of the spec frame that is about to be written */
+void SpecIndex::AddFrame(std::streamoff offset) {
+  if (!oindex_.is_open()) {
+    return;
+  }
+  if (offset < 0) {
+    Logger::Error("Failed to get spec file offset for index file %s",
+                  index_file_.c_str());
+  }
+  int64_t frame_offset = offset;
+  oindex_.write(reinterpret_cast<char *>(&frame_offset), sizeof(int64_t));
+}
+
+/* Load the index of the given spec file. If there is no usable index, frame
+   offsets are instead recorded while the spec file is read, and the index is
+   written on Close. Returns true if an index was loaded. */
+bool SpecIndex::InitInput(std::string spec_file_name, int n_dim, double delta,
+                          int n_steps, int n_spec, std::string sid) {
+  n_dim_ = n_dim;
+  delta_ = delta;
+  n_steps_ = n_steps;
+  n_spec_ = n_spec;
+  sid_ = sid;
+  index_file_ = GetIndexFileName(spec_file_name);
+  offsets_.clear();
+  building_ = true;
+  std::fstream iindex(index_file_, std::ios::in | std::ios::binary);
+  if (!iindex.is_open()) {
+    LOG_DEBUG("No spec index file %s, building index while reading",
+              index_file_.c_str());
+    return false;
+  }
+  if (!ReadHeader(iindex)) {
+    return false;
+  }
+  int64_t offset;
+  while (iindex.read(reinterpret_cast<char *>(&offset), sizeof(int64_t))) {
+    offsets_.push_back(offset);
+  }
+  iindex.close();
+  building_ = false;
+  LOG_DEBUG("Loaded spec index file %s with %lu frames",
+            index_file_.c_str(), offsets_.size());
+  return true;
+}
+
+/* Record the offset of a spec frame that was read from an unindexed file */
+void SpecIndex::RecordFrame(std::streamoff offset) {
+  if (building_ && offset >= 0) {
+    offsets_.push_back(offset);
+  }
+}
+
+/* Position the input spec file at the beginning of frame i_frame */
+bool SpecIndex::SeekFrame(std::fstream &ispec, int i_frame) {
+  if (building_ || i_frame < 0 || i_frame >= offsets_.size()) {
+    return false;
+  }
+  ispec.clear();
+  ispec.seekg(offsets_[i_frame]);
+  return ispec.good();
+}
+
+void SpecIndex::Close() {
+  if (oindex_.is_open()) {
+    oindex_.close();
+  }
+  if (building_ && !offsets_.empty()) {
+    std::fstream oindex(index_file_, std::ios::out | std::ios::binary);
+    if (oindex.is_open()) {
+      WriteHeader(oindex);
+      for (auto it = offsets_.begin(); it != offsets_.end(); ++it) {
+        oindex.write(reinterpret_cast<char *>(&(*it)), sizeof(int64_t));
+      }
+      oindex.close();
+      Logger::Info("Wrote spec index file %s with %lu frames",
+                   index_file_.c_str(), offsets_.size());
+    } else {
+      Logger::Warning("Unable to write spec index file %s",
+                      index_file_.c_str());
+    }
+  }
+  building_ = false;
+  offsets_.clear();
+}
@@ -0,0 +1,57 @@
+#ifndef _SIMCORE_SPEC_INDEX_H_
+#define _SIMCORE_SPEC_INDEX_H_
+
+#include "logger.hpp"
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Frame index for spec files. Spec frames vary in size with the number of
+   members, bonds and crosslinks, so finding a frame otherwise requires reading
+   every frame before it. The index is written next to the spec file as
+   <spec_file>.index and holds a header followed by the byte offset of every
+   frame in the spec file:
+
+     int magic, int version, int endianness (= 1), int n_dim, double delta,
+     int n_steps, int n_spec, int sid_length, char sid[sid_length],
+     int64 offset[n_frames]
+
+   Spec files themselves are unchanged, so unindexed spec files remain
+   readable, and an index is built for them the first time they are read
+   sequentially. */
+class SpecIndex {
+private:
+  static const int magic_ = 0x58444953; // "SIDX"
+  static const int version_ = 1;
+  int n_dim_ = 0;
+  int n_steps_ = 0;
+  int n_spec_ = 0;
+  double delta_ = 0;
+  std::string sid_;
+  std::string index_file_;
+  std::fstream oindex_;
+  /* Frame offsets read from an existing index, or recorded while reading a
+     spec file that had no index */
+  std::vector<int64_t> offsets_;
+  bool building_ = false;
+  void WriteHeader(std::fstream &oindex);
+  bool ReadHeader(std::fstream &iindex);
+
+public:
+  static std::string GetIndexFileName(std::string spec_file_name) {
+    return spec_file_name + ".index";
+  }
+  void InitOutput(std::string spec_file_name, int n_dim, double delta,
+                  int n_steps, int n_spec, std::string sid);
+  void AddFrame(std::streamoff offset);
+  bool InitInput(std::string spec_file_name, int n_dim, double delta,
+                 int n_steps, int n_spec, std::string sid);
+  void RecordFrame(std::streamoff offset);
+  bool SeekFrame(std::fstream &ispec, int i_frame);
+  int GetNFrames() const { return (building_ ? 0 : offsets_.size()); }
+  void Close();
+};
+
+#endif // _SIMCORE_SPEC_INDEX_H_
@@ -0,0 +1,44 @@
+#include "spec_map.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Map the whole spec file, with the cursor at offset. Returns false if the
+   file cannot be mapped, in which case the caller keeps reading it as a
+   stream. */
+bool SpecMap::Open(std::string file_name, size_t offset) {
+  Close();
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  /* The mapping stays valid after the descriptor is closed */
+  close(fd);
+  if (addr == MAP_FAILED) {
+    LOG_DEBUG("Unable to map spec file %s", file_name.c_str());
+    return false;
+  }
+  madvise(addr, st.st_size, MADV_SEQUENTIAL);
+  data_ = static_cast<const char *>(addr);
+  size_ = st.st_size;
+  cursor_ = offset;
+  file_name_ = file_name;
+  LOG_DEBUG("Mapped spec file %s (%lu bytes)", file_name.c_str(), size_);
+  return true;
+}
+
+void SpecMap::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = cursor_ = 0;
+  file_name_.clear();
+}
@@ -0,0 +1,64 @@
+#ifndef _SIMCORE_SPEC_MAP_H_
+#define _SIMCORE_SPEC_MAP_H_
+
+#include "logger.hpp"
+#include <cstring>
+#include <string>
+
+/* Read-only view of a value of type T stored every stride bytes in a spec
+   file mapped into memory. Spec files are packed, so values are not
+   necessarily aligned and are copied out rather than dereferenced. */
+template <typename T> class SpecView {
+private:
+  const char *base_ = nullptr;
+  size_t stride_ = sizeof(T);
+  int size_ = 0;
+
+public:
+  SpecView() {}
+  SpecView(const char *base, int size, size_t stride = sizeof(T))
+      : base_(base), stride_(stride), size_(size) {}
+  int size() const { return size_; }
+  T operator[](int i) const {
+    T value;
+    std::memcpy(&value, base_ + i * stride_, sizeof(T));
+    return value;
+  }
+};
+
+/* Spec file mapped into memory for post-processing. Frames are parsed in
+   place by species-specific frame views, which only record where each field
+   lives in the file, so reading a frame costs no copies or allocations once
+   the view has been sized. The cursor is the offset of the next unread
+   frame. */
+class SpecMap {
+private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  size_t cursor_ = 0;
+  std::string file_name_;
+
+public:
+  SpecMap() {}
+  SpecMap(const SpecMap &) = delete;
+  SpecMap &operator=(const SpecMap &) = delete;
+  ~SpecMap() { Close(); }
+  bool Open(std::string file_name, size_t offset);
+  void Close();
+  bool IsOpen() const { return data_ != nullptr; }
+  const char *GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+  size_t GetCursor() const { return cursor_; }
+  void SetCursor(size_t offset) { cursor_ = offset; }
+  /* Returns true if n more bytes past offset are in the file */
+  bool InRange(size_t offset, size_t n) const {
+    return offset <= size_ && n <= size_ - offset;
+  }
+  template <typename T> T Get(size_t offset) const {
+    T value;
+    std::memcpy(&value, data_ + offset, sizeof(T));
+    return value;
+  }
+};
+
+#endif // _SIMCORE_SPEC_MAP_H_
@@ -5,7 +5,7 @@ void SpeciesBase::Init(system_parameters *params, space_struct *space,
   params_ = params;
   sparams_ = &(params->species);
   space_ = space;
-  Logger::Debug("Initializing species %s", GetSID()._to_string());
+  LOG_DEBUG("Initializing species %s", GetSID()._to_string());
 }
 
 void SpeciesBase::InitPositFile(std::string run_name) {
@@ -18,6 +18,9 @@ void SpeciesBase::InitPositFile(std::string run_name) {
   oposit_file_.write(reinterpret_cast<char *>(&params_->n_steps), sizeof(int));
   oposit_file_.write(reinterpret_cast<char *>(&sparams_->n_posit), sizeof(int));
   oposit_file_.write(reinterpret_cast<char *>(&params_->delta), sizeof(double));
+  if (params_->async_output) {
+    AsyncOutput::Attach(oposit_file_);
+  }
 }
 
 void SpeciesBase::InitPositFileInput(std::string run_name) {
@@ -46,7 +49,7 @@ void SpeciesBase::InitPositFileInput(std::string run_name) {
 void SpeciesBase::InitSpecFile(std::string run_name) {
   std::string sid_str = sid_._to_string();
   std::string spec_file_name = run_name + "_" + sid_str + ".spec";
-  Logger::Trace("Initializing spec file %s", spec_file_name.c_str());
+  LOG_TRACE("Initializing spec file %s", spec_file_name.c_str());
   ospec_file_.open(spec_file_name, std::ios::out | std::ios::binary);
   if (!ospec_file_.is_open()) {
     Logger::Error("Output file %s did not open", spec_file_name.c_str());
@@ -54,6 +57,17 @@ void SpeciesBase::InitSpecFile(std::string run_name) {
   ospec_file_.write(reinterpret_cast<char *>(&params_->n_steps), sizeof(int));
   ospec_file_.write(reinterpret_cast<char *>(&sparams_->n_spec), sizeof(int));
   ospec_file_.write(reinterpret_cast<char *>(&params_->delta), sizeof(double));
+  if (params_->spec_compression) {
+    /* Compressed spec files are read sequentially and not indexed */
+    SpecCompression::AttachOutput(ospec_file_, params_->spec_tolerance);
+    std::remove(SpecIndex::GetIndexFileName(spec_file_name).c_str());
+  } else {
+    ospec_index_.InitOutput(spec_file_name, params_->n_dim, params_->delta,
+                            params_->n_steps, sparams_->n_spec, sid_str);
+  }
+  if (params_->async_output) {
+    AsyncOutput::Attach(ospec_file_);
+  }
 }
 
 bool SpeciesBase::HandleEOF() {
@@ -114,10 +128,12 @@ bool SpeciesBase::HandleEOF() {
 }
 
 bool SpeciesBase::InitSpecFileInputFromFile(std::string spec_file_name) {
+  SpecCompression::Detach(ispec_file_);
   ispec_file_.open(spec_file_name, std::ios::in | std::ios::binary);
   if (!ispec_file_.is_open()) {
     return false;
   }
+  ispec_file_name_ = spec_file_name;
   // long n_steps;
   int n_spec, n_steps;
   double delta;
@@ -132,6 +148,12 @@ bool SpeciesBase::InitSpecFileInputFromFile(std::string spec_file_name) {
     Logger::Warning("Input file %s does not match parameter file\n",
             spec_file_name.c_str());
   }
+  /* Write the index built for the previous spec file, if any */
+  ispec_index_.Close();
+  if (!SpecCompression::AttachInput(ispec_file_)) {
+    ispec_index_.InitInput(spec_file_name, params_->n_dim, params_->delta,
+                           n_steps, n_spec, sid_._to_string());
+  }
   ReadSpecs();
   return true;
 }
@@ -145,11 +167,12 @@ void SpeciesBase::InitSpecFileInput(std::string run_name) {
 }
 
 void SpeciesBase::InitOutputFiles(std::string run_name) {
-  Logger::Trace("Initializing output files for species %s",
+  LOG_TRACE("Initializing output files for species %s",
       sid_._to_string());
   if (sparams_->posit_flag)
     InitPositFile(run_name);
-  if (sparams_->spec_flag)
+  /* Spec frames are analyzed in memory during in-situ analysis */
+  if (sparams_->spec_flag && !params_->in_situ_analysis)
     InitSpecFile(run_name);
   if (sparams_->checkpoint_flag)
     InitCheckpoints(run_name);
@@ -164,7 +187,7 @@ void SpeciesBase::LoadFromCheckpoints(std::string run_name,
                                       std::string checkpoint_run_name) {
   std::string sid_str = sid_._to_string();
   checkpoint_file_ = checkpoint_run_name + "_" + sid_str + ".checkpoint";
-  Logger::Trace("Loading species %s from checkpoint file %s",
+  LOG_TRACE("Loading species %s from checkpoint file %s",
       sid_._to_string(), checkpoint_file_.c_str());
   if (!sparams_->checkpoint_flag) {
     Logger::Error("Checkpoint file %s not available for parameter file!",
@@ -186,7 +209,11 @@ void SpeciesBase::InitInputFiles(std::string run_name, bool posits_only,
 }
 
 void SpeciesBase::CloseFiles() {
-  Logger::Trace("Closing output files for species %s", sid_._to_string());
+  LOG_TRACE("Closing output files for species %s", sid_._to_string());
+  AsyncOutput::Detach(oposit_file_);
+  AsyncOutput::Detach(ospec_file_);
+  SpecCompression::Detach(ospec_file_);
+  SpecCompression::Detach(ispec_file_);
   if (oposit_file_.is_open())
     oposit_file_.close();
   if (iposit_file_.is_open())
@@ -195,5 +222,19 @@ void SpeciesBase::CloseFiles() {
     ospec_file_.close();
   if (ispec_file_.is_open())
     ispec_file_.close();
+  ospec_index_.Close();
+  ispec_index_.Close();
   // FinalizeAnalysis();
 }
+
+/* Read spec frame i_frame of the current input spec file directly, using the
+   spec index. Returns false if the frame is not indexed. */
+bool SpeciesBase::SeekSpecFrame(int i_frame) {
+  if (!ispec_file_.is_open() || !ispec_index_.SeekFrame(ispec_file_, i_frame)) {
+    return false;
+  }
+  ReadSpecs();
+  return true;
+}
+
+int SpeciesBase::GetNSpecFrames() { return ispec_index_.GetNFrames(); }
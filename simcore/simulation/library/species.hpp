@@ -1,8 +1,12 @@
 #ifndef _SIMCORE_SPECIES_H_
 #define _SIMCORE_SPECIES_H_
 
+#include "async_output.hpp"
 #include "auxiliary.hpp"
+#include "checkpoint_writer.hpp"
 #include "object.hpp"
+#include "spec_compression.hpp"
+#include "spec_index.hpp"
 #include "yaml-cpp/yaml.h"
 
 class SpeciesBase {
@@ -20,6 +24,9 @@ protected:
   std::fstream iposit_file_;
   std::fstream ospec_file_;
   std::fstream ispec_file_;
+  std::string ispec_file_name_;
+  SpecIndex ospec_index_;
+  SpecIndex ispec_index_;
   std::string checkpoint_file_;
   std::vector<std::string> spec_file_names_;
 
@@ -65,6 +72,11 @@ public:
   virtual void ReadCheckpoints() {}
   virtual void ReadPosits() {}
   virtual void ReadPositsFromSpecs() {}
+  virtual void WriteSpecFrame(std::fstream &ospec) {}
+  virtual void ReadSpecFrame(std::fstream &ispec) {}
+  /* Species may read spec frames without rebuilding their members during
+     analysis once this is called */
+  virtual void EnableSpecViews() {}
   virtual void InitAnalysis() {}
   virtual void RunAnalysis() {}
   virtual void FinalizeAnalysis() {}
@@ -83,11 +95,16 @@ public:
   virtual int OutputIsOpen() { return oposit_file_.is_open(); }
   virtual int InputIsOpen() { return iposit_file_.is_open(); }
   virtual void CloseFiles();
+  virtual bool SeekSpecFrame(int i_frame);
+  virtual int GetNSpecFrames();
   virtual void CleanUp() {}
   virtual void Reserve() {}
   virtual double const GetVolume() { return 0; }
   virtual double const GetDrMax() { return 0; }
   virtual void ZeroDrTot() {}
+  virtual double const GetDrStepMax() { return 0; }
+  virtual void ZeroDrStep() {}
+  virtual void SetTimeStep(double delta) {}
   virtual void CustomInsert() {}
   virtual const bool CheckInteractorUpdate() { return false; }
 };
@@ -95,6 +112,7 @@ public:
 template <typename T> class Species : public SpeciesBase {
 protected:
   std::vector<T> members_;
+  void ReadSpecMembers(std::fstream &ispec, int size);
 
 public:
   Species() {}
@@ -126,6 +144,8 @@ public:
   virtual void ReadPosits();
   virtual void ReadPositsFromSpecs();
   virtual void ReadSpecs();
+  virtual void WriteSpecFrame(std::fstream &ospec);
+  virtual void ReadSpecFrame(std::fstream &ispec);
   virtual void ReadCheckpoints();
   virtual void ScalePositions();
   virtual void InitAnalysis() {}
@@ -137,6 +157,9 @@ public:
   virtual double const GetVolume();
   virtual double const GetDrMax();
   virtual void ZeroDrTot();
+  virtual double const GetDrStepMax();
+  virtual void ZeroDrStep();
+  virtual void SetTimeStep(double delta);
   virtual double GetSpecLength();
   virtual double GetSpecDiameter();
   virtual void CustomInsert();
@@ -12,8 +12,8 @@ template <typename T> void Species<T>::Reserve() {
 
 template <typename T> void Species<T>::AddMember() {
   T newmember;
-  Logger::Trace("Adding member to species %s, member number %d, member id %d",
-                GetSID()._to_string(), n_members_ + 1, newmember.GetOID());
+  LOG_TRACE("Adding member to species %s, member number %d, member id %d",
+            GetSID()._to_string(), n_members_ + 1, newmember.GetOID());
   members_.push_back(newmember);
   members_.back().SetSID(GetSID());
   members_.back().Init();
@@ -38,16 +38,39 @@ template <typename T> void Species<T>::ZeroDrTot() {
   }
 }
 
+template <typename T> double const Species<T>::GetDrStepMax() {
+  double max_dr = 0;
+  for (auto it = members_.begin(); it != members_.end(); ++it) {
+    double dr = it->GetDrStep();
+    if (dr > max_dr) {
+      max_dr = dr;
+    }
+  }
+  return max_dr;
+}
+
+template <typename T> void Species<T>::ZeroDrStep() {
+  for (auto it = members_.begin(); it != members_.end(); ++it) {
+    it->ZeroDrStep();
+  }
+}
+
+template <typename T> void Species<T>::SetTimeStep(double delta) {
+  for (auto it = members_.begin(); it != members_.end(); ++it) {
+    it->SetTimeStep(delta);
+  }
+}
+
 template <typename T> void Species<T>::AddMember(T newmem) {
-  Logger::Trace("Adding preexisting member to species %s",
-                GetSID()._to_string());
+  LOG_TRACE("Adding preexisting member to species %s",
+            GetSID()._to_string());
   members_.push_back(newmem);
   newmem.SetSID(GetSID());
   n_members_++;
 }
 
 template <typename T> void Species<T>::PopMember() {
-  Logger::Trace("Removing last member of species %s", GetSID()._to_string());
+  LOG_TRACE("Removing last member of species %s", GetSID()._to_string());
   members_.back().Cleanup();
   members_.pop_back();
   n_members_--;
@@ -131,39 +154,46 @@ template <typename T> void Species<T>::WritePosits() {
 }
 
 template <typename T> void Species<T>::WriteSpecs() {
-  Logger::Trace("Writing spec file for species %s",
-                GetSID()._to_string());
+  LOG_TRACE("Writing spec file for species %s",
+            GetSID()._to_string());
+  ospec_index_.AddFrame(ospec_file_.tellp());
+  WriteSpecFrame(ospec_file_);
+  /* End of frame for compressed and asynchronous spec writers */
+  ospec_file_.flush();
+}
+
+/* Write one spec frame of the species to ospec, which need not be the spec
+   file */
+template <typename T> void Species<T>::WriteSpecFrame(std::fstream &ospec) {
   int size = members_.size();
-  ospec_file_.write(reinterpret_cast<char *>(&size), sizeof(size));
+  ospec.write(reinterpret_cast<char *>(&size), sizeof(size));
   for (auto it = members_.begin(); it != members_.end(); ++it)
-    it->WriteSpec(ospec_file_);
+    it->WriteSpec(ospec);
 }
 
 template <typename T> void Species<T>::WriteCheckpoints() {
-  Logger::Trace("Writing checkpoint file for species %s",
+  LOG_TRACE("Writing checkpoint file for species %s",
       GetSID()._to_string());
   int size = members_.size();
-  std::fstream ocheck_file(checkpoint_file_, std::ios::out | std::ios::binary);
-  if (!ocheck_file.is_open()) {
-    Logger::Error("Output %s file did not open", checkpoint_file_.c_str());
-  }
+  CheckpointOutput ocheck(checkpoint_file_);
+  std::fstream &ocheck_file = ocheck.GetStream();
   long seed = rng_.GetSeed();
   ocheck_file.write(reinterpret_cast<char *>(&seed), sizeof(seed));
   ocheck_file.write(reinterpret_cast<char *>(&size), sizeof(size));
   for (auto it = members_.begin(); it != members_.end(); ++it)
     it->WriteCheckpoint(ocheck_file);
-  ocheck_file.close();
+  ocheck.Commit();
 }
 
 template <typename T> void Species<T>::ReadPosits() {
   if (iposit_file_.eof()) {
     Logger::Info("EOF reached while reading posits");
-    early_exit = true;
+    SimulationContext::Current().early_exit = true;
     return;
   }
   if (!iposit_file_.is_open()) {
     Logger::Warning("ERROR Posit file unexpectedly not open! Exiting early.");
-    early_exit = true;
+    SimulationContext::Current().early_exit = true;
     return;
   }
   int size = -1;
@@ -172,7 +202,7 @@ template <typename T> void Species<T>::ReadPosits() {
   // Hacky workaround FIXME
   // This prevents strange errors that occasionally crop up when reading inputs
   if (size == -1) {
-    early_exit = true;
+    SimulationContext::Current().early_exit = true;
     return;
   }
   if (size != n_members_) {
@@ -192,10 +222,11 @@ template <typename T> void Species<T>::ReadPositsFromSpecs() {
 }
 
 template <typename T> void Species<T>::ReadCheckpoints() {
-  std::fstream icheck_file(checkpoint_file_, std::ios::in | std::ios::binary);
-  if (!icheck_file.is_open()) {
+  CheckpointInput icheck(checkpoint_file_);
+  if (!icheck.IsOpen()) {
     Logger::Error("Output %s file did not open", checkpoint_file_.c_str());
   }
+  std::fstream &icheck_file = icheck.GetStream();
   int size = 0;
   long seed = -1;
   icheck_file.read(reinterpret_cast<char *>(&seed), sizeof(seed));
@@ -206,7 +237,6 @@ template <typename T> void Species<T>::ReadCheckpoints() {
   members_.resize(size, member);
   for (auto it = members_.begin(); it != members_.end(); ++it)
     it->ReadCheckpoint(icheck_file);
-  icheck_file.close();
   rng_.SetSeed(seed);
 }
 
@@ -217,17 +247,18 @@ template <typename T> void Species<T>::ReadSpecs() {
       return;
     } else {
       Logger::Info("EOF reached in species ReadSpecs");
-      early_exit = true;
+      SimulationContext::Current().early_exit = true;
       return;
     }
   }
   if (!ispec_file_.is_open()) {
     Logger::Warning("ERROR: Spec file unexpectedly not open! Exiting early.");
-    early_exit = true;
+    SimulationContext::Current().early_exit = true;
     return;
   }
   int size = -1;
   // T *member;
+  std::streamoff offset = ispec_file_.tellg();
   ispec_file_.read(reinterpret_cast<char *>(&size), sizeof(size));
   /* For some reason, we can't catch the EOF above. If size == -1 still, then
      we caught a EOF here */
@@ -237,10 +268,27 @@ template <typename T> void Species<T>::ReadSpecs() {
       return;
     } else {
       Logger::Info("EOF reached in species");
-      early_exit = true;
+      SimulationContext::Current().early_exit = true;
       return;
     }
   }
+  ispec_index_.RecordFrame(offset);
+  ReadSpecMembers(ispec_file_, size);
+}
+
+/* Read one spec frame written by WriteSpecFrame from ispec */
+template <typename T> void Species<T>::ReadSpecFrame(std::fstream &ispec) {
+  int size = -1;
+  ispec.read(reinterpret_cast<char *>(&size), sizeof(size));
+  if (size < 0) {
+    Logger::Error("Failed to read spec frame for species %s",
+                  GetSID()._to_string());
+  }
+  ReadSpecMembers(ispec, size);
+}
+
+template <typename T>
+void Species<T>::ReadSpecMembers(std::fstream &ispec, int size) {
   if (size != n_members_) {
     T member;
     member.Init();
@@ -249,7 +297,7 @@ template <typename T> void Species<T>::ReadSpecs() {
     n_members_ = size;
   }
   for (auto it = members_.begin(); it != members_.end(); ++it)
-    it->ReadSpec(ispec_file_);
+    it->ReadSpec(ispec);
 }
 
 template <typename T> void Species<T>::ScalePositions() {
@@ -36,87 +36,52 @@ void Spherocylinder::InsertSpherocylinder() {
   }
 }
 
+/* Advance the rod on its own, in a one-slot SoA motion kernel */
 void Spherocylinder::UpdatePosition() {
-  SetPrevPosition(position_);
-  ApplyForcesTorques();
-  Integrate();
-  UpdatePeriodic();
+  BrownianMotion motion;
+  motion.Init(space_);
+  motion.UpdateMembers(this, 1, &BrownianMotion::AdvanceRods);
 }
 
-/* Integration scheme taken from Yu-Guo Tao,
-   J Chem Phys 122 244903 (2005)
-   Explicit calculation of the friction tensor acting on force vector,
-
-   r(t+dt) = r(t) + (Xi^-1 . F_s(t)) * dt + dr(t),
-
-   where friction tensor Xi = gamma_par * |u><u| + gamma_perp * (I - |u><u|),
-   u is the orientation, F_s is the force from interactions, and dr(t) is the
-   random displacement due to random force,
-
-   dr(t) = Xi^-1 . F_r * dt,
-
-   which is treated separately as a random displacement with std dev
-   sqrt(2*kT*dt/gamma_(par/perp)) along par/perp unit vectors
-   relative to rod. */
-void Spherocylinder::Integrate() {
-  double delta = (is_midstep_ ? 0.5 * delta_ : delta_);
-  // Explicit calculation of Xi.F_s
+/* Copy the rod's state and friction coefficients into slot i_slot of the
+   SoA motion kernel, drawing its random displacements along and reorientations
+   about its body frame */
+void Spherocylinder::LoadMotion(BrownianMotion &motion, int i_slot) {
+  SetPrevPosition(position_);
+  ApplyForcesTorques();
   for (int i = 0; i < n_dim_; ++i) {
-    for (int j = 0; j < n_dim_; ++j) {
-      position_[i] +=
-          gamma_par_ * orientation_[i] * orientation_[j] * force_[j] * delta;
-    }
-    position_[i] += force_[i] * gamma_perp_ * delta;
+    motion.position[i][i_slot] = position_[i];
+    motion.orientation[i][i_slot] = orientation_[i];
+    motion.force[i][i_slot] = force_[i];
   }
-  // Reorientation due to external torques
-  double du[3];
-  cross_product(torque_, orientation_, du, 3);  // ndim=3 since torques
-  for (int i = 0; i < n_dim_; ++i) {
-    orientation_[i] += du[i] * delta / gamma_rot_;
+  for (int i = 0; i < 3; ++i) {
+    motion.torque[i][i_slot] = torque_[i];
+  }
+  motion.delta[i_slot] = (is_midstep_ ? 0.5 * delta_ : delta_);
+  motion.gamma_par[i_slot] = gamma_par_;
+  motion.gamma_perp[i_slot] = gamma_perp_;
+  motion.gamma_rot[i_slot] = gamma_rot_;
+  motion.kick_par[i_slot] = gsl_ran_gaussian_ziggurat(rng_.r, diffusion_par_);
+  for (int j = 0; j < n_dim_ - 1; ++j) {
+    motion.kick_perp[j][i_slot] =
+        gsl_ran_gaussian_ziggurat(rng_.r, diffusion_perp_);
   }
-  // Add the random displacement dr(t)
-  AddRandomDisplacement();
-  // Update the orientation due to torques and random rotation
-  AddRandomReorientation();
-}
-
-/* Calculates body frame, which returns the vector(s) orthogonal
-   to u(t), then applies random displacements along each
-   orthogonal vector and along u(t) pulled from a distribution
-   with std dev sqrt(2*kT*dt/gamma) where gamma is the friction
-   coefficient along that direction */
-void Spherocylinder::AddRandomDisplacement() {
-  // Get vector(s) orthogonal to orientation
-  GetBodyFrame();
-  // First handle the parallel component
-  double mag = gsl_ran_gaussian_ziggurat(rng_.r, diffusion_par_);
-  for (int i = 0; i < n_dim_; ++i) position_[i] += mag * orientation_[i];
-  // Then the perpendicular component(s)
   for (int j = 0; j < n_dim_ - 1; ++j) {
-    mag = gsl_ran_gaussian_ziggurat(rng_.r, diffusion_perp_);
-    for (int i = 0; i < n_dim_; ++i)
-      position_[i] += mag * body_frame_[n_dim_ * j + i];
+    motion.kick_rot[j][i_slot] =
+        gsl_ran_gaussian_ziggurat(rng_.r, diffusion_rot_);
   }
-  // Handle the random orientation update after updating orientation from
-  // interaction torques
 }
 
-/* The orientation update is also from Yu-Guo Tao,
-
-   u(t+dt) = u(t) + gamma_rot^-1 * T_s(t) x u(t) * dt + du(t)
-
-   where similar to above, du(t) is the reorientation due to
-   random forces, and is treated as random displacement vector(s)
-   orthogonal to u(t) with std dev sqrt(2*kT*dt/gamma_rot) */
-void Spherocylinder::AddRandomReorientation() {
-  // Now handle the random orientation update
-  for (int j = 0; j < n_dim_ - 1; ++j) {
-    double mag = gsl_ran_gaussian_ziggurat(rng_.r, diffusion_rot_);
-    for (int i = 0; i < n_dim_; ++i) {
-      orientation_[i] += mag * body_frame_[n_dim_ * j + i];
-    }
+/* Copy the result of the SoA motion kernel back from slot i_slot */
+void Spherocylinder::StoreMotion(BrownianMotion const &motion, int i_slot) {
+  for (int i = 0; i < n_dim_; ++i) {
+    position_[i] = motion.position[i][i_slot];
+    orientation_[i] = motion.orientation[i][i_slot];
+  }
+  for (int i = 0; i < space_->n_periodic; ++i) {
+    scaled_position_[i] = motion.scaled_position[i][i_slot];
   }
-  normalize_vector(orientation_, n_dim_);
+  UpdateKMC();
 }
 
 void Spherocylinder::ApplyForcesTorques() {}
@@ -135,6 +100,11 @@ void Spherocylinder::SetDiffusion() {
   diffusion_rot_ = sqrt(2 * delta / gamma_rot_);
 }
 
+void Spherocylinder::SetTimeStep(double delta) {
+  Object::SetTimeStep(delta);
+  SetDiffusion();
+}
+
 void Spherocylinder::GetBodyFrame() {
   if (n_dim_ == 2) {
     body_frame_[0] = orientation_[1];
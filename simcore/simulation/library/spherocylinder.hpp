@@ -1,6 +1,7 @@
 #ifndef _SIMCORE_SPHEROCYLINDER_H_
 #define _SIMCORE_SPHEROCYLINDER_H_
 
+#include "brownian_motion.hpp"
 #include "species.hpp"
 #ifdef ENABLE_OPENMP
 #include "omp.h"
@@ -15,19 +16,20 @@ class Spherocylinder : public Object {
   void InsertSpherocylinder();
   void SetDiffusion();
   void GetBodyFrame();
-  void AddRandomDisplacement();
-  void AddRandomReorientation();
-  void Integrate();
 
  public:
   Spherocylinder();
   void Init();
   void UpdatePosition();
+  void SetTimeStep(double delta);
+  void LoadMotion(BrownianMotion &motion, int i_slot);
+  void StoreMotion(BrownianMotion const &motion, int i_slot);
 };
 
 class SpherocylinderSpecies : public Species<Spherocylinder> {
  protected:
   bool midstep_;
+  BrownianMotion motion_;
   double **pos0_, **u0_, *msd_, *msd_err_, *vcf_, *vcf_err_;
   int time_, time_avg_interval_, n_samples_;
   std::fstream diff_file_;
@@ -44,11 +46,12 @@ class SpherocylinderSpecies : public Species<Spherocylinder> {
     Species::Init(params, space, seed);
     sparams_ = &(params_->spherocylinder);
     midstep_ = params_->spherocylinder.midstep;
+    motion_.Init(space);
   }
+  /* Rods are integrated together in the SoA kernel, see BrownianMotion */
   void UpdatePositions() {
-    for (auto it = members_.begin(); it != members_.end(); ++it) {
-      it->UpdatePosition();
-    }
+    motion_.UpdateMembers(members_.data(), members_.size(),
+                          &BrownianMotion::AdvanceRods);
   }
   virtual void InitAnalysis();
   virtual void RunAnalysis();
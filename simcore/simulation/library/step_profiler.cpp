@@ -0,0 +1,282 @@
+#include "step_profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+
+thread_local bool StepProfiler::enabled_ = false;
+thread_local int StepProfiler::n_profile_ = 0;
+thread_local int StepProfiler::n_steps_ = 0;
+thread_local int StepProfiler::n_interval_steps_ = 0;
+thread_local long StepProfiler::n_rebuilds_ = 0;
+thread_local long StepProfiler::n_pairs_ = 0;
+thread_local long StepProfiler::total_rebuilds_ = 0;
+thread_local long StepProfiler::total_pairs_ = 0;
+thread_local std::vector<StepProfiler::Phase> StepProfiler::phases_;
+thread_local std::vector<int> StepProfiler::order_;
+thread_local std::ofstream StepProfiler::timing_file_;
+thread_local std::chrono::steady_clock::time_point StepProfiler::step_start_;
+thread_local PerfCounters StepProfiler::counters_;
+thread_local std::vector<std::vector<double>> StepProfiler::start_counts_;
+thread_local size_t StepProfiler::n_running_ = 0;
+thread_local std::vector<double> StepProfiler::counts_;
+
+/* Start profiling if n_profile > 0, writing reports to <run_name>.timing,
+   and count hardware events if perf_counters is set and the kernel allows
+   it. The fixed phases are always registered, so timers can be created
+   whether or not profiling is enabled. */
+void StepProfiler::Init(std::string run_name, int n_profile,
+                        bool perf_counters) {
+  Finalize();
+  n_profile_ = n_profile;
+  n_steps_ = n_interval_steps_ = 0;
+  n_rebuilds_ = n_pairs_ = total_rebuilds_ = total_pairs_ = 0;
+  counts_.clear();
+  start_counts_.clear();
+  if (n_profile_ > 0) {
+    std::string file_name = run_name + ".timing";
+    timing_file_.open(file_name, std::ios::out);
+    if (timing_file_.is_open()) {
+      enabled_ = true;
+      Logger::Info("Writing step timings to %s every %d steps",
+                   file_name.c_str(), n_profile_);
+    } else {
+      Logger::Warning("Unable to open %s, step profiling disabled",
+                      file_name.c_str());
+    }
+  }
+  if (enabled_ && perf_counters && counters_.Open()) {
+    Logger::Info("Counting hardware events on %d threads",
+                 counters_.GetNThreads());
+    counts_.resize(PerfCounters::n_events_ * counters_.GetNThreads());
+  }
+  phases_.clear();
+  order_.clear();
+  for (size_t i = 0; i < profile_phase::_size(); ++i) {
+    profile_phase phase = profile_phase::_values()[i];
+    bool sub_phase = (phase > +profile_phase::interact &&
+                      phase < +profile_phase::integrate);
+    AddPhase(phase._to_string(), sub_phase ? +profile_phase::interact : -1);
+  }
+}
+
+/* Register a phase and return its index for ProfileTimer. Sub-phases are
+   reported after the other sub-phases of their parent. */
+int StepProfiler::AddPhase(std::string name, int parent) {
+  Phase phase;
+  phase.name = name;
+  phase.parent = parent;
+  phase.interval = phase.total = 0;
+  phase.interval_counts.assign(counts_.size(), 0);
+  phase.total_counts.assign(counts_.size(), 0);
+  phases_.push_back(phase);
+  int index = phases_.size() - 1;
+  auto pos = order_.end();
+  if (parent >= 0) {
+    pos = std::find(order_.begin(), order_.end(), parent) + 1;
+    while (pos != order_.end() && phases_[*pos].parent == parent) {
+      ++pos;
+    }
+  }
+  order_.insert(pos, index);
+  return index;
+}
+
+void StepProfiler::BeginCounters() {
+  if (n_running_ == start_counts_.size()) {
+    start_counts_.push_back(counts_);
+  }
+  counters_.Read(start_counts_[n_running_++].data());
+}
+
+void StepProfiler::EndCounters(int phase) {
+  if (n_running_ == 0) {
+    return;
+  }
+  std::vector<double> &start = start_counts_[--n_running_];
+  std::vector<double> &counts = phases_[phase].interval_counts;
+  counters_.Read(counts_.data());
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    counts[i] += counts_[i] - start[i];
+  }
+}
+
+void StepProfiler::WriteHeader() {
+  timing_file_ << "# Mean wall time per step in ms over the last " << n_profile_
+               << " steps, neighbor list rebuilds and pair interactions\n";
+  timing_file_ << "i_step";
+  for (auto it = order_.begin(); it != order_.end(); ++it) {
+    timing_file_ << " " << phases_[*it].name;
+  }
+  timing_file_ << " rebuilds pairs";
+  for (auto it = order_.begin(); it != order_.end(); ++it) {
+    for (int i = 0; i < PerfCounters::n_events_; ++i) {
+      if (counters_.IsAvailable(i)) {
+        timing_file_ << " " << phases_[*it].name << "."
+                     << PerfCounters::GetEventName(i);
+      }
+    }
+  }
+  timing_file_ << "\n";
+}
+
+/* Add the times and counts since the last report to the totals */
+void StepProfiler::AddTotals() {
+  for (auto it = phases_.begin(); it != phases_.end(); ++it) {
+    it->total += it->interval;
+    it->interval = 0;
+    for (size_t i = 0; i < it->interval_counts.size(); ++i) {
+      it->total_counts[i] += it->interval_counts[i];
+      it->interval_counts[i] = 0;
+    }
+  }
+  total_rebuilds_ += n_rebuilds_;
+  total_pairs_ += n_pairs_;
+  n_rebuilds_ = n_pairs_ = 0;
+}
+
+/* Record the step time and write a report every n_profile steps */
+void StepProfiler::EndStep(int i_step) {
+  if (!enabled_) {
+    return;
+  }
+  std::chrono::duration<double> dt = Now() - step_start_;
+  EndPhase(profile_phase::step, dt.count());
+  n_steps_++;
+  if (++n_interval_steps_ < n_profile_) {
+    return;
+  }
+  if (n_steps_ == n_interval_steps_) {
+    WriteHeader();
+  }
+  timing_file_ << i_step;
+  for (auto it = order_.begin(); it != order_.end(); ++it) {
+    timing_file_ << " " << 1000 * phases_[*it].interval / n_interval_steps_;
+  }
+  timing_file_ << " " << n_rebuilds_ << " " << n_pairs_;
+  for (auto it = order_.begin(); it != order_.end(); ++it) {
+    std::vector<double> &counts = phases_[*it].interval_counts;
+    for (int i = 0; i < PerfCounters::n_events_; ++i) {
+      if (!counters_.IsAvailable(i)) {
+        continue;
+      }
+      double count = 0;
+      for (size_t j = i; j < counts.size(); j += PerfCounters::n_events_) {
+        count += counts[j];
+      }
+      timing_file_ << " " << count / n_interval_steps_;
+    }
+  }
+  timing_file_ << "\n";
+  timing_file_.flush();
+  AddTotals();
+  n_interval_steps_ = 0;
+}
+
+/* Write the summary of the whole run, including any steps since the last
+   report, and stop profiling */
+void StepProfiler::Finalize() {
+  if (!enabled_) {
+    return;
+  }
+  enabled_ = false;
+  if (n_steps_ == 0) {
+    timing_file_.close();
+    counters_.Close();
+    return;
+  }
+  AddTotals();
+  double step_time = phases_[profile_phase::step].total;
+  char line[256];
+  std::string summary = "Step profile over " + std::to_string(n_steps_) +
+                        " steps:\n";
+  snprintf(line, sizeof(line), "  %-28s %12s %12s %8s\n", "phase", "total (s)",
+           "ms/step", "%");
+  summary += line;
+  for (auto it = order_.begin(); it != order_.end(); ++it) {
+    Phase &phase = phases_[*it];
+    std::string name = (phase.parent >= 0 ? "  " : "") + phase.name;
+    snprintf(line, sizeof(line), "  %-28s %12.4f %12.6f %8.2f\n", name.c_str(),
+             phase.total, 1000 * phase.total / n_steps_,
+             step_time > 0 ? 100 * phase.total / step_time : 0);
+    summary += line;
+  }
+  snprintf(line, sizeof(line),
+           "  neighbor list rebuilds: %ld (every %.1f steps)\n"
+           "  pair interactions: %ld (%.1f per step)",
+           total_rebuilds_,
+           total_rebuilds_ > 0 ? (double)n_steps_ / total_rebuilds_ : 0.0,
+           total_pairs_, (double)total_pairs_ / n_steps_);
+  summary += line;
+  if (counters_.IsOpen()) {
+    summary += GetCounterSummary();
+    counters_.Close();
+  }
+  timing_file_ << "#\n";
+  size_t begin = 0;
+  while (begin < summary.size()) {
+    size_t end = summary.find('\n', begin);
+    if (end == std::string::npos) {
+      end = summary.size();
+    }
+    timing_file_ << "# " << summary.substr(begin, end - begin) << "\n";
+    begin = end + 1;
+  }
+  timing_file_.close();
+  Logger::Info("%s", summary.c_str());
+}
+
+/* Mean hardware event counts per step of each phase, summed over threads,
+   and the cycles and instructions per cycle of each thread if there are
+   several */
+std::string StepProfiler::GetCounterSummary() {
+  const int n_events = PerfCounters::n_events_;
+  int n_threads = counters_.GetNThreads();
+  char line[256];
+  std::string summary = "\n  Hardware events per step:\n";
+  snprintf(line, sizeof(line), "  %-28s", "phase");
+  summary += line;
+  for (int i = 0; i < n_events; ++i) {
+    snprintf(line, sizeof(line), " %14s", PerfCounters::GetEventName(i));
+    summary += line;
+  }
+  summary += "      ipc\n";
+  for (auto it = order_.begin(); it != order_.end(); ++it) {
+    Phase &phase = phases_[*it];
+    std::string name = (phase.parent >= 0 ? "  " : "") + phase.name;
+    snprintf(line, sizeof(line), "  %-28s", name.c_str());
+    summary += line;
+    double counts[n_events] = {0};
+    for (int i = 0; i < n_events * n_threads; ++i) {
+      counts[i % n_events] += phase.total_counts[i];
+    }
+    for (int i = 0; i < n_events; ++i) {
+      if (counters_.IsAvailable(i)) {
+        snprintf(line, sizeof(line), " %14.0f", counts[i] / n_steps_);
+      } else {
+        snprintf(line, sizeof(line), " %14s", "n/a");
+      }
+      summary += line;
+    }
+    snprintf(line, sizeof(line), " %8.2f\n",
+             counts[0] > 0 ? counts[1] / counts[0] : 0);
+    summary += line;
+  }
+  if (n_threads > 1) {
+    summary += "  Cycles per step (instructions per cycle) by thread:\n";
+    for (auto it = order_.begin(); it != order_.end(); ++it) {
+      Phase &phase = phases_[*it];
+      std::string name = (phase.parent >= 0 ? "  " : "") + phase.name;
+      snprintf(line, sizeof(line), "  %-28s", name.c_str());
+      summary += line;
+      for (int i = 0; i < n_threads; ++i) {
+        double cycles = phase.total_counts[n_events * i];
+        double instructions = phase.total_counts[n_events * i + 1];
+        snprintf(line, sizeof(line), " %12.0f (%4.2f)", cycles / n_steps_,
+                 cycles > 0 ? instructions / cycles : 0);
+        summary += line;
+      }
+      summary += "\n";
+    }
+  }
+  summary.pop_back();
+  return summary;
+}
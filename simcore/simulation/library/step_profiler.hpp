@@ -0,0 +1,129 @@
+#ifndef _SIMCORE_STEP_PROFILER_H_
+#define _SIMCORE_STEP_PROFILER_H_
+
+#include "definitions.hpp"
+#include "logger.hpp"
+#include "perf_counters.hpp"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Phases of a simulation step. The step phase is the whole step, phases
+   between interact and integrate are sub-phases of interact, and each species
+   adds a sub-phase of integrate for its UpdatePositions call. */
+BETTER_ENUM(profile_phase, unsigned char, step, zero_forces, interact,
+            update_objects, halo_exchange, update_xlinks, update_neighbors,
+            pair_interactions, boundary_interactions, apply_interactions,
+            integrate, statistics, draw, outputs);
+
+/* Records the wall time spent in each phase of the simulation step, along
+   with the number of neighbor list rebuilds and pair interactions processed.
+   Every n_profile steps the mean time per step of each phase over the last
+   n_profile steps is appended to <run_name>.timing, and a summary of the whole
+   run is written there and to the log when the simulation ends.
+
+   With hardware counters, each phase also counts the hardware events of
+   PerfCounters on every OpenMP thread, which are reported after the times as
+   the mean count per step summed over threads, and broken down by thread in
+   the summary.
+
+   When profiling is disabled, timers and counters only test a flag. The
+   profiler state is per thread, so simulations running on separate threads
+   of one process profile themselves independently. */
+class StepProfiler {
+private:
+  typedef std::chrono::steady_clock clock;
+  struct Phase {
+    std::string name;
+    int parent;
+    double interval; // Seconds spent since the last report
+    double total;    // Seconds spent since Init
+    /* Hardware event counts of each thread, indexed as in PerfCounters */
+    std::vector<double> interval_counts;
+    std::vector<double> total_counts;
+  };
+  static thread_local bool enabled_;
+  static thread_local int n_profile_;
+  static thread_local int n_steps_;
+  static thread_local int n_interval_steps_;
+  /* Counts since the last report, and since Init */
+  static thread_local long n_rebuilds_;
+  static thread_local long n_pairs_;
+  static thread_local long total_rebuilds_;
+  static thread_local long total_pairs_;
+  static thread_local std::vector<Phase> phases_;
+  static thread_local std::vector<int> order_; // Phases in report order
+  static thread_local std::ofstream timing_file_;
+  static thread_local clock::time_point step_start_;
+  static thread_local PerfCounters counters_;
+  /* Counts when each of the currently running timers started */
+  static thread_local std::vector<std::vector<double>> start_counts_;
+  static thread_local size_t n_running_;
+  static thread_local std::vector<double> counts_;
+  static void WriteHeader();
+  static void AddTotals();
+  static std::string GetCounterSummary();
+
+public:
+  static void Init(std::string run_name, int n_profile, bool perf_counters);
+  static bool IsEnabled() { return enabled_; }
+  static int AddPhase(std::string name, int parent = -1);
+  static void BeginPhase() {
+    if (counters_.IsOpen()) {
+      BeginCounters();
+    }
+  }
+  static void EndPhase(int phase, double seconds) {
+    phases_[phase].interval += seconds;
+    if (counters_.IsOpen()) {
+      EndCounters(phase);
+    }
+  }
+  static void BeginCounters();
+  static void EndCounters(int phase);
+  static void CountRebuild() {
+    if (enabled_) {
+      n_rebuilds_++;
+    }
+  }
+  static void CountPairs(size_t n_pairs) {
+    if (enabled_) {
+      n_pairs_ += n_pairs;
+    }
+  }
+  static void StartStep() {
+    if (enabled_) {
+      n_running_ = 0;
+      BeginPhase();
+      step_start_ = Now();
+    }
+  }
+  static void EndStep(int i_step);
+  static void Finalize();
+  static clock::time_point Now() { return clock::now(); }
+};
+
+/* Adds the wall time and hardware events between construction and
+   destruction to a phase */
+class ProfileTimer {
+private:
+  int phase_;
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  ProfileTimer(int phase) : phase_(phase) {
+    if (StepProfiler::IsEnabled()) {
+      StepProfiler::BeginPhase();
+      start_ = StepProfiler::Now();
+    }
+  }
+  ~ProfileTimer() {
+    if (StepProfiler::IsEnabled()) {
+      std::chrono::duration<double> dt = StepProfiler::Now() - start_;
+      StepProfiler::EndPhase(phase_, dt.count());
+    }
+  }
+};
+
+#endif // _SIMCORE_STEP_PROFILER_H_
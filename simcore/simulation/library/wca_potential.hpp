@@ -12,6 +12,13 @@ class WCAPotential : public PotentialBase {
  public:
   WCAPotential() {}
   void CalcPotential(Interaction &ix) {
+    if (n_dim_ == 2) {
+      CalcPotential<2>(ix);
+    } else {
+      CalcPotential<3>(ix);
+    }
+  }
+  template <int N_DIM> void CalcPotential(Interaction &ix) {
     double rmag = sqrt(ix.dr_mag2);
     double *dr = ix.dr;
     double rinv = 1.0 / (rmag);
@@ -22,12 +29,7 @@ class WCAPotential : public PotentialBase {
     if (ABS(ffac) > fcut_) {
       ffac = SIGNOF(ffac) * fcut_;
     }
-    for (int i = 0; i < n_dim_; ++i) {
-      ix.force[i] = ffac * dr[i] * rinv;
-    }
-    for (int i = 0; i < n_dim_; ++i)
-      for (int j = 0; j < n_dim_; ++j)
-        ix.stress[n_dim_ * i + j] = -dr[i] * ix.force[j];
+    SetCentralForce<N_DIM>(ix, dr, ffac, rinv);
     ix.pote = r6 * (c12_ * r6 - c6_) + eps_;
   }
 
@@ -1,6 +1,9 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
 #include <simcore.hpp>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 class Tester {
   public:
@@ -33,6 +36,507 @@ class Tester {
       }
       return true;
     }
+    /* Set up a simulation with params as a run of simcore does */
+    static void InitSim(Simulation &sim, system_parameters const &params) {
+      sim.params_ = params;
+      sim.run_name_ = params.run_name;
+      sim.InitSimulation();
+    }
+    /* Positions of the interactors of the first species, e.g. the bonds of
+       filaments */
+    static std::vector<double> GetPositions(Simulation &sim) {
+      std::vector<Object *> ixors;
+      sim.species_[0]->GetInteractors(&ixors);
+      std::vector<double> positions;
+      for (auto it = ixors.begin(); it != ixors.end(); ++it) {
+        double const *const r = (*it)->GetPosition();
+        positions.insert(positions.end(), r, r + sim.params_.n_dim);
+      }
+      return positions;
+    }
+    /* Run a small filament simulation and return the final bond positions */
+    static std::vector<double> RunReplica(system_parameters params) {
+      Simulation sim;
+      InitSim(sim, params);
+      sim.RunSimulation();
+      std::vector<double> positions = GetPositions(sim);
+      sim.ClearSimulation();
+      return positions;
+    }
+    /* Analyze the spec files of a run as simcore -a does and return the
+       contents of its filament mse2e and theta analysis files */
+    static std::string RunSpecAnalysis(system_parameters params) {
+      run_options run_opts;
+      run_opts.analysis_flag = 1;
+      Simulation sim;
+      sim.ProcessOutputs(params, run_opts);
+      std::string contents;
+      for (std::string ext : {".mse2e", ".theta"}) {
+        std::ifstream file(params.run_name + "_filament" + ext);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        contents += buffer.str();
+      }
+      return contents;
+    }
+    /* Run a small filament simulation and return the final bond ids and
+       positions, followed by the object and mesh id counters */
+    static std::vector<double> RunObjectIds(system_parameters params) {
+      Simulation sim;
+      InitSim(sim, params);
+      sim.RunSimulation();
+      std::vector<Object *> bonds;
+      sim.species_[0]->GetInteractors(&bonds);
+      std::vector<double> state;
+      for (auto it = bonds.begin(); it != bonds.end(); ++it) {
+        double const *const r = (*it)->GetPosition();
+        state.push_back((*it)->GetOID());
+        state.insert(state.end(), r, r + params.n_dim);
+      }
+      state.push_back(sim.context_.next_oid);
+      state.push_back(sim.context_.next_mesh_id);
+      sim.ClearSimulation();
+      return state;
+    }
+    /* Run a small filament simulation that writes checkpoints and return the
+       contents of its last filament checkpoint */
+    static std::vector<char> RunCheckpointReplica(system_parameters params) {
+      params.filament.checkpoint_flag = 1;
+      params.filament.n_checkpoint = 10;
+      Simulation sim;
+      InitSim(sim, params);
+      sim.RunSimulation();
+      sim.ClearSimulation();
+      std::vector<char> data;
+      CheckpointWriter::Load(params.run_name + "_filament.checkpoint", data);
+      return data;
+    }
+    /* Run a crosslinked filament simulation, make checkpoints from its spec
+       files as simcore -a does with checkpoint_from_spec, then reload them as
+       simcore -l does, and count the crosslinks at the end of the run and
+       after reloading */
+    static void RunCheckpointFromSpec(system_parameters params, int &n_run,
+                                      int &n_reload) {
+      Simulation sim;
+      InitSim(sim, params);
+      sim.RunSimulation();
+      n_run = sim.iengine_.xlink_.xlinks_.size();
+      sim.ClearSimulation();
+      params.checkpoint_from_spec = 1;
+      params.filament.checkpoint_flag = 1;
+      params.crosslink.checkpoint_flag = 1;
+      run_options run_opts;
+      run_opts.analysis_flag = 1;
+      Simulation processing;
+      processing.ProcessOutputs(params, run_opts);
+      params.checkpoint_from_spec = 0;
+      params.load_checkpoint = 1;
+      params.checkpoint_run_name = params.run_name;
+      params.run_name += "_reload";
+      Simulation reload;
+      InitSim(reload, params);
+      n_reload = reload.iengine_.xlink_.xlinks_.size();
+      reload.RunSimulation();
+      reload.ClearSimulation();
+    }
+    /* Drive a crosslink manager on the bonds of a few filaments and count the
+       binding and unbinding events of singly-bound crosslinks, along with the
+       numbers expected from the per-update rates */
+    static void RunCrosslinkKinetics(system_parameters params, int n_updates,
+                                     int &n_bind, double &bind_mean,
+                                     int &n_unbind, double &unbind_mean) {
+      Simulation sim;
+      InitSim(sim, params);
+      std::vector<Object *> bonds;
+      sim.species_[0]->GetInteractors(&bonds);
+      space_struct *space = sim.space_.GetStruct();
+      MinimumDistance mindist;
+      mindist.Init(space, 0);
+      CrosslinkManager xlink_mgr;
+      sim.params_.i_step = 0;
+      xlink_mgr.Init(&sim.params_, space, &mindist, &bonds);
+      double k_on_tau = params.crosslink.k_on * params.delta;
+      double k_off_tau = params.crosslink.k_off * params.delta;
+      double unbind_prob =
+          (params.crosslink.event_kinetics ? 1 - exp(-k_off_tau) : k_off_tau);
+      n_bind = n_unbind = 0;
+      bind_mean = unbind_mean = 0;
+      for (int i = 0; i < n_updates; ++i) {
+        int n_bound = xlink_mgr.xlinks_.size();
+        xlink_mgr.UpdateBoundCrosslinks();
+        int n_left = xlink_mgr.xlinks_.size();
+        n_unbind += n_bound - n_left;
+        unbind_mean += n_bound * unbind_prob;
+        xlink_mgr.CalculateBindingFree();
+        n_bind += xlink_mgr.xlinks_.size() - n_left;
+        bind_mean += (params.crosslink.concentration - n_left / space->volume) *
+                     xlink_mgr.obj_volume_ * k_on_tau;
+      }
+      xlink_mgr.Clear();
+      sim.ClearSimulation();
+    }
+    /* Split a small filament system between two processes, as seen from
+       the first, and check which process owns each filament, including
+       filaments moved across the periodic boundary of the slab axis, and
+       which of their pairs are shared with the owner of a ghost */
+    static void TestDomainOwnership(system_parameters params) {
+      Simulation sim;
+      InitSim(sim, params);
+      DomainDecomposition domains;
+      domains.space_ = sim.space_.GetStruct();
+      domains.n_dim_ = params.n_dim;
+      domains.n_periodic_ = params.n_periodic;
+      domains.n_procs_ = 2;
+      domains.rank_ = 0;
+      domains.filaments_ = static_cast<FilamentSpecies *>(sim.species_[0]);
+      std::vector<Filament> &members = *domains.filaments_->GetMembers();
+      REQUIRE(members.size() == 4);
+      double lo, hi, center;
+      for (auto it = members.begin(); it != members.end(); ++it) {
+        domains.GetExtent(*it, &lo, &hi, &center);
+        REQUIRE(lo <= center);
+        REQUIRE(center <= hi);
+        REQUIRE(center >= -0.5);
+        REQUIRE(center < 0.5);
+        REQUIRE(domains.GetOwner(center) == (center < 0 ? 0 : 1));
+      }
+      /* Lay filaments along the slab axis across the periodic boundary, with
+         their sites wrapped into the box, and their centers a distance
+         offset past the boundary */
+      double box = 1.0 / domains.space_->unit_cell_inv[0];
+      double offset[2] = {2, -2};
+      for (int i = 0; i < 2; ++i) {
+        Filament &filament = members[i];
+        int n_sites = filament.GetNBonds() + 1;
+        double bond_length = params.filament.length / filament.GetNBonds();
+        for (int j = 0; j < n_sites; ++j) {
+          double pos[3] = {0, 0, 0};
+          pos[0] = 0.5 * box + offset[i] + (j - 0.5 * (n_sites - 1)) *
+                                               bond_length;
+          pos[0] -= box * NINT(pos[0] / box);
+          filament.GetSite(j)->SetPosition(pos);
+        }
+        domains.GetExtent(filament, &lo, &hi, &center);
+        REQUIRE(hi - lo == Approx(params.filament.length / box));
+        REQUIRE(center == Approx(offset[i] / box + (offset[i] > 0 ? -0.5 : 0.5)));
+        REQUIRE(domains.GetOwner(center) == (offset[i] > 0 ? 0 : 1));
+      }
+      /* Pairs of two ghosts are dropped and pairs with one are shared */
+      domains.ghosts_[members[1].GetMeshID()];
+      std::vector<Interaction> pairs;
+      pairs.push_back(Interaction(members[0].GetBond(0), members[1].GetBond(0)));
+      pairs.push_back(Interaction(members[1].GetBond(0), members[1].GetBond(2)));
+      pairs.push_back(Interaction(members[0].GetBond(0), members[2].GetBond(0)));
+      pairs.push_back(Interaction(members[3].GetBond(0), members[1].GetBond(1)));
+      domains.FilterPairs(&pairs);
+      REQUIRE(pairs.size() == 3);
+      REQUIRE(pairs[0].ghost);
+      REQUIRE(pairs[0].obj2 == members[1].GetBond(0));
+      REQUIRE(!pairs[1].ghost);
+      REQUIRE(pairs[1].obj2 == members[2].GetBond(0));
+      REQUIRE(pairs[2].ghost);
+      REQUIRE(pairs[2].obj1 == members[3].GetBond(0));
+      domains.ghosts_.clear();
+      sim.ClearSimulation();
+    }
+    /* Evaluate the interactions of a small filament system over n_thermo
+       steps without moving it, and return the potential energy of its bonds
+       on every step, followed by the pressure tensor of those steps and the
+       forces on every bond summed over the steps */
+    static std::vector<double> RunPairEnergies(system_parameters params) {
+      Simulation sim;
+      InitSim(sim, params);
+      std::vector<Object *> bonds;
+      sim.species_[0]->GetInteractors(&bonds);
+      std::vector<double> energies;
+      std::vector<double> forces(bonds.size() * params.n_dim, 0);
+      for (sim.i_step_ = 1; sim.i_step_ <= params.n_thermo; ++sim.i_step_) {
+        sim.params_.i_step = sim.i_step_;
+        sim.ZeroForces();
+        sim.Interact();
+        double pote = 0;
+        for (size_t i = 0; i < bonds.size(); ++i) {
+          pote += bonds[i]->GetPotentialEnergy();
+          double const *const f = bonds[i]->GetForce();
+          for (int j = 0; j < params.n_dim; ++j) {
+            forces[i * params.n_dim + j] += f[j];
+          }
+        }
+        energies.push_back(pote);
+      }
+      sim.iengine_.CalculatePressure();
+      double const *const pressure = sim.space_.GetStruct()->pressure_tensor;
+      energies.insert(energies.end(), pressure,
+                      pressure + params.n_dim * params.n_dim);
+      energies.insert(energies.end(), forces.begin(), forces.end());
+      sim.ClearSimulation();
+      return energies;
+    }
+    /* Bending of 2D filaments, the sum of 1 - cos of the angles between
+       their neighboring bonds */
+    static double GetBending(std::vector<Filament> &members) {
+      double bending = 0;
+      for (auto it = members.begin(); it != members.end(); ++it) {
+        for (int i = 0; i < it->GetNBonds() - 1; ++i) {
+          double const *const u1 = it->GetBond(i)->GetOrientation();
+          double const *const u2 = it->GetBond(i + 1)->GetOrientation();
+          bending += 1 - dot_product<2>(u1, u2);
+        }
+      }
+      return bending;
+    }
+    /* Bend the 2D filaments of a small simulation into arcs turning by
+       angle from their first bond, step them without thermal noise, and
+       return the final bond positions followed by the bending of the
+       filaments before and after the steps */
+    static std::vector<double> RunBentFilaments(system_parameters params,
+                                                double angle) {
+      Simulation sim;
+      InitSim(sim, params);
+      std::vector<Filament> &members =
+          *static_cast<FilamentSpecies *>(sim.species_[0])->GetMembers();
+      for (auto it = members.begin(); it != members.end(); ++it) {
+        int n_bonds = it->GetNBonds();
+        double const *const u = it->GetBond(0)->GetOrientation();
+        double phi0 = atan2(u[1], u[0]);
+        double r[3] = {0, 0, 0};
+        std::copy(it->GetSite(0)->GetPosition(),
+                  it->GetSite(0)->GetPosition() + 2, r);
+        for (int i = 0; i < n_bonds; ++i) {
+          double phi = phi0 + angle * i / (n_bonds - 1);
+          r[0] += it->GetBondLength() * cos(phi);
+          r[1] += it->GetBondLength() * sin(phi);
+          it->GetSite(i + 1)->SetPosition(r);
+        }
+        it->UpdateBondPositions();
+        it->UpdatePrevPositions();
+      }
+      double bending = GetBending(members);
+      sim.RunSimulation();
+      std::vector<double> state = GetPositions(sim);
+      state.push_back(bending);
+      state.push_back(GetBending(members));
+      sim.ClearSimulation();
+      return state;
+    }
+    /* Run a small filament simulation whose time step is handed over after
+       initialization, and return the final bond positions */
+    static std::vector<double> RunSetTimeStep(system_parameters params,
+                                              double delta) {
+      Simulation sim;
+      InitSim(sim, params);
+      sim.SetTimeStep(delta);
+      sim.RunSimulation();
+      std::vector<double> positions = GetPositions(sim);
+      sim.ClearSimulation();
+      return positions;
+    }
+    /* Step the clock of an adaptive simulation through a changing time step,
+       and check that every fitted step ends a whole number of full steps
+       before the next output, and that outputs are due exactly once at each
+       multiple of the output cadence, at the time of a fixed time step */
+    static void TestOutputCadence(system_parameters params) {
+      Simulation sim;
+      InitSim(sim, params);
+      REQUIRE(sim.n_out_steps_ == params.filament.n_spec);
+      double deltas[3] = {0.3 * params.delta, 2.7 * params.delta,
+                          0.71 * params.delta};
+      std::vector<int> out_steps;
+      for (sim.i_step_ = 1; sim.out_step_ < params.n_steps; ++sim.i_step_) {
+        sim.AdvanceTime();
+        if (sim.output_step_) {
+          REQUIRE(sim.i_step_ % 2 == 0);
+          REQUIRE(sim.time_ == Approx(sim.out_step_ * params.delta));
+          out_steps.push_back(sim.out_step_);
+        }
+        if (sim.i_step_ % 2 == 0 && sim.out_step_ < params.n_steps) {
+          double delta = deltas[(sim.i_step_ / 2) % 3];
+          double fit = sim.FitTimeStep(delta);
+          int next_out = sim.out_step_ + sim.n_out_steps_;
+          double n_full = (next_out * params.delta - sim.time_) / (2 * fit);
+          REQUIRE(fit <= delta * (1 + 1e-12));
+          REQUIRE(n_full == Approx(round(n_full)));
+          sim.SetTimeStep(fit);
+          REQUIRE(sim.delta_ == fit);
+          REQUIRE(sim.context_.delta == fit);
+        }
+      }
+      std::vector<int> expected;
+      for (int i = 1; i * sim.n_out_steps_ <= params.n_steps; ++i) {
+        expected.push_back(i * sim.n_out_steps_);
+      }
+      REQUIRE(out_steps == expected);
+      sim.ClearSimulation();
+    }
+    /* Advance a small system of beads and rods for n_steps, either in blocks
+       by their species or one at a time through the UpdatePosition of each
+       member, and return their final positions and orientations */
+    static std::vector<double> RunFreeMotion(system_parameters params,
+                                             bool kernel) {
+      Simulation sim;
+      InitSim(sim, params);
+      for (sim.i_step_ = 1; sim.i_step_ <= params.n_steps; ++sim.i_step_) {
+        sim.params_.i_step = sim.i_step_;
+        sim.ZeroForces();
+        sim.Interact();
+        for (auto spec = sim.species_.begin(); spec != sim.species_.end();
+             ++spec) {
+          if (kernel) {
+            (*spec)->UpdatePositions();
+          } else if ((*spec)->GetSID() == +species_id::br_bead) {
+            std::vector<BrBead> &beads =
+                *static_cast<BrBeadSpecies *>(*spec)->GetMembers();
+            for (auto it = beads.begin(); it != beads.end(); ++it) {
+              it->UpdatePosition();
+            }
+          } else {
+            std::vector<Spherocylinder> &rods =
+                *static_cast<SpherocylinderSpecies *>(*spec)->GetMembers();
+            for (auto it = rods.begin(); it != rods.end(); ++it) {
+              it->UpdatePosition();
+            }
+          }
+        }
+      }
+      std::vector<Object *> objs;
+      for (auto spec = sim.species_.begin(); spec != sim.species_.end();
+           ++spec) {
+        if ((*spec)->GetSID() == +species_id::br_bead) {
+          std::vector<BrBead> &beads =
+              *static_cast<BrBeadSpecies *>(*spec)->GetMembers();
+          for (auto it = beads.begin(); it != beads.end(); ++it) {
+            objs.push_back(&(*it));
+          }
+        } else {
+          std::vector<Spherocylinder> &rods =
+              *static_cast<SpherocylinderSpecies *>(*spec)->GetMembers();
+          for (auto it = rods.begin(); it != rods.end(); ++it) {
+            objs.push_back(&(*it));
+          }
+        }
+      }
+      std::vector<double> state;
+      for (auto it = objs.begin(); it != objs.end(); ++it) {
+        double const *const r = (*it)->GetPosition();
+        double const *const s = (*it)->GetScaledPosition();
+        double const *const u = (*it)->GetOrientation();
+        state.insert(state.end(), r, r + params.n_dim);
+        state.insert(state.end(), s, s + params.n_dim);
+        state.insert(state.end(), u, u + params.n_dim);
+      }
+      sim.ClearSimulation();
+      return state;
+    }
+    /* Run a small filament simulation that writes an indexed spec file, then
+       read the spec file with the index removed, as a run from before spec
+       indices would be read, and then by seeking to every frame through the
+       index rebuilt while reading. Returns the written and the rebuilt index,
+       and the bond positions of every frame read sequentially and by
+       seeking. */
+    static void RunSpecIndex(system_parameters params,
+                             std::vector<char> &written,
+                             std::vector<char> &rebuilt,
+                             std::vector<std::vector<double>> &sequential,
+                             std::vector<std::vector<double>> &seeked) {
+      Simulation sim;
+      InitSim(sim, params);
+      sim.RunSimulation();
+      sim.ClearSimulation();
+      std::string index_file =
+          SpecIndex::GetIndexFileName(params.run_name + "_filament.spec");
+      auto read_file = [](std::string file_name) {
+        std::ifstream file(file_name, std::ios::in | std::ios::binary);
+        return std::vector<char>((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+      };
+      written = read_file(index_file);
+      std::remove(index_file.c_str());
+      run_options run_opts;
+      Simulation reader;
+      reader.params_ = params;
+      reader.run_name_ = params.run_name;
+      reader.InitProcessing(run_opts);
+      /* The first frame is read when the spec file is opened */
+      while (!reader.context_.early_exit) {
+        sequential.push_back(GetPositions(reader));
+        reader.species_[0]->ReadSpecs();
+      }
+      reader.ClearSimulation();
+      rebuilt = read_file(index_file);
+      Simulation seeker;
+      seeker.params_ = params;
+      seeker.run_name_ = params.run_name;
+      seeker.InitProcessing(run_opts);
+      int n_frames = seeker.species_[0]->GetNSpecFrames();
+      seeked.resize(n_frames);
+      /* Seek backwards, so no frame is reached by reading on */
+      for (int i_frame = n_frames - 1; i_frame >= 0; --i_frame) {
+        if (seeker.species_[0]->SeekSpecFrame(i_frame)) {
+          seeked[i_frame] = GetPositions(seeker);
+        }
+      }
+      seeker.ClearSimulation();
+    }
+    /* Write frames of doubles after a spec header as a compressed spec file,
+       rounding them to the tolerance of the stream as objects do */
+    static void WriteCompressedSpecs(std::string file_name,
+                                     std::vector<std::vector<double>> &frames,
+                                     double tolerance) {
+      std::fstream ospec(file_name, std::ios::out | std::ios::binary);
+      int n_steps = 100, n_spec = 10;
+      double delta = 0.001;
+      ospec.write(reinterpret_cast<char *>(&n_steps), sizeof(int));
+      ospec.write(reinterpret_cast<char *>(&n_spec), sizeof(int));
+      ospec.write(reinterpret_cast<char *>(&delta), sizeof(double));
+      SpecCompression::AttachOutput(ospec, tolerance);
+      for (auto frame = frames.begin(); frame != frames.end(); ++frame) {
+        for (auto it = frame->begin(); it != frame->end(); ++it) {
+          double x = SpecCompression::Quantize(ospec, *it);
+          ospec.write(reinterpret_cast<char *>(&x), sizeof(double));
+        }
+        ospec.flush();
+      }
+      SpecCompression::Detach(ospec);
+      ospec.close();
+    }
+    /* Read back all doubles written by WriteCompressedSpecs */
+    static std::vector<double> ReadCompressedSpecs(std::string file_name) {
+      std::fstream ispec(file_name, std::ios::in | std::ios::binary);
+      int n_steps, n_spec;
+      double delta;
+      ispec.read(reinterpret_cast<char *>(&n_steps), sizeof(int));
+      ispec.read(reinterpret_cast<char *>(&n_spec), sizeof(int));
+      ispec.read(reinterpret_cast<char *>(&delta), sizeof(double));
+      std::vector<double> values;
+      if (!SpecCompression::AttachInput(ispec)) {
+        return values;
+      }
+      double x;
+      while (ispec.read(reinterpret_cast<char *>(&x), sizeof(double))) {
+        values.push_back(x);
+      }
+      SpecCompression::Detach(ispec);
+      ispec.close();
+      return values;
+    }
+    /* Return the codec and delta flag of each block of a file written by
+       WriteCompressedSpecs, and whether its payload was stored as is */
+    static void GetCompressedBlocks(std::string file_name,
+                                    std::vector<int> &codecs,
+                                    std::vector<int> &deltas,
+                                    std::vector<bool> &stored) {
+      std::ifstream ispec(file_name, std::ios::in | std::ios::binary);
+      ispec.seekg(2 * sizeof(int) + sizeof(double) + sizeof(uint32_t));
+      uint32_t raw_size, stored_size;
+      while (ispec.read(reinterpret_cast<char *>(&raw_size),
+                        sizeof(uint32_t))) {
+        ispec.read(reinterpret_cast<char *>(&stored_size), sizeof(uint32_t));
+        codecs.push_back(ispec.get());
+        deltas.push_back(ispec.get());
+        stored.push_back(stored_size == raw_size);
+        ispec.seekg(stored_size, std::ios::cur);
+      }
+    }
 };
 
 TEST_CASE("Simulation manager") {
@@ -56,3 +560,503 @@ TEST_CASE("Simulation") {
   }
 }
 
+TEST_CASE("Simulation replicas") {
+  system_parameters params;
+  params.run_name = "test_replica";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 20;
+  params.n_steps = 100;
+  params.thermo_flag = 0;
+  params.filament.num = 4;
+  params.filament.length = 10;
+  params.seed = 1;
+  std::vector<double> serial = Tester::RunReplica(params);
+  SECTION("Replicas on separate threads are independent") {
+    std::vector<double> replica1, replica2;
+    system_parameters params2 = params;
+    params2.run_name = "test_replica2";
+    params2.seed = 2;
+    std::thread thread1([&] { replica1 = Tester::RunReplica(params); });
+    std::thread thread2([&] { replica2 = Tester::RunReplica(params2); });
+    thread1.join();
+    thread2.join();
+    REQUIRE(serial.size() > 0);
+    REQUIRE(replica1 == serial);
+    REQUIRE(replica2 != serial);
+  }
+  SECTION("Replicas on separate threads write their own checkpoints") {
+    params.run_name = "test_checkpoint";
+    params.async_checkpoints = 1;
+    params.checkpoint_delta = 3;
+    std::vector<char> serial_checkpoint = Tester::RunCheckpointReplica(params);
+    std::vector<char> checkpoint1, checkpoint2;
+    system_parameters params1 = params;
+    params1.run_name = "test_checkpoint1";
+    system_parameters params2 = params;
+    params2.run_name = "test_checkpoint2";
+    params2.seed = 2;
+    params2.async_checkpoints = 0;
+    params2.checkpoint_delta = 0;
+    std::thread thread1(
+        [&] { checkpoint1 = Tester::RunCheckpointReplica(params1); });
+    std::thread thread2(
+        [&] { checkpoint2 = Tester::RunCheckpointReplica(params2); });
+    thread1.join();
+    thread2.join();
+    REQUIRE(serial_checkpoint.size() > 0);
+    REQUIRE(checkpoint1 == serial_checkpoint);
+    REQUIRE(checkpoint2.size() == serial_checkpoint.size());
+    REQUIRE(checkpoint2 != serial_checkpoint);
+  }
+}
+
+TEST_CASE("Checkpoint deltas") {
+  std::string file_name = "test_checkpoint_delta.checkpoint";
+  std::string delta_name = CheckpointWriter::GetDeltaFileName(file_name);
+  std::remove(file_name.c_str());
+  std::remove(delta_name.c_str());
+  /* Successive checkpoints that differ in a few blocks, as those of a
+     simulation do between checkpoint steps */
+  std::vector<std::vector<char>> checkpoints(4, std::vector<char>(5000));
+  for (int i = 0; i < 5000; ++i) {
+    checkpoints[0][i] = (char)(i * 7 % 251);
+  }
+  for (int i_check = 1; i_check < 4; ++i_check) {
+    checkpoints[i_check] = checkpoints[i_check - 1];
+    checkpoints[i_check][100 * i_check] ^= 1;
+    checkpoints[i_check][4000 + i_check] ^= 1;
+  }
+  checkpoints[2].resize(5100, 3);
+  CheckpointWriter writer;
+  writer.Init(true, 3);
+  std::vector<char> loaded;
+  SECTION("Deltas rebuild the full checkpoint they were made from") {
+    for (int i_check = 0; i_check < 3; ++i_check) {
+      std::vector<char> data = checkpoints[i_check];
+      writer.Submit(file_name, data);
+    }
+    writer.Flush();
+    std::ifstream ifull(file_name, std::ios::in | std::ios::binary);
+    std::vector<char> full((std::istreambuf_iterator<char>(ifull)),
+                           std::istreambuf_iterator<char>());
+    ifull.close();
+    std::ifstream idelta(delta_name, std::ios::in | std::ios::binary);
+    REQUIRE(idelta.is_open());
+    idelta.seekg(0, std::ios::end);
+    REQUIRE(idelta.tellg() < (std::streamoff)checkpoints[2].size() / 2);
+    idelta.close();
+    REQUIRE(full == checkpoints[0]);
+    REQUIRE(CheckpointWriter::Load(file_name, loaded));
+    REQUIRE(loaded == checkpoints[2]);
+  }
+  SECTION("A full checkpoint replaces the delta after the interval") {
+    for (int i_check = 0; i_check < 4; ++i_check) {
+      std::vector<char> data = checkpoints[i_check];
+      writer.Submit(file_name, data);
+    }
+    writer.Flush();
+    std::ifstream idelta(delta_name, std::ios::in | std::ios::binary);
+    REQUIRE(!idelta.is_open());
+    REQUIRE(CheckpointWriter::Load(file_name, loaded));
+    REQUIRE(loaded == checkpoints[3]);
+  }
+}
+
+TEST_CASE("Spec index") {
+  system_parameters params;
+  params.run_name = "test_spec_index";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 20;
+  params.n_steps = 200;
+  params.thermo_flag = 0;
+  params.filament.num = 4;
+  params.filament.length = 10;
+  params.filament.spec_flag = 1;
+  params.filament.n_spec = 10;
+  params.seed = 1;
+  std::vector<char> written, rebuilt;
+  std::vector<std::vector<double>> sequential, seeked;
+  Tester::RunSpecIndex(params, written, rebuilt, sequential, seeked);
+  SECTION("An index rebuilt while reading matches the one written") {
+    REQUIRE(written.size() > 0);
+    REQUIRE(rebuilt == written);
+  }
+  SECTION("Seeking to a frame reads the same frame as reading up to it") {
+    REQUIRE(sequential.size() == params.n_steps / params.filament.n_spec);
+    REQUIRE(seeked == sequential);
+    REQUIRE(sequential.front() != sequential.back());
+  }
+}
+
+TEST_CASE("Spec compression") {
+  std::string file_name = "test_spec_compression.spec";
+  /* Frames of slowly moving positions, with one frame of a different size
+     as when members are added */
+  std::vector<std::vector<double>> frames;
+  for (int i_frame = 0; i_frame < 5; ++i_frame) {
+    int n_values = (i_frame == 3 ? 150 : 120);
+    std::vector<double> frame(n_values);
+    for (int i = 0; i < n_values; ++i) {
+      frame[i] = 10 * sin(0.37 * i) + 0.01 * i_frame * cos(1.3 * i);
+    }
+    frames.push_back(frame);
+  }
+  std::vector<double> written;
+  for (auto it = frames.begin(); it != frames.end(); ++it) {
+    written.insert(written.end(), it->begin(), it->end());
+  }
+  SECTION("Lossless spec files read back exactly") {
+    Tester::WriteCompressedSpecs(file_name, frames, 0);
+    std::vector<double> read = Tester::ReadCompressedSpecs(file_name);
+    REQUIRE(read.size() == written.size());
+    REQUIRE(read == written);
+  }
+  SECTION("Quantized spec files read back within the tolerance") {
+    double tolerance = 1e-3;
+    Tester::WriteCompressedSpecs(file_name, frames, tolerance);
+    std::vector<double> read = Tester::ReadCompressedSpecs(file_name);
+    REQUIRE(read.size() == written.size());
+    bool quantized = false;
+    for (size_t i = 0; i < read.size(); ++i) {
+      REQUIRE(fabs(read[i] - written[i]) <= 0.5 * tolerance);
+      /* Values are rounded to the power of two below the tolerance */
+      double steps = ldexp(read[i], 10);
+      REQUIRE(steps == round(steps));
+      quantized = quantized || (read[i] != written[i]);
+    }
+    REQUIRE(quantized);
+  }
+  SECTION("Frames are delta encoded, and stored as is without zstd") {
+    Tester::WriteCompressedSpecs(file_name, frames, 0);
+    std::vector<int> codecs, deltas;
+    std::vector<bool> stored;
+    Tester::GetCompressedBlocks(file_name, codecs, deltas, stored);
+    REQUIRE(deltas == std::vector<int>({0, 1, 1, 0, 0}));
+    if (SpecCompression::HasZstd()) {
+      REQUIRE(codecs[1] == 1);
+    } else {
+      REQUIRE(codecs == std::vector<int>(5, 0));
+      REQUIRE(stored == std::vector<bool>(5, true));
+    }
+    REQUIRE(Tester::ReadCompressedSpecs(file_name) == written);
+  }
+}
+
+TEST_CASE("Parallel analysis") {
+  system_parameters params;
+  params.run_name = "test_parallel_analysis";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 20;
+  params.n_steps = 2000;
+  params.thermo_flag = 0;
+  params.seed = 1;
+  params.filament.num = 10;
+  params.filament.length = 20;
+  params.filament.n_bonds = 10;
+  params.filament.spec_flag = 1;
+  params.filament.n_spec = 1;
+  Tester::RunReplica(params);
+  params.filament.lp_analysis = 1;
+  params.filament.theta_analysis = 1;
+  params.parallel_analysis = 0;
+  std::string serial = Tester::RunSpecAnalysis(params);
+  SECTION("Batches of frames analyzed ahead match serial analysis") {
+    params.parallel_analysis = 1;
+    std::string parallel = Tester::RunSpecAnalysis(params);
+    REQUIRE(serial.size() > 0);
+    REQUIRE(parallel == serial);
+  }
+}
+
+TEST_CASE("In-situ analysis") {
+  system_parameters params;
+  params.run_name = "test_in_situ";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 20;
+  params.n_steps = 100;
+  params.thermo_flag = 0;
+  params.seed = 1;
+  params.filament.num = 4;
+  params.filament.length = 10;
+  params.filament.spec_flag = 1;
+  params.filament.n_spec = 10;
+  std::vector<double> with_specs = Tester::RunObjectIds(params);
+  SECTION("In-situ analysis leaves object ids and trajectories unchanged") {
+    params.in_situ_analysis = 1;
+    std::vector<double> in_situ = Tester::RunObjectIds(params);
+    REQUIRE(with_specs.size() > 2);
+    REQUIRE(in_situ == with_specs);
+  }
+}
+
+TEST_CASE("Crosslink event kinetics") {
+  system_parameters params;
+  params.run_name = "test_xlink_kinetics";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 20;
+  params.delta = 0.005;
+  params.thermo_flag = 0;
+  params.seed = 12345;
+  params.filament.num = 4;
+  params.filament.length = 10;
+  params.crosslink.concentration = 1;
+  params.crosslink.k_on = 2;
+  params.crosslink.k_off = 10;
+  params.crosslink.k_on_d = 0;
+  int n_updates = 5000;
+  int n_bind, n_unbind;
+  double bind_mean, unbind_mean;
+  SECTION("Per-step KMC binds and unbinds at the expected rates") {
+    params.crosslink.event_kinetics = 0;
+    Tester::RunCrosslinkKinetics(params, n_updates, n_bind, bind_mean,
+                                 n_unbind, unbind_mean);
+    REQUIRE(n_unbind > 0);
+    REQUIRE(fabs(n_bind - bind_mean) < 5 * sqrt(bind_mean));
+    REQUIRE(fabs(n_unbind - unbind_mean) < 5 * sqrt(unbind_mean));
+  }
+  SECTION("Event-driven kinetics binds and unbinds at the expected rates") {
+    params.crosslink.event_kinetics = 1;
+    Tester::RunCrosslinkKinetics(params, n_updates, n_bind, bind_mean,
+                                 n_unbind, unbind_mean);
+    REQUIRE(n_unbind > 0);
+    REQUIRE(fabs(n_bind - bind_mean) < 5 * sqrt(bind_mean));
+    REQUIRE(fabs(n_unbind - unbind_mean) < 5 * sqrt(unbind_mean));
+  }
+}
+
+TEST_CASE("Checkpoints from spec files") {
+  system_parameters params;
+  params.run_name = "test_xlink_from_spec";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 30;
+  params.n_steps = 1000;
+  params.delta = 0.0001;
+  params.thermo_flag = 0;
+  params.seed = 4321;
+  params.filament.num = 20;
+  params.filament.length = 20;
+  params.filament.n_bonds = 4;
+  params.filament.spec_flag = 1;
+  params.filament.n_spec = 200;
+  params.crosslink.concentration = 0.5;
+  params.crosslink.k_on = 10;
+  params.crosslink.k_on_d = 10;
+  params.crosslink.spec_flag = 1;
+  params.crosslink.n_spec = 200;
+  SECTION("Crosslinks reload onto their bonds from spec checkpoints") {
+    int n_run, n_reload;
+    Tester::RunCheckpointFromSpec(params, n_run, n_reload);
+    REQUIRE(n_run > 0);
+    REQUIRE(n_reload == n_run);
+  }
+}
+
+TEST_CASE("Domain decomposition") {
+  SECTION("Slab intervals overlap across the periodic boundary") {
+    REQUIRE(DomainDecomposition::Overlaps(-0.2, 0.1, 0.0, 0.3));
+    REQUIRE(DomainDecomposition::Overlaps(0.0, 0.3, -0.2, 0.1));
+    REQUIRE(DomainDecomposition::Overlaps(-0.1, 0.1, -0.3, 0.3));
+    REQUIRE(!DomainDecomposition::Overlaps(-0.4, -0.1, 0.1, 0.4));
+    REQUIRE(!DomainDecomposition::Overlaps(0.1, 0.4, -0.4, -0.1));
+    /* Intervals reaching past 0.5 wrap around to -0.5 */
+    REQUIRE(DomainDecomposition::Overlaps(0.4, 0.6, -0.5, -0.3));
+    REQUIRE(DomainDecomposition::Overlaps(-0.5, -0.3, 0.4, 0.6));
+    REQUIRE(DomainDecomposition::Overlaps(-0.6, -0.4, 0.3, 0.5));
+    REQUIRE(!DomainDecomposition::Overlaps(0.4, 0.6, -0.3, 0.3));
+    REQUIRE(!DomainDecomposition::Overlaps(-0.6, -0.45, 0.0, 0.35));
+    /* Intervals that together cover the period always overlap */
+    REQUIRE(DomainDecomposition::Overlaps(-0.5, 0.0, 0.0, 0.5));
+    REQUIRE(DomainDecomposition::Overlaps(-0.4, 0.2, 0.3, 0.8));
+  }
+  SECTION("Filaments are owned by the process of the slab of their center") {
+    system_parameters params;
+    params.run_name = "test_domains";
+    params.n_dim = 2;
+    params.n_periodic = 2;
+    params.system_radius = 20;
+    params.thermo_flag = 0;
+    params.seed = 1;
+    params.filament.num = 4;
+    params.filament.length = 10;
+    Tester::TestDomainOwnership(params);
+  }
+}
+
+TEST_CASE("Multiple time stepping") {
+  system_parameters params;
+  params.run_name = "test_respa";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 10;
+  params.thermo_flag = 1;
+  params.n_thermo = 12;
+  params.potential = "soft";
+  params.seed = 1;
+  params.filament.num = 10;
+  params.filament.length = 10;
+  std::vector<double> every_step = Tester::RunPairEnergies(params);
+  SECTION("Energies, stress and impulses match pair forces on every step") {
+    params.n_respa = 3;
+    std::vector<double> respa = Tester::RunPairEnergies(params);
+    REQUIRE(respa.size() == every_step.size());
+    for (int i = 0; i < params.n_thermo; ++i) {
+      REQUIRE(every_step[i] > 0);
+    }
+    for (size_t i = 0; i < respa.size(); ++i) {
+      REQUIRE(respa[i] == Approx(every_step[i]).margin(1e-9));
+    }
+  }
+}
+
+TEST_CASE("Adaptive time steps") {
+  system_parameters params;
+  params.run_name = "test_time_step";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 20;
+  params.n_steps = 100;
+  params.thermo_flag = 0;
+  params.seed = 1;
+  params.filament.num = 4;
+  params.filament.length = 10;
+  SECTION("Setting the time step matches starting with it") {
+    system_parameters params2 = params;
+    params2.delta = 2 * params.delta;
+    std::vector<double> fixed = Tester::RunReplica(params2);
+    std::vector<double> set = Tester::RunSetTimeStep(params, params2.delta);
+    REQUIRE(fixed.size() > 0);
+    REQUIRE(set == fixed);
+  }
+  SECTION("Outputs land on their cadence while the time step changes") {
+    params.adaptive_delta = 1;
+    params.delta = 0.01;
+    params.delta_min = 0.0001;
+    params.delta_max = 0.05;
+    params.filament.spec_flag = 1;
+    params.filament.n_spec = 10;
+    Tester::TestOutputCadence(params);
+  }
+}
+
+TEST_CASE("Pentadiagonal solver") {
+  /* A symmetric positive definite pentadiagonal matrix like the bending
+     matrices of filaments, with a known solution */
+  for (int n = 1; n <= 12; ++n) {
+    std::vector<double> d(n), e(n), f(n), x_true(n), b(n, 0);
+    for (int i = 0; i < n; ++i) {
+      d[i] = 6.5 + 0.1 * i;
+      e[i] = -4 + 0.05 * i;
+      f[i] = 1 - 0.02 * i;
+      x_true[i] = sin(1.3 * i) + 0.5;
+    }
+    for (int i = 0; i < n; ++i) {
+      b[i] += d[i] * x_true[i];
+      if (i + 1 < n) {
+        b[i] += e[i] * x_true[i + 1];
+        b[i + 1] += e[i] * x_true[i];
+      }
+      if (i + 2 < n) {
+        b[i] += f[i] * x_true[i + 2];
+        b[i + 2] += f[i] * x_true[i];
+      }
+    }
+    std::vector<double> fd = d, fe = e, ff = f, x = b;
+    pentadiagonal_factor(&fd, &fe, &ff, n);
+    pentadiagonal_solve(fd, fe, ff, &x, n);
+    double residual = 0;
+    for (int i = 0; i < n; ++i) {
+      double ax = d[i] * x[i];
+      if (i > 0)
+        ax += e[i - 1] * x[i - 1];
+      if (i > 1)
+        ax += f[i - 2] * x[i - 2];
+      if (i + 1 < n)
+        ax += e[i] * x[i + 1];
+      if (i + 2 < n)
+        ax += f[i] * x[i + 2];
+      residual = std::max(residual, fabs(ax - b[i]));
+      REQUIRE(x[i] == Approx(x_true[i]).epsilon(1e-10));
+    }
+    REQUIRE(residual < 1e-12);
+  }
+}
+
+TEST_CASE("Implicit bending") {
+  system_parameters params;
+  params.run_name = "test_implicit_bending";
+  params.n_dim = 2;
+  params.n_periodic = 2;
+  params.system_radius = 100;
+  params.thermo_flag = 0;
+  params.stoch_flag = 0;
+  params.interaction_flag = 0;
+  params.seed = 1;
+  params.filament.num = 4;
+  params.filament.length = 20;
+  SECTION("Implicit bending matches the explicit update at small steps") {
+    params.delta = 1e-4;
+    params.n_steps = 200;
+    params.filament.n_bonds = 10;
+    params.filament.persistence_length = 400;
+    std::vector<double> explicit_fil = Tester::RunBentFilaments(params, 0.5);
+    params.filament.implicit_bending = 1;
+    std::vector<double> implicit_fil = Tester::RunBentFilaments(params, 0.5);
+    REQUIRE(implicit_fil.size() == explicit_fil.size());
+    size_t n = explicit_fil.size();
+    REQUIRE(explicit_fil[n - 1] < explicit_fil[n - 2]);
+    for (size_t i = 0; i < n; ++i) {
+      REQUIRE(implicit_fil[i] == Approx(explicit_fil[i]).margin(1e-3));
+    }
+  }
+  SECTION("Stiff filaments relax where the explicit update is unstable") {
+    params.delta = 5e-5;
+    params.n_steps = 40;
+    params.filament.n_bonds = 40;
+    params.filament.persistence_length = 5000;
+    std::vector<double> explicit_fil = Tester::RunBentFilaments(params, 0.5);
+    params.filament.implicit_bending = 1;
+    std::vector<double> implicit_fil = Tester::RunBentFilaments(params, 0.5);
+    size_t n = explicit_fil.size();
+    REQUIRE(!(explicit_fil[n - 1] < explicit_fil[n - 2]));
+    REQUIRE(implicit_fil[n - 1] < implicit_fil[n - 2]);
+  }
+}
+
+TEST_CASE("Brownian motion kernel") {
+  system_parameters params;
+  params.run_name = "test_brownian";
+  params.system_radius = 10;
+  params.n_steps = 50;
+  params.thermo_flag = 0;
+  params.seed = 1;
+  params.br_bead.num = 40;
+  params.spherocylinder.num = 20;
+  params.spherocylinder.length = 3;
+  for (int n_dim = 2; n_dim <= 3; ++n_dim) {
+    params.n_dim = n_dim;
+    SECTION("Periodic " + std::to_string(n_dim) + "D beads and rods move "
+            "as when advanced one at a time") {
+      params.n_periodic = n_dim;
+      params.boundary = 0;
+      std::vector<double> members = Tester::RunFreeMotion(params, false);
+      std::vector<double> kernel = Tester::RunFreeMotion(params, true);
+      REQUIRE(members.size() == 60 * 3 * n_dim);
+      REQUIRE(kernel == members);
+    }
+    SECTION("Confined " + std::to_string(n_dim) + "D beads and rods move "
+            "as when advanced one at a time") {
+      params.n_periodic = 0;
+      params.boundary = 2;
+      std::vector<double> members = Tester::RunFreeMotion(params, false);
+      std::vector<double> kernel = Tester::RunFreeMotion(params, true);
+      REQUIRE(members.size() == 60 * 3 * n_dim);
+      REQUIRE(kernel == members);
+    }
+  }
+}